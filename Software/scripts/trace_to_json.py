@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""Convert a trace dump from the remote's serial log into a Chrome trace.
+
+Build the `trace` environment, send 't' over the monitor and save the log,
+then:
+
+    python3 scripts/trace_to_json.py monitor.log trace.json
+
+Open trace.json in https://ui.perfetto.dev or chrome://tracing. When the log
+holds several dumps, the last one is used.
+"""
+
+import json
+import sys
+
+BEGIN = "TRACE BEGIN"
+END = "TRACE END"
+
+
+def last_dump(lines):
+    dump = None
+    current = None
+    for line in lines:
+        if BEGIN in line:
+            current = []
+        elif END in line and current is not None:
+            dump = current
+            current = None
+        elif current is not None:
+            current.append(line)
+    if current is not None:
+        print("warning: last dump has no end marker, it may be cut short",
+              file=sys.stderr)
+        dump = current
+    return dump
+
+
+def parse_events(lines):
+    events = []
+    skipped = 0
+    for line in lines:
+        # Monitor filters such as `time` prefix each line; log output from
+        # other tasks can land between records.
+        start = line.find("{")
+        if start < 0:
+            continue
+        try:
+            events.append(json.loads(line[start:]))
+        except json.JSONDecodeError:
+            skipped += 1
+    if skipped:
+        print(f"warning: skipped {skipped} unreadable lines", file=sys.stderr)
+    return events
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(f"Usage: {sys.argv[0]} <monitor log> <output.json>",
+              file=sys.stderr)
+        return 1
+
+    with open(sys.argv[1], encoding="utf-8", errors="replace") as log:
+        dump = last_dump(log)
+    if dump is None:
+        print(f"error: no '{BEGIN}' found in {sys.argv[1]}", file=sys.stderr)
+        return 1
+
+    events = parse_events(dump)
+    with open(sys.argv[2], "w", encoding="utf-8") as out:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, out)
+    print(f"Wrote {len(events)} events to {sys.argv[2]}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -19,6 +19,8 @@
 #include "services/display.h"
 #include "services/encoder.h"
 #include "services/lastInteraction.h"
+#include "services/power.h"
+#include "utils/StaticRtos.h"
 
 class StateIcon {
   protected:
@@ -166,6 +168,7 @@ class BatteryStateIcon : public StateIcon {
   private:
     int lastBatteryPercent = -1;
     bool lastChargingState = false;
+    bool lastGaugeAvailable = false;
 
   public:
     BatteryStateIcon(int16_t x, int16_t y) : StateIcon(x, y) {}
@@ -177,19 +180,26 @@ class BatteryStateIcon : public StateIcon {
     }
 
     const unsigned char *getFrame() override {
-        updateBatteryStatus();
-
         bool currentCharging = isCharging();
         int currentPercent = getBatteryPercent();
+        bool gaugeAvailable = isBatteryGaugeAvailable();
 
         // Only update if battery state actually changed
         if (currentCharging == lastChargingState &&
-            currentPercent == lastBatteryPercent) {
+            currentPercent == lastBatteryPercent &&
+            gaugeAvailable == lastGaugeAvailable) {
             return lastFrame;  // Return cached frame to prevent redraw
         }
 
         lastChargingState = currentCharging;
         lastBatteryPercent = currentPercent;
+        lastGaugeAvailable = gaugeAvailable;
+
+        // No gauge: the level is unknown rather than empty.
+        if (!gaugeAvailable) {
+            color = Colors::lightGray;
+            return bitmap_battery_empty;
+        }
 
         if (currentCharging) {
             color = Colors::green;
@@ -306,7 +316,7 @@ static void setupAnimatedIcons() {
         while (true) {
             // If we're sleeping, don't draw anything in the status bar.
             if (idleState != IdleState::NOT_IDLE) {
-                vTaskDelay(1000 / portTICK_PERIOD_MS);
+                powerDelay(PowerLoop::Status);
                 continue;
             }
 
@@ -315,14 +325,12 @@ static void setupAnimatedIcons() {
             batteryIcon.draw(&tft);
             bleIcon.draw(&tft);
 
-            // Reduced frequency - check for updates every 250ms instead of
-            // 100ms
-            vTaskDelay(250 / portTICK_PERIOD_MS);
+            powerDelay(PowerLoop::Status);
         }
     };
 
-    xTaskCreatePinnedToCore(task, "draw_icons", 4 * configMINIMAL_STACK_SIZE,
-                            nullptr, tskIDLE_PRIORITY, nullptr, 0);
+    static StaticTask<4 * configMINIMAL_STACK_SIZE> drawIconsTask;
+    drawIconsTask.start(task, "draw_icons", nullptr, tskIDLE_PRIORITY, 0);
 }
 
 #endif  // LOCKBOX_ANIMATEDICONS_H
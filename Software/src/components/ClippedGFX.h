@@ -0,0 +1,115 @@
+#ifndef CLIPPEDGFX_H
+#define CLIPPEDGFX_H
+
+#include <Adafruit_GFX.h>
+
+#include "structs/Rect.h"
+
+// Draws onto `target`, dropping every pixel outside `clip`.
+//
+// Everything Adafruit_GFX draws ends in one of the primitives below, so text,
+// bitmaps and round rects are clipped too. Rects and lines are cut down
+// before they reach the target, which keeps its fast fills; only bitmaps go
+// pixel by pixel, as they already do through Adafruit_GFX. Wrappers nest, so
+// a group inside a group clips to both.
+class ClippedGFX : public Adafruit_GFX {
+  public:
+    ClippedGFX(Adafruit_GFX &target, const Rect &clip)
+        : Adafruit_GFX(target.width(), target.height()),
+          target(target),
+          clip(clip) {}
+
+    const Rect &getClip() const { return clip; }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (contains(x, y)) {
+            target.drawPixel(x, y, color);
+        }
+    }
+
+    void startWrite() override { target.startWrite(); }
+    void endWrite() override { target.endWrite(); }
+
+    void writePixel(int16_t x, int16_t y, uint16_t color) override {
+        if (contains(x, y)) {
+            target.writePixel(x, y, color);
+        }
+    }
+
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                       uint16_t color) override {
+        Rect area = clipped(x, y, w, h);
+        if (!area.isEmpty()) {
+            target.writeFillRect(area.x, area.y, area.width, area.height,
+                                 color);
+        }
+    }
+
+    void writeFastHLine(int16_t x, int16_t y, int16_t w,
+                        uint16_t color) override {
+        Rect area = clipped(x, y, w, 1);
+        if (!area.isEmpty()) {
+            target.writeFastHLine(area.x, area.y, area.width, color);
+        }
+    }
+
+    void writeFastVLine(int16_t x, int16_t y, int16_t h,
+                        uint16_t color) override {
+        Rect area = clipped(x, y, 1, h);
+        if (!area.isEmpty()) {
+            target.writeFastVLine(area.x, area.y, area.height, color);
+        }
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                  uint16_t color) override {
+        Rect area = clipped(x, y, w, h);
+        if (!area.isEmpty()) {
+            target.fillRect(area.x, area.y, area.width, area.height, color);
+        }
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w,
+                       uint16_t color) override {
+        Rect area = clipped(x, y, w, 1);
+        if (!area.isEmpty()) {
+            target.drawFastHLine(area.x, area.y, area.width, color);
+        }
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h,
+                       uint16_t color) override {
+        Rect area = clipped(x, y, 1, h);
+        if (!area.isEmpty()) {
+            target.drawFastVLine(area.x, area.y, area.height, color);
+        }
+    }
+
+    void fillScreen(uint16_t color) override {
+        fillRect(0, 0, width(), height(), color);
+    }
+
+  private:
+    Adafruit_GFX &target;
+    Rect clip;
+
+    bool contains(int16_t x, int16_t y) const {
+        return x >= clip.x && x < clip.right() && y >= clip.y &&
+               y < clip.bottom();
+    }
+
+    // Adafruit_GFX allows negative sizes, growing left or up.
+    Rect clipped(int16_t x, int16_t y, int16_t w, int16_t h) const {
+        if (w < 0) {
+            x += w + 1;
+            w = -w;
+        }
+        if (h < 0) {
+            y += h + 1;
+            h = -h;
+        }
+        return Rect{x, y, w, h}.intersect(clip);
+    }
+};
+
+#endif  // CLIPPEDGFX_H
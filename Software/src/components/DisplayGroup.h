@@ -0,0 +1,207 @@
+#ifndef DISPLAYGROUP_H
+#define DISPLAYGROUP_H
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ClippedGFX.h"
+#include "DisplayObject.h"
+#include "constants/Colors.h"
+#include "services/display.h"
+
+// Retained container for DisplayObjects.
+//
+// Children are kept sorted by zIndex and painted bottom to top. Groups nest;
+// a group's bounds are its clip rect. Each frame the group collects the
+// damage of every child that wants to redraw and repaints that area only:
+// the children are drawn through a ClippedGFX limited to the damage, so a
+// widget clearing its own box cannot wipe anything outside it. Areas a
+// child no longer covers (it was hidden, shrank or moved) are filled with
+// the background first. A child the damage painted over is repainted in
+// full, one that is merely near it is left alone. Children entirely outside
+// the clip rect are skipped.
+class DisplayGroup : public DisplayObject {
+  private:
+    using Children =
+        std::vector<std::unique_ptr<DisplayObject>,
+                    SessionAllocator<std::unique_ptr<DisplayObject>>>;
+    Children children;
+    uint16_t background;
+
+    // Areas left behind by hidden children that must be cleared.
+    Rect pendingDamage;
+
+  protected:
+    void onChildDamaged(const Rect &area) override {
+        pendingDamage = pendingDamage.unite(area.intersect(getBounds()));
+    }
+
+  public:
+    DisplayGroup(int16_t x, int16_t y, int16_t width, int16_t height,
+                 uint16_t background = Colors::black)
+        : DisplayObject(x, y, width, height), background(background) {}
+
+    // Creates a child in place and returns a non-owning pointer to it.
+    template <typename TDisplayObject, typename... TArgs>
+    TDisplayObject *add(TArgs &&...args) {
+        auto uniquePtr =
+            std::make_unique<TDisplayObject>(std::forward<TArgs>(args)...);
+        TDisplayObject *rawPtr = uniquePtr.get();
+        rawPtr->parent = this;
+
+        // Keep children ordered by zIndex; equal values keep insertion order.
+        auto position = std::upper_bound(
+            children.begin(), children.end(), rawPtr->zIndex,
+            [](int16_t z, const std::unique_ptr<DisplayObject> &child) {
+                return z < child->zIndex;
+            });
+        children.insert(position, std::move(uniquePtr));
+        return rawPtr;
+    }
+
+    // Re-sorts children after a zIndex change and repaints them.
+    void restack() {
+        std::stable_sort(children.begin(), children.end(),
+                         [](const std::unique_ptr<DisplayObject> &a,
+                            const std::unique_ptr<DisplayObject> &b) {
+                             return a->zIndex < b->zIndex;
+                         });
+        for (auto &child : children) {
+            child->invalidate();
+        }
+    }
+
+    void clear() {
+        children.clear();
+        pendingDamage = Rect{};
+    }
+
+    bool empty() const { return children.empty(); }
+    size_t size() const { return children.size(); }
+
+    Children::iterator begin() { return children.begin(); }
+    Children::iterator end() { return children.end(); }
+
+    // Clears what the children painted, box by box, instead of the whole
+    // page. They repaint in full on the next tick. False if the display was
+    // busy and nothing was cleared.
+    bool erase() {
+        if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) != pdTRUE) {
+            return false;
+        }
+        Adafruit_GFX &screen = gfx();
+        for (const Rect &area : paintedAreas()) {
+            screen.fillRect(area.x, area.y, area.width, area.height,
+                            background);
+        }
+        xSemaphoreGive(displayMutex);
+        pendingDamage = Rect{};
+        for (auto &child : children) {
+            child->paintedBounds = Rect{};
+            child->invalidate();
+        }
+        return true;
+    }
+
+    bool shouldDraw() override {
+        bool anyDirty = !pendingDamage.isEmpty();
+        for (auto &child : children) {
+            // Evaluate every child so change detection stays per-frame.
+            anyDirty |= child->needsRedraw() &&
+                        child->getDamage().intersects(getBounds());
+        }
+        return anyDirty;
+    }
+
+    // Only what the dirty children touch, so a parent repaints no more of
+    // its other children than that.
+    Rect getDamage() const override {
+        if (repaintAll()) {
+            return getBounds();
+        }
+        Rect damage = pendingDamage;
+        for (const auto &child : children) {
+            if (child->isVisible() && child->isDirty) {
+                damage = damage.unite(child->getDamage());
+            }
+        }
+        return damage.intersect(getBounds());
+    }
+
+    void draw() override {
+        Rect area = getDamage().intersect(getClip());
+        Rect cleared = pendingDamage;
+        for (const auto &child : children) {
+            // A child that shrank or moved uncovers what was beneath it
+            if (child->isVisible() && child->isDirty &&
+                !child->getBounds().contains(child->paintedBounds)) {
+                cleared = cleared.unite(child->paintedBounds);
+            }
+        }
+        cleared = cleared.intersect(area);
+        pendingDamage = Rect{};
+        if (area.isEmpty()) {
+            return;
+        }
+
+        ClippedGFX canvas(gfx(), area);
+        if (!cleared.isEmpty() &&
+            xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+            canvas.fillRect(cleared.x, cleared.y, cleared.width,
+                            cleared.height, background);
+            xSemaphoreGive(displayMutex);
+        }
+
+        // Painted so far this frame. A child on top of any of it has been
+        // painted over and is drawn whole; others only if they changed.
+        std::vector<Rect> painted;
+        painted.reserve(children.size() + 1);
+        painted.push_back(repaintAll() ? area : cleared);
+        for (auto &child : children) {
+            if (!child->isVisible()) {
+                continue;
+            }
+            Rect childArea = child->getDamage().intersect(area);
+            if (childArea.isEmpty()) {
+                continue;
+            }
+            if (overlapsAny(childArea, painted)) {
+                child->invalidate();
+            } else if (!child->isDirty) {
+                continue;
+            }
+            child->render(canvas, area);
+            painted.push_back(childArea);
+        }
+    }
+
+  private:
+    static bool overlapsAny(const Rect &area, const std::vector<Rect> &areas) {
+        for (const Rect &other : areas) {
+            if (area.intersects(other)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Boxes the visible children last painted, within the group.
+    std::vector<Rect> paintedAreas() const {
+        std::vector<Rect> areas;
+        areas.reserve(children.size() + 1);
+        if (!pendingDamage.isEmpty()) {
+            areas.push_back(pendingDamage);
+        }
+        for (const auto &child : children) {
+            Rect area = child->paintedBounds.intersect(getBounds());
+            if (!area.isEmpty()) {
+                areas.push_back(area);
+            }
+        }
+        return areas;
+    }
+};
+
+#endif  // DISPLAYGROUP_H
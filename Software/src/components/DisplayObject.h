@@ -3,19 +3,46 @@
 
 #include <Adafruit_GFX.h>
 
-class DisplayObject {
+#include "services/display.h"
+#include "services/sessionArena.h"
+#include "structs/Rect.h"
+
+// Widgets belong to the connected device, so they live in its session arena.
+class DisplayObject : public SessionAllocated {
   protected:
     int16_t x, y;
     int16_t width, height;
     bool isDirty = false;
     long lastDrawTime = 0;
 
+    // Owning container, if any. Set by DisplayGroup when the object is added.
+    DisplayObject *parent = nullptr;
+
+    // Called by a child whose painted area changed outside of its own
+    // redraw (e.g. it was hidden). Containers override this to track damage.
+    virtual void onChildDamaged(const Rect &) {}
+
+    // Where draw() paints. Inside a group this is the screen clipped to the
+    // area being repainted, so drawing outside it is harmless but wasted.
+    Adafruit_GFX &gfx() { return target != nullptr ? *target : screenGFX(); }
+
+    // The area draw() may change, in screen coordinates.
+    const Rect &getClip() const { return clip; }
+
+    // True when draw() must paint all of the object rather than what changed
+    // since the last frame: on the first draw, and after something else
+    // painted over it.
+    bool repaintAll() const { return isFirstDraw || isDamaged; }
+
   public:
     DisplayObject(int16_t x, int16_t y, int16_t width, int16_t height)
         : x(x), y(y), width(width), height(height) {}
 
     bool isFirstDraw = true;
 
+    // Paint order inside a DisplayGroup; higher values are drawn on top.
+    int16_t zIndex = 0;
+
     virtual ~DisplayObject() {}
 
     virtual bool shouldDraw() {
@@ -24,25 +51,85 @@ class DisplayObject {
     }
     virtual void draw() = 0;
 
-    void tick() {
+    // Area this object paints. Components whose painted area differs from
+    // their layout box (e.g. centred text) should override this.
+    virtual Rect getBounds() const { return Rect{x, y, width, height}; }
+
+    // Area the next redraw changes: where the object was last painted and
+    // where it paints now. Only meaningful while it is dirty.
+    virtual Rect getDamage() const { return paintedBounds.unite(getBounds()); }
+
+    // Evaluates change detection without drawing. Containers use this to
+    // collect damage before anything is painted.
+    bool needsRedraw() {
+        if (!visible) {
+            return false;
+        }
         isDirty |= shouldDraw();
         isDirty |= isFirstDraw;
+        return isDirty;
+    }
 
-        if (!isDirty) {
-            return;
-        }
+    // Draws unconditionally onto `canvas`, limited to `area`, and resets the
+    // dirty state.
+    void render(Adafruit_GFX &canvas, const Rect &area) {
+        target = &canvas;
+        clip = area;
         draw();
+        target = nullptr;
 
+        paintedBounds = getBounds();
         isFirstDraw = false;
         isDirty = false;
+        isDamaged = false;
         lastDrawTime = millis();  // Update lastDrawTime when we actually draw
     }
 
+    void tick() {
+        if (!needsRedraw()) {
+            return;
+        }
+        render(screenGFX(), getBounds());
+    }
+
+    // Forces a full repaint on the next tick.
+    void invalidate() {
+        isDirty = true;
+        isDamaged = true;
+    }
+
+    bool isVisible() const { return visible; }
+
+    void setVisible(bool value) {
+        if (visible == value) {
+            return;
+        }
+        visible = value;
+        if (visible) {
+            invalidate();
+        } else {
+            if (parent != nullptr) {
+                parent->onChildDamaged(paintedBounds);
+            }
+            paintedBounds = Rect{};
+        }
+    }
+
     // Getters
     int16_t getX() const { return x; }
     int16_t getY() const { return y; }
     int16_t getWidth() const { return width; }
     int16_t getHeight() const { return height; }
+
+  private:
+    bool visible = true;
+    bool isDamaged = false;
+    Adafruit_GFX *target = nullptr;
+    Rect clip;
+    // Where the last draw painted, empty until the first one.
+    Rect paintedBounds;
+
+    friend class DisplayGroup;
 };
 
-#endif
\ No newline at end of file
+#endif
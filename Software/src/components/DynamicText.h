@@ -3,25 +3,36 @@
 
 #include "DisplayObject.h"
 #include "constants/Colors.h"
+#include "constants/Sizes.h"
 #include "constants/Strings.h"
 #include "services/display.h"
+#include "services/hotlog.h"
+#include "services/text.h"
 
 class DynamicText : public DisplayObject {
   private:
-    static constexpr const char *TAG = "DynamicText";
     const std::string &text;
+    // The text as the next draw paints it, taken when a change is seen so
+    // damage and drawing agree even if `text` moves on in between.
+    std::string value;
     std::string lastValue = EMPTY_STRING;
     uint16_t currentTextColor;
     uint16_t lastTextColor;
 
-    // get text bounds
-    int16_t x1, y1;
-    uint16_t textWidth, textHeight;
+    // Bounds of `value` relative to the cursor; cached per string by the
+    // text service
+    TextMetrics valueMetrics;
+
+    int16_t drawX() const {
+        // x == -1 centres the text
+        return x == -1 ? (Display::WIDTH - valueMetrics.width) / 2 : x;
+    }
 
   public:
     DynamicText(const std::string &text, int16_t x, int16_t y, uint16_t color = Colors::textBackground)
-        : DisplayObject(x, y, text.length() * 8, 16), text(text), currentTextColor(color), lastTextColor(color) {
+        : DisplayObject(x, y, text.length() * 8, 16), text(text), value(text), currentTextColor(color), lastTextColor(color) {
         lastValue = text;
+        valueMetrics = measureText(TextFont::Sans9, value.c_str());
     }
 
     // Method to set the text color dynamically
@@ -29,55 +40,39 @@ class DynamicText : public DisplayObject {
         currentTextColor = color;
     }
 
-    bool shouldDraw() override { 
-        return isFirstDraw || text != lastValue || currentTextColor != lastTextColor; 
+    // The new text's box; getDamage() adds the old one, so a longer or
+    // re-centred line damages everything it clears.
+    Rect getBounds() const override {
+        return Rect{static_cast<int16_t>(drawX() + valueMetrics.x1),
+                    static_cast<int16_t>(y + valueMetrics.y1),
+                    static_cast<int16_t>(valueMetrics.width),
+                    static_cast<int16_t>(valueMetrics.height)};
+    }
+
+    bool shouldDraw() override {
+        if (text != value) {
+            value = text;
+            valueMetrics = measureText(TextFont::Sans9, value.c_str());
+        }
+        return isFirstDraw || value != lastValue || currentTextColor != lastTextColor;
     }
 
     void draw() override {
-        ESP_LOGI(TAG, "Drawing DynamicText: %s", text.c_str());
+        HOT_LOGI(DYNAMIC_TEXT, "Drawing DynamicText: %s", value);
         if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-            tft.setFont(&FreeSans9pt7b);
-            tft.setTextColor(currentTextColor);
+            // Clear where the old text was and where the new one goes. In a
+            // group, the group repaints what the old text uncovers.
+            Rect clear = parent != nullptr ? getBounds() : getDamage();
+            gfx().fillRect(clear.x, clear.y, clear.width, clear.height, Colors::black);
 
-            // Get bounds for both old and new text to calculate actual drawing positions
-            int16_t oldX1, oldY1, newX1, newY1;
-            uint16_t oldWidth, oldHeight, newWidth, newHeight;
-
-            // Calculate actual drawing positions for both texts
-            int oldDrawX, newDrawX;
-            if (x == -1) {
-                // Centered positioning
-                tft.getTextBounds(lastValue.c_str(), 0, y, &oldX1, &oldY1, &oldWidth, &oldHeight);
-                tft.getTextBounds(text.c_str(), 0, y, &newX1, &newY1, &newWidth, &newHeight);
-                oldDrawX = (Display::WIDTH - oldWidth) / 2;
-                newDrawX = (Display::WIDTH - newWidth) / 2;
-            } else {
-                // Fixed positioning
-                tft.getTextBounds(lastValue.c_str(), x, y, &oldX1, &oldY1, &oldWidth, &oldHeight);
-                tft.getTextBounds(text.c_str(), x, y, &newX1, &newY1, &newWidth, &newHeight);
-                oldDrawX = x;
-                newDrawX = x;
-            }
-
-            // Calculate combined clearing area using actual drawing positions
-            int16_t clearX = min(oldDrawX + oldX1, newDrawX + newX1);
-            int16_t clearY = min(oldY1, newY1);
-            uint16_t clearWidth = max(oldDrawX + oldX1 + oldWidth, newDrawX + newX1 + newWidth) - clearX;
-            uint16_t clearHeight = max(oldY1 + oldHeight, newY1 + newHeight) - clearY;
-
-            // Clear the combined area
-            tft.fillRect(clearX, clearY, clearWidth, clearHeight, Colors::black);
-
-            // Draw the new text at the calculated position
-            tft.setCursor(newDrawX, y);
-            tft.print(text.c_str());
+            drawText(TextFont::Sans9, value.c_str(), drawX(), y, currentTextColor, Colors::black, gfx());
 
             xSemaphoreGive(displayMutex);
         }
 
-        lastValue = text;
+        lastValue = value;
         lastTextColor = currentTextColor;
     };
 };
 
-#endif  // DYNAMICTEXT_H
\ No newline at end of file
+#endif  // DYNAMICTEXT_H
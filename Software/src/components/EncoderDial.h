@@ -10,13 +10,11 @@
 #include "DisplayObject.h"
 #include "esp_log.h"
 #include "pins.h"
-#include "services/buzzer.h"
 #include "services/display.h"
+#include "services/feedback.h"
 #include "services/leds.h"
-#include "services/vibrator.h"
-// Adafruit GFX fonts
-#include <AiEsp32RotaryEncoder.h>
-#include <Fonts/FreeSansBold9pt7b.h>  // Reduced from 12pt to 9pt for better fit
+#include "services/text.h"
+#include "services/encoder.h"
 #include <vector>
 
 class EncoderDial : public DisplayObject {
@@ -30,8 +28,6 @@ class EncoderDial : public DisplayObject {
     int *focusedIndex = nullptr;
     std::map<String, int> lastParameterValues;
     int lastFocusedIndex = -1;
-    bool isFirstDraw =
-        true;  // Track if this is the first draw to avoid unnecessary clearing
 
     // LED mapping settings
     bool mapToLeftLed = false;
@@ -49,19 +45,19 @@ class EncoderDial : public DisplayObject {
             int x = centerX + arcRadius * cos(angle + 3 * PI / 4);
             int y = centerY + arcRadius * sin(angle + 3 * PI / 4);
             if (i < fillSteps || i == 0) {
-                tft.fillCircle(x, y, circleRadius,
+                gfx().fillCircle(x, y, circleRadius,
                                isFocused ? activeColor : ST77XX_WHITE);
             } else {
-                tft.fillCircle(x, y, circleRadius, 0x7BEF);  // Dark gray color
+                gfx().fillCircle(x, y, circleRadius, 0x7BEF);  // Dark gray color
             }
         }
     }
 
-    AiEsp32RotaryEncoder &encoder;
+    RotaryEncoder &encoder;
 
   public:
     struct Props {
-        AiEsp32RotaryEncoder *encoder = nullptr;
+        RotaryEncoder *encoder = nullptr;
         std::map<String, float *> parameters;
         int *focusedIndex = nullptr;
         int16_t x = -1;
@@ -151,10 +147,10 @@ class EncoderDial : public DisplayObject {
 
     void draw() override {
         if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-            // Only clear entire area on first draw or focus change
-            if (isFirstDraw || lastFocusedIndex != *focusedIndex) {
-                tft.fillRect(x, y, width, height, ST77XX_BLACK);
-                isFirstDraw = false;
+            // Only clear entire area on a full repaint or focus change
+            bool repaint = repaintAll() || lastFocusedIndex != *focusedIndex;
+            if (repaint) {
+                gfx().fillRect(x, y, width, height, ST77XX_BLACK);
             } else {
                 // For parameter value updates, we'll redraw over existing arcs
                 // This reduces flicker significantly
@@ -200,8 +196,7 @@ class EncoderDial : public DisplayObject {
                     isFocused = true;
                 }
 
-                if (valueChanged || isFocused || isFirstDraw ||
-                    lastFocusedIndex != *focusedIndex) {
+                if (valueChanged || isFocused || repaint) {
                     drawArcDirect(currentRadius, centerX, centerY, fillSteps,
                                   steps, circleRadius, isFocused, arcColor);
                 }
@@ -214,7 +209,7 @@ class EncoderDial : public DisplayObject {
 
             // Draw focused parameter label and value with maximum width
             // clearing
-            tft.setTextColor(ST77XX_WHITE);
+            gfx().setTextColor(ST77XX_WHITE);
 
             // Find the focused parameter
             auto it = parameters.begin();
@@ -230,55 +225,53 @@ class EncoderDial : public DisplayObject {
                 String percentStr = String(displayValue);
 
                 // Measure label text bounds with classic font
-                tft.setFont(NULL);
+                gfx().setFont(NULL);
                 int16_t x1, y1;
                 uint16_t w, h;
-                tft.getTextBounds(label.c_str(), 0, 0, &x1, &y1, &w, &h);
+                gfx().getTextBounds(label.c_str(), 0, 0, &x1, &y1, &w, &h);
                 int16_t labelCursorX = centerX - (x1 + (int16_t)(w / 2));
                 int16_t labelBaselineY =
                     y + height - 10;  // slight margin from bottom
 
                 // Clear only the exact label area (with small padding)
-                tft.fillRect(labelCursorX + x1 - 2, labelBaselineY + y1 - 1,
+                gfx().fillRect(labelCursorX + x1 - 2, labelBaselineY + y1 - 1,
                              w + 4, h + 2, ST77XX_BLACK);
 
                 // Draw parameter name
-                tft.setCursor(labelCursorX, labelBaselineY);
-                tft.print(label);
+                gfx().setCursor(labelCursorX, labelBaselineY);
+                gfx().print(label);
 
                 // Calculate maximum possible text width to prevent artifacts
-                tft.setFont(&FreeSansBold9pt7b);  // Use smaller 9pt font
-
-                // Get bounds for maximum possible value to determine clearing
-                // area
+                // (9pt bold, measured through the text service's run cache)
                 String maxValueStr = String(maxValue);
-                int16_t maxX1, maxY1;
-                uint16_t maxW, maxH;
-                tft.getTextBounds(maxValueStr.c_str(), 0, 0, &maxX1, &maxY1,
-                                  &maxW, &maxH);
+                TextMetrics maxBounds =
+                    measureText(TextFont::SansBold9, maxValueStr.c_str());
 
                 // Center the clearing area based on maximum width
                 int16_t maxValueCursorX =
-                    centerX - (maxX1 + (int16_t)(maxW / 2));
+                    centerX - (maxBounds.x1 + (int16_t)(maxBounds.width / 2));
                 int16_t valueBaselineY =
-                    centerY - (maxY1 + (int16_t)(maxH / 2));
+                    centerY - (maxBounds.y1 + (int16_t)(maxBounds.height / 2));
 
                 // Clear area large enough for maximum possible text width (with
                 // padding)
-                tft.fillRect(maxValueCursorX + maxX1 - 3,
-                             valueBaselineY + maxY1 - 2, maxW + 6, maxH + 4,
+                gfx().fillRect(maxValueCursorX + maxBounds.x1 - 3,
+                             valueBaselineY + maxBounds.y1 - 2,
+                             maxBounds.width + 6, maxBounds.height + 4,
                              ST77XX_BLACK);
 
                 // Now get actual text positioning for current value
-                tft.getTextBounds(percentStr.c_str(), 0, 0, &x1, &y1, &w, &h);
-                int16_t valueCursorX = centerX - (x1 + (int16_t)(w / 2));
+                TextMetrics valueBounds =
+                    measureText(TextFont::SansBold9, percentStr.c_str());
+                int16_t valueCursorX =
+                    centerX - (valueBounds.x1 + (int16_t)(valueBounds.width / 2));
 
                 // Draw value at proper centered position
-                tft.setCursor(valueCursorX, valueBaselineY);
-                tft.print(percentStr);
+                drawText(TextFont::SansBold9, percentStr.c_str(), valueCursorX,
+                         valueBaselineY, ST77XX_WHITE, ST77XX_BLACK, gfx());
 
                 // Restore default font
-                tft.setFont(NULL);
+                gfx().setFont(NULL);
             }
 
             xSemaphoreGive(displayMutex);
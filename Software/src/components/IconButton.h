@@ -6,6 +6,7 @@
 #include <Adafruit_MCP23X17.h>
 #include <Adafruit_ST77xx.h>
 #include "services/display.h"
+#include "services/input.h"
 #include "Icons.h"
 
 class IconButton : public DisplayObject
@@ -25,37 +26,37 @@ public:
 
     bool shouldDraw() override
     {
-        bool currentState = digitalRead(buttonPin) == LOW;
+        bool currentState = isInputPressed(buttonPin);
         return currentState != lastButtonState;
     }
 
     void draw() override
     {
-        bool currentState = digitalRead(buttonPin) == LOW;
+        bool currentState = isInputPressed(buttonPin);
         
         if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE)
         {
             // Clear button area
-            tft.fillRect(x, y, width, height, ST77XX_BLACK);
+            gfx().fillRect(x, y, width, height, ST77XX_BLACK);
 
             uint16_t fgColor;
 
             // Draw button background
             if (!currentState)
             {
-                tft.drawRoundRect(x, y, width, height, 5, 0x7BEF); // Dark grey color
+                gfx().drawRoundRect(x, y, width, height, 5, 0x7BEF); // Dark grey color
                 fgColor = 0x7BEF;
             }
             else
             {
-                tft.fillRoundRect(x, y, width, height, 5, ST77XX_WHITE);
+                gfx().fillRoundRect(x, y, width, height, 5, ST77XX_WHITE);
                 fgColor = ST77XX_BLACK;
             }
 
             // Center and draw the 24x24 icon
             int16_t iconX = x + (width - ICON_SIZE) / 2;
             int16_t iconY = y + (height - ICON_SIZE) / 2;
-            tft.drawBitmap(iconX, iconY, iconBitmap, ICON_SIZE, ICON_SIZE, fgColor);
+            gfx().drawBitmap(iconX, iconY, iconBitmap, ICON_SIZE, ICON_SIZE, fgColor);
             
             xSemaphoreGive(displayMutex);
         }
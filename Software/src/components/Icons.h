@@ -4,7 +4,7 @@
 #include <Arduino.h>
 
 // 'link', 24x24px
-static const unsigned char bitmap_link[] PROGMEM = {
+inline constexpr unsigned char bitmap_link[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xe0, 0x00, 0x0f, 0xf8,
     0x00, 0x1c, 0x38, 0x00, 0x38, 0x1c, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x0c,
     0x00, 0x03, 0x0c, 0x00, 0x07, 0x1c, 0x04, 0x0e, 0x1c, 0x0e, 0x1c, 0x38,
@@ -12,7 +12,7 @@ static const unsigned char bitmap_link[] PROGMEM = {
     0x30, 0x00, 0x00, 0x30, 0x00, 0x00, 0x38, 0x1c, 0x00, 0x1c, 0x38, 0x00,
     0x1f, 0xf0, 0x00, 0x07, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'link-broken', 24x24px
-static const unsigned char bitmap_link_broken[] PROGMEM = {
+inline constexpr unsigned char bitmap_link_broken[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0xc0, 0x00, 0x00, 0xc1, 0xe0, 0x18, 0xc7, 0xf8,
     0x1c, 0xcf, 0x38, 0x0c, 0x1e, 0x1c, 0x00, 0x1c, 0x0c, 0x00, 0x00, 0x0c,
     0x78, 0x03, 0x1c, 0x78, 0x07, 0x38, 0x00, 0x0e, 0x78, 0x06, 0x1c, 0x70,
@@ -20,7 +20,7 @@ static const unsigned char bitmap_link_broken[] PROGMEM = {
     0x30, 0x00, 0x00, 0x30, 0x38, 0x00, 0x38, 0x78, 0x30, 0x1c, 0xf3, 0x38,
     0x1f, 0xe3, 0x18, 0x07, 0x83, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00};
 // 'blue-on', 24x24px
-static const unsigned char bitmap_ble_on[] PROGMEM = {
+inline constexpr unsigned char bitmap_ble_on[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x1f, 0x00,
     0x00, 0x1f, 0x80, 0x00, 0x1b, 0xc0, 0x06, 0x18, 0xe0, 0x07, 0x18, 0xe0,
     0x03, 0xdb, 0xc0, 0x01, 0xff, 0x80, 0x00, 0xff, 0x00, 0x00, 0x3c, 0x00,
@@ -28,7 +28,7 @@ static const unsigned char bitmap_ble_on[] PROGMEM = {
     0x07, 0x18, 0xe0, 0x06, 0x18, 0xe0, 0x00, 0x1b, 0xc0, 0x00, 0x1f, 0x80,
     0x00, 0x1f, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00};
 // 'ble-signal', 24x24px
-static const unsigned char bitmap_ble_signal[] PROGMEM = {
+inline constexpr unsigned char bitmap_ble_signal[] PROGMEM = {
     0x00, 0x00, 0x00, 0x01, 0x80, 0x00, 0x01, 0xc0, 0x00, 0x01, 0xf0, 0x00,
     0x01, 0xf8, 0x00, 0x01, 0xbc, 0x08, 0x61, 0x8e, 0x18, 0x71, 0x8e, 0x1c,
     0x3d, 0xbc, 0xcc, 0x1f, 0xf8, 0xce, 0x0f, 0xf0, 0x66, 0x03, 0xc0, 0x66,
@@ -36,7 +36,7 @@ static const unsigned char bitmap_ble_signal[] PROGMEM = {
     0x71, 0x8e, 0x1c, 0x61, 0x8e, 0x1c, 0x01, 0xbc, 0x00, 0x01, 0xf8, 0x00,
     0x01, 0xf0, 0x00, 0x01, 0xc0, 0x00, 0x01, 0x80, 0x00, 0x00, 0x00, 0x00};
 // 'ble-connect', 24x24px
-static const unsigned char bitmap_ble_connect[] PROGMEM = {
+inline constexpr unsigned char bitmap_ble_connect[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0xc0, 0x00, 0x00, 0xe0, 0x00, 0x00, 0xf8, 0x00,
     0x00, 0xfc, 0x00, 0x00, 0xde, 0x00, 0x30, 0xc7, 0x00, 0x38, 0xc7, 0x00,
     0x1e, 0xde, 0x00, 0x0f, 0xfc, 0x00, 0x07, 0xf8, 0x00, 0x01, 0xe3, 0x6c,
@@ -44,7 +44,7 @@ static const unsigned char bitmap_ble_connect[] PROGMEM = {
     0x38, 0xc7, 0x00, 0x30, 0xc7, 0x00, 0x00, 0xde, 0x00, 0x00, 0xfc, 0x00,
     0x00, 0xf8, 0x00, 0x00, 0xe0, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00};
 // 'switch', 24x24px
-static const unsigned char bitmap_switch[] PROGMEM = {
+inline constexpr unsigned char bitmap_switch[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0xc0,
     0x07, 0x80, 0xc0, 0x0f, 0xc0, 0xc0, 0x1f, 0xe0, 0xc0, 0x3b, 0x70, 0xc0,
     0x33, 0x30, 0xc0, 0x03, 0x00, 0xc0, 0x03, 0x00, 0xc0, 0x03, 0x00, 0xc0,
@@ -52,7 +52,7 @@ static const unsigned char bitmap_switch[] PROGMEM = {
     0x03, 0x0e, 0xdc, 0x03, 0x07, 0xf8, 0x03, 0x03, 0xf0, 0x03, 0x01, 0xe0,
     0x03, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'ble-off', 24x24px
-static const unsigned char bitmap_ble_off[] PROGMEM = {
+inline constexpr unsigned char bitmap_ble_off[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x30, 0x1c, 0x00, 0x38, 0x1f, 0x00,
     0x1c, 0x1f, 0x80, 0x0e, 0x1b, 0xc0, 0x07, 0x18, 0xe0, 0x03, 0x98, 0xe0,
     0x01, 0xc3, 0xc0, 0x00, 0xe3, 0x80, 0x00, 0x70, 0x00, 0x00, 0x38, 0x00,
@@ -60,7 +60,7 @@ static const unsigned char bitmap_ble_off[] PROGMEM = {
     0x07, 0x19, 0xc0, 0x06, 0x18, 0xe0, 0x00, 0x1b, 0xf0, 0x00, 0x1f, 0xb8,
     0x00, 0x1f, 0x1c, 0x00, 0x1c, 0x0c, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00};
 // 'wifi-off', 24x24px
-static const unsigned char bitmap_wifi_off[] PROGMEM = {
+inline constexpr unsigned char bitmap_wifi_off[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x38, 0x38, 0x00,
     0x1c, 0x7f, 0xc0, 0x0e, 0x7f, 0xf0, 0x1f, 0x00, 0xfc, 0x7b, 0x80, 0x1e,
     0xf1, 0xc0, 0x0f, 0xc1, 0xe3, 0x80, 0x07, 0xf1, 0xe0, 0x0f, 0x39, 0xf0,
@@ -68,7 +68,7 @@ static const unsigned char bitmap_wifi_off[] PROGMEM = {
     0x00, 0x83, 0xc0, 0x00, 0x00, 0xe0, 0x00, 0x08, 0x70, 0x00, 0x18, 0x38,
     0x00, 0x10, 0x1c, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'wifi', 24x24px
-static const unsigned char bitmap_wifi[] PROGMEM = {
+inline constexpr unsigned char bitmap_wifi[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00,
     0x01, 0xff, 0xc0, 0x0f, 0xff, 0xf0, 0x3e, 0x00, 0xfc, 0x78, 0x00, 0x1e,
     0xe0, 0x08, 0x0f, 0xc1, 0xff, 0x82, 0x03, 0xff, 0xe0, 0x0f, 0x00, 0xf0,
@@ -76,7 +76,7 @@ static const unsigned char bitmap_wifi[] PROGMEM = {
     0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x18, 0x00,
     0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'battery-full', 24x24px
-static const unsigned char bitmap_battery_full[] PROGMEM = {
+inline constexpr unsigned char bitmap_battery_full[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x1f, 0xff, 0xc0, 0x3f, 0xff, 0xe0, 0x70, 0x00, 0x70,
     0x60, 0x00, 0x30, 0x62, 0x22, 0x30, 0x67, 0x77, 0x36, 0x67, 0x77, 0x36,
@@ -85,7 +85,7 @@ static const unsigned char bitmap_battery_full[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 // 'battery-empty', 24x24px
-const unsigned char bitmap_battery_empty[] PROGMEM = {
+inline constexpr unsigned char bitmap_battery_empty[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x1f, 0xff, 0xc0, 0x3f, 0xff, 0xe0, 0x70, 0x00, 0x70,
     0x60, 0x00, 0x30, 0x60, 0x00, 0x30, 0x60, 0x00, 0x36, 0x60, 0x00, 0x36,
@@ -94,7 +94,7 @@ const unsigned char bitmap_battery_empty[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 // 'battery-low', 24x24px
-static const unsigned char bitmap_battery_low[] PROGMEM = {
+inline constexpr unsigned char bitmap_battery_low[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x1f, 0xff, 0xc0, 0x3f, 0xff, 0xe0, 0x70, 0x00, 0x70,
     0x60, 0x00, 0x30, 0x62, 0x00, 0x30, 0x67, 0x00, 0x36, 0x67, 0x00, 0x36,
@@ -102,7 +102,7 @@ static const unsigned char bitmap_battery_low[] PROGMEM = {
     0x70, 0x00, 0x70, 0x3f, 0xff, 0xe0, 0x1f, 0xff, 0xc0, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'battery-mid', 24x24px
-static const unsigned char bitmap_battery_mid[] PROGMEM = {
+inline constexpr unsigned char bitmap_battery_mid[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x1f, 0xff, 0xc0, 0x3f, 0xff, 0xe0, 0x70, 0x00, 0x70,
     0x60, 0x00, 0x30, 0x62, 0x20, 0x30, 0x67, 0x70, 0x36, 0x67, 0x70, 0x36,
@@ -110,7 +110,7 @@ static const unsigned char bitmap_battery_mid[] PROGMEM = {
     0x70, 0x00, 0x70, 0x3f, 0xff, 0xe0, 0x1f, 0xff, 0xc0, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'battery_charging', 24x24px
-const unsigned char bitmap_battery_charging[] PROGMEM = {
+inline constexpr unsigned char bitmap_battery_charging[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x1f, 0x33, 0xc0, 0x3f, 0x33, 0xe0, 0x70, 0x70, 0x70,
     0x60, 0xe0, 0x30, 0x60, 0xe0, 0x30, 0x61, 0xc0, 0x36, 0x61, 0xfc, 0x36,
@@ -119,7 +119,7 @@ const unsigned char bitmap_battery_charging[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 // 'update', 24x24px
-const unsigned char bitmap_update[] PROGMEM = {
+inline constexpr unsigned char bitmap_update[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 0x00, 0xff, 0x00,
     0x01, 0xc7, 0xc0, 0x03, 0x81, 0xc0, 0x07, 0x00, 0xc0, 0x07, 0x00, 0x70,
     0x1e, 0x00, 0x78, 0x38, 0x00, 0x3c, 0x70, 0x00, 0x0e, 0x60, 0x18, 0x06,
@@ -127,7 +127,7 @@ const unsigned char bitmap_update[] PROGMEM = {
     0x19, 0x99, 0x98, 0x01, 0xdb, 0x80, 0x00, 0xff, 0x00, 0x00, 0x7e, 0x00,
     0x00, 0x3c, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'sleep', 24x24px
-const unsigned char bitmap_sleep[] PROGMEM = {
+inline constexpr unsigned char bitmap_sleep[] PROGMEM = {
     0x00, 0x00, 0x00, 0x01, 0x80, 0x00, 0x03, 0x80, 0x00, 0x0f, 0x80, 0x00,
     0x1f, 0x80, 0x00, 0x1f, 0x00, 0x00, 0x3b, 0x00, 0x00, 0x33, 0x80, 0x00,
     0x71, 0x80, 0x00, 0x71, 0x80, 0x00, 0x61, 0x80, 0x00, 0x61, 0xc0, 0x00,
@@ -136,7 +136,7 @@ const unsigned char bitmap_sleep[] PROGMEM = {
     0x07, 0xe1, 0xf0, 0x01, 0xff, 0xc0, 0x00, 0x7e, 0x00, 0x00, 0x00, 0x00};
 
 // 'coffee', 24x24px
-const unsigned char bitmap_coffee[] PROGMEM = {
+inline constexpr unsigned char bitmap_coffee[] PROGMEM = {
     0x00, 0x00, 0x00, 0x06, 0x66, 0x00, 0x06, 0x66, 0x00, 0x06, 0x66, 0x00,
     0x06, 0x66, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0xff, 0xf8,
     0x3f, 0xff, 0xfc, 0x30, 0x00, 0xdc, 0x30, 0x00, 0xce, 0x30, 0x00, 0xc6,
@@ -145,7 +145,7 @@ const unsigned char bitmap_coffee[] PROGMEM = {
     0x1f, 0xff, 0x80, 0x0f, 0xfe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 // 'settings', 24x24px
-const unsigned char bitmap_settings[] PROGMEM = {
+inline constexpr unsigned char bitmap_settings[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x7e, 0x00, 0x00, 0xee, 0x00,
     0x00, 0xe7, 0x00, 0x1f, 0xc3, 0xf8, 0x3f, 0x81, 0xf8, 0x30, 0x00, 0x1c,
     0x30, 0x3c, 0x1c, 0x38, 0x7e, 0x1c, 0x18, 0xe7, 0x38, 0x0c, 0xc3, 0x38,
@@ -153,7 +153,7 @@ const unsigned char bitmap_settings[] PROGMEM = {
     0x30, 0x00, 0x1c, 0x3f, 0x81, 0xfc, 0x1f, 0xc3, 0xf8, 0x00, 0xc7, 0x00,
     0x00, 0x66, 0x00, 0x00, 0x7e, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x00};
 // 'restart', 24x24px
-const unsigned char bitmap_restart[] PROGMEM = {
+inline constexpr unsigned char bitmap_restart[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7f, 0x00, 0x01, 0xff, 0x86,
     0x07, 0xc3, 0xe6, 0x0f, 0x00, 0xf6, 0x1e, 0x00, 0x7e, 0x1c, 0x00, 0x1e,
     0x38, 0x00, 0x1e, 0x38, 0x01, 0xfe, 0x30, 0x01, 0xfe, 0x00, 0x00, 0x00,
@@ -161,7 +161,7 @@ const unsigned char bitmap_restart[] PROGMEM = {
     0x78, 0x00, 0x38, 0x7e, 0x00, 0x78, 0x6f, 0x00, 0xf0, 0x67, 0xc3, 0xe0,
     0x61, 0xff, 0x80, 0x00, 0xfe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'unlocked', 24x24px
-const unsigned char bitmap_unlocked[] PROGMEM = {
+inline constexpr unsigned char bitmap_unlocked[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7e, 0x00, 0x00, 0xff, 0x00,
     0x01, 0xc3, 0x00, 0x01, 0x81, 0x00, 0x01, 0x80, 0x00, 0x01, 0x80, 0x00,
     0x01, 0x80, 0x00, 0x07, 0xff, 0xe0, 0x0f, 0xff, 0xf0, 0x1c, 0x00, 0x38,
@@ -171,7 +171,7 @@ const unsigned char bitmap_unlocked[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on
 // https://www.researchanddesire.com/dev/svg2cpp 'Asterisk01', 24x24px
-const unsigned char researchAndDesireAsterisk01[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireAsterisk01[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x18, 0x00, 0x00, 0x18, 0x00,
     0x0c, 0x18, 0x30, 0x0e, 0x18, 0x70, 0x07, 0x18, 0xe0, 0x03, 0x99, 0xc0,
     0x01, 0xdb, 0x80, 0x00, 0xff, 0x00, 0x00, 0x7e, 0x00, 0x7f, 0xff, 0xfe,
@@ -181,7 +181,7 @@ const unsigned char researchAndDesireAsterisk01[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'Waves', 24x24px
-const unsigned char researchAndDesireWaves[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireWaves[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xf0, 0x7c, 0x77,
     0xfd, 0xfe, 0x7f, 0xbf, 0xee, 0x3e, 0x0f, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xf0,
     0x7c, 0x77, 0xfd, 0xfe, 0x7f, 0xbf, 0xee, 0x3e, 0x0f, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -189,7 +189,7 @@ const unsigned char researchAndDesireWaves[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 // 'clock', 24x24px
-const unsigned char bitmap_clock[] PROGMEM = {
+inline constexpr unsigned char bitmap_clock[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x30, 0x1c, 0x00, 0x38,
     0x38, 0x7f, 0x1c, 0x71, 0xff, 0x8e, 0x63, 0xc3, 0xc6, 0x07, 0x00, 0xe0,
     0x0e, 0x18, 0x70, 0x1c, 0x18, 0x30, 0x1c, 0x18, 0x38, 0x18, 0x18, 0x18,
@@ -197,7 +197,7 @@ const unsigned char bitmap_clock[] PROGMEM = {
     0x0c, 0x00, 0x38, 0x0e, 0x00, 0x70, 0x07, 0x00, 0xe0, 0x0f, 0xc3, 0xf0,
     0x1d, 0xff, 0xb8, 0x18, 0xfe, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'locked', 24x24px
-const unsigned char bitmap_locked[] PROGMEM = {
+inline constexpr unsigned char bitmap_locked[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x00,
     0x00, 0xff, 0x00, 0x00, 0xe7, 0x00, 0x01, 0xc3, 0x80, 0x01, 0x81, 0x80,
     0x01, 0x81, 0x80, 0x07, 0xff, 0xe0, 0x0f, 0xff, 0xf0, 0x1c, 0x00, 0x38,
@@ -206,7 +206,7 @@ const unsigned char bitmap_locked[] PROGMEM = {
     0x0f, 0xff, 0xf0, 0x07, 0xff, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 // 'emergency', 24x24px
-const unsigned char bitmap_emergency[] PROGMEM = {
+inline constexpr unsigned char bitmap_emergency[] PROGMEM = {
     0x00, 0x00, 0x00, 0x01, 0xff, 0x80, 0x03, 0xff, 0xc0, 0x07, 0x00, 0xe0,
     0x0e, 0x00, 0x70, 0x1c, 0x00, 0x38, 0x38, 0x00, 0x1c, 0x70, 0x18, 0x0e,
     0x60, 0x18, 0x06, 0x60, 0x18, 0x06, 0x60, 0x18, 0x06, 0x60, 0x18, 0x06,
@@ -215,7 +215,7 @@ const unsigned char bitmap_emergency[] PROGMEM = {
     0x07, 0x00, 0xe0, 0x03, 0xff, 0xc0, 0x01, 0xff, 0x80, 0x00, 0x00, 0x00};
 
 // 'back', 24x24px
-const unsigned char bitmap_back[] PROGMEM = {
+inline constexpr unsigned char bitmap_back[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x03, 0x00, 0x00, 0x07, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x1c, 0x00, 0x00,
     0x3f, 0xff, 0xe0, 0x3f, 0xff, 0xf0, 0x1c, 0x00, 0x38, 0x0e, 0x00, 0x18,
@@ -224,7 +224,7 @@ const unsigned char bitmap_back[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 // 'down', 24x24px
-const unsigned char bitmap_down[] PROGMEM = {
+inline constexpr unsigned char bitmap_down[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x18, 0x00,
     0x00, 0x18, 0x00, 0x00, 0x18, 0x00, 0x00, 0x18, 0x00, 0x00, 0x18, 0x00,
     0x00, 0x18, 0x00, 0x0c, 0x18, 0x30, 0x0e, 0x18, 0x70, 0x07, 0x18, 0xe0,
@@ -232,7 +232,7 @@ const unsigned char bitmap_down[] PROGMEM = {
     0x00, 0x3c, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x3f, 0xff, 0xfc, 0x3f, 0xff, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'left-double', 24x24px
-const unsigned char bitmap_left_double[] PROGMEM = {
+inline constexpr unsigned char bitmap_left_double[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x60, 0x00, 0x70, 0xe0,
     0x00, 0xe1, 0xc0, 0x01, 0xc3, 0x80, 0x03, 0x87, 0x00, 0x07, 0x0e, 0x00,
@@ -240,7 +240,7 @@ const unsigned char bitmap_left_double[] PROGMEM = {
     0x00, 0x70, 0xe0, 0x00, 0x30, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'left', 24x24px
-const unsigned char bitmap_left[] PROGMEM = {
+inline constexpr unsigned char bitmap_left[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x07, 0x00, 0x00, 0x0e, 0x00,
     0x00, 0x1c, 0x00, 0x00, 0x38, 0x00, 0x00, 0x70, 0x00, 0x00, 0xe0, 0x00,
@@ -248,7 +248,7 @@ const unsigned char bitmap_left[] PROGMEM = {
     0x00, 0x0e, 0x00, 0x00, 0x07, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'right', 24x24px
-const unsigned char bitmap_right[] PROGMEM = {
+inline constexpr unsigned char bitmap_right[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0xc0, 0x00, 0x00, 0xe0, 0x00, 0x00, 0x70, 0x00,
     0x00, 0x38, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x07, 0x00,
@@ -256,7 +256,7 @@ const unsigned char bitmap_right[] PROGMEM = {
     0x00, 0x70, 0x00, 0x00, 0xe0, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 // 'right double', 24x24px
-const unsigned char bitmap_right_double[] PROGMEM = {
+inline constexpr unsigned char bitmap_right_double[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x0c, 0x00, 0x07, 0x0e, 0x00,
     0x03, 0x87, 0x00, 0x01, 0xc3, 0x80, 0x00, 0xe1, 0xc0, 0x00, 0x70, 0xe0,
@@ -266,7 +266,7 @@ const unsigned char bitmap_right_double[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'BluetoothOn', 24x24px
-const unsigned char researchAndDesireBluetoothOn[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireBluetoothOn[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x1f, 0x80, 0x00,
     0x1b, 0xc0, 0x06, 0x19, 0xe0, 0x07, 0x99, 0xe0, 0x03, 0xdb, 0xc0, 0x01, 0xff, 0x80, 0x00, 0xff,
     0x00, 0x00, 0x7e, 0x00, 0x00, 0x7e, 0x00, 0x00, 0xff, 0x00, 0x01, 0xff, 0x80, 0x03, 0xdb, 0xc0,
@@ -275,7 +275,7 @@ const unsigned char researchAndDesireBluetoothOn[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'BluetoothOff', 24x24px
-const unsigned char researchAndDesireBluetoothOff[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireBluetoothOff[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x30, 0x1e, 0x00, 0x38, 0x1f, 0x00, 0x1c, 0x1f, 0x80, 0x0e,
     0x1b, 0xc0, 0x07, 0x19, 0xe0, 0x03, 0x99, 0xe0, 0x01, 0xc3, 0xc0, 0x00, 0xe3, 0x80, 0x00, 0x71,
     0x00, 0x00, 0x38, 0x00, 0x00, 0x7c, 0x00, 0x00, 0xfe, 0x00, 0x01, 0xff, 0x00, 0x03, 0xdb, 0x80,
@@ -284,7 +284,7 @@ const unsigned char researchAndDesireBluetoothOff[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'BluetoothConnect', 24x24px
-const unsigned char researchAndDesireBluetoothConnect[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireBluetoothConnect[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0xc0, 0x00, 0x00, 0xf0, 0x00, 0x00, 0xf8, 0x00, 0x00, 0xfc, 0x00, 0x00,
     0xde, 0x00, 0x30, 0xcf, 0x00, 0x3c, 0xcf, 0x00, 0x1e, 0xde, 0x00, 0x0f, 0xfc, 0x00, 0x07, 0xf8,
     0x00, 0x03, 0xf3, 0x6c, 0x03, 0xf3, 0x6c, 0x07, 0xf8, 0x00, 0x0f, 0xfc, 0x00, 0x1e, 0xde, 0x00,
@@ -293,7 +293,7 @@ const unsigned char researchAndDesireBluetoothConnect[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'BluetoothSignal', 24x24px
-const unsigned char researchAndDesireBluetoothSignal[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireBluetoothSignal[] PROGMEM = {
     0x00, 0x00, 0x00, 0x01, 0x80, 0x00, 0x01, 0xe0, 0x00, 0x01, 0xf0, 0x00, 0x01, 0xf8, 0x00, 0x01,
     0xbc, 0x18, 0x61, 0x9e, 0x1c, 0x79, 0x9e, 0x1c, 0x3d, 0xbc, 0xce, 0x1f, 0xf8, 0xee, 0x0f, 0xf0,
     0xee, 0x07, 0xe0, 0x6e, 0x07, 0xe0, 0x6e, 0x0f, 0xf0, 0xee, 0x1f, 0xf8, 0xee, 0x3d, 0xbc, 0xce,
@@ -302,7 +302,7 @@ const unsigned char researchAndDesireBluetoothSignal[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'Octagon', 24x24px
-const unsigned char researchAndDesireOctagon[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireOctagon[] PROGMEM = {
     0x00, 0x00, 0x00, 0x03, 0xff, 0xc0, 0x07, 0xff, 0xe0, 0x0f, 0x00, 0xf0, 0x1e, 0x00, 0x78, 0x3c,
     0x00, 0x3c, 0x78, 0x00, 0x1e, 0x70, 0x00, 0x0e, 0x60, 0x00, 0x06, 0x60, 0x00, 0x06, 0x60, 0x00,
     0x06, 0x60, 0x00, 0x06, 0x60, 0x00, 0x06, 0x60, 0x00, 0x06, 0x60, 0x00, 0x06, 0x60, 0x00, 0x06,
@@ -311,7 +311,7 @@ const unsigned char researchAndDesireOctagon[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'FaceWink', 24x24px
-const unsigned char researchAndDesireFaceWink[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireFaceWink[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x03, 0xff, 0xc0, 0x07, 0xf7, 0xe0, 0x0f, 0x00, 0xf0, 0x1e,
     0x00, 0x38, 0x38, 0x00, 0x3c, 0x38, 0x03, 0x1c, 0x71, 0xe7, 0x8e, 0x71, 0xe7, 0x8e, 0x70, 0x03,
     0x0e, 0x60, 0x00, 0x0e, 0x70, 0x00, 0x06, 0x71, 0x81, 0x8e, 0x71, 0xef, 0x8e, 0x70, 0xff, 0x0e,
@@ -320,7 +320,7 @@ const unsigned char researchAndDesireFaceWink[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'Heart', 24x24px
-const unsigned char researchAndDesireHeart[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireHeart[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xe7, 0xe0, 0x1f, 0xff, 0xf8, 0x3e, 0x7f, 0x7c, 0x38,
     0x3c, 0x1c, 0x70, 0x00, 0x0e, 0x70, 0x00, 0x0e, 0x60, 0x00, 0x06, 0x60, 0x00, 0x06, 0x70, 0x00,
     0x0e, 0x70, 0x00, 0x0e, 0x38, 0x00, 0x1c, 0x3c, 0x00, 0x3c, 0x1e, 0x00, 0x78, 0x0f, 0x00, 0xf0,
@@ -329,7 +329,7 @@ const unsigned char researchAndDesireHeart[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'Hourglass03', 24x24px
-const unsigned char researchAndDesireHourglass03[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireHourglass03[] PROGMEM = {
     0x00, 0x00, 0x00, 0x0f, 0xff, 0xf0, 0x0f, 0xff, 0xf0, 0x0c, 0x00, 0x30, 0x0c, 0x00, 0x30, 0x0c,
     0x00, 0x30, 0x0c, 0x00, 0x30, 0x0e, 0x00, 0x70, 0x07, 0x00, 0xe0, 0x03, 0x81, 0xc0, 0x01, 0xc3,
     0x80, 0x00, 0xe7, 0x00, 0x00, 0xe7, 0x00, 0x01, 0xc3, 0x80, 0x03, 0x81, 0xc0, 0x07, 0x00, 0xe0,
@@ -338,7 +338,7 @@ const unsigned char researchAndDesireHourglass03[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'Italic02', 24x24px
-const unsigned char researchAndDesireItalic02[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireItalic02[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xf8, 0x00, 0xff, 0xf8, 0x00,
     0x1d, 0xc0, 0x00, 0x1f, 0x80, 0x00, 0x1b, 0x80, 0x00, 0x3b, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x77,
     0x00, 0x00, 0x76, 0x00, 0x00, 0x6e, 0x00, 0x00, 0xee, 0x00, 0x00, 0xfc, 0x00, 0x00, 0xdc, 0x00,
@@ -347,7 +347,7 @@ const unsigned char researchAndDesireItalic02[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'Terminal', 24x24px
-const unsigned char researchAndDesireTerminal[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireTerminal[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x1c,
     0x00, 0x00, 0x0e, 0x00, 0x00, 0x07, 0x00, 0x00, 0x03, 0x80, 0x00, 0x01, 0xc0, 0x00, 0x00, 0xe0,
     0x00, 0x00, 0xe0, 0x00, 0x01, 0xc0, 0x00, 0x03, 0x80, 0x00, 0x07, 0x00, 0x00, 0x0e, 0x00, 0x00,
@@ -356,7 +356,7 @@ const unsigned char researchAndDesireTerminal[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'Wind01', 24x24px
-const unsigned char researchAndDesireWind01[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireWind01[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xf8, 0x3c,
     0xff, 0xfc, 0x3f, 0xff, 0x3c, 0x1f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f,
     0xf8, 0x3c, 0xff, 0xfc, 0x3f, 0xff, 0x3c, 0x1f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -365,7 +365,7 @@ const unsigned char researchAndDesireWind01[] PROGMEM = {
 
 // Generated C++ code for ESP32/Arduino on https://www.researchanddesire.com/dev/svg2cpp
 // 'ArrowsRight', 24x24px
-const unsigned char researchAndDesireArrowsRight[] PROGMEM = {
+inline constexpr unsigned char researchAndDesireArrowsRight[] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x38, 0x00, 0x00, 0x1c, 0x00, 0x00,
     0x0e, 0x00, 0x1f, 0xff, 0x00, 0x1f, 0xff, 0x00, 0x00, 0x0e, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x38,
     0x00, 0x00, 0x30, 0x00, 0x00, 0x01, 0x80, 0x00, 0x01, 0xc0, 0x00, 0x00, 0xe0, 0x00, 0x00, 0x70,
@@ -11,9 +11,8 @@
 #include "DisplayObject.h"
 #include "esp_log.h"
 #include "pins.h"
-#include "services/buzzer.h"
 #include "services/display.h"
-#include "services/vibrator.h"
+#include "services/feedback.h"
 
 class LinearRailGraph : public DisplayObject {
   private:
@@ -84,15 +83,16 @@ class LinearRailGraph : public DisplayObject {
             int currentStrokeWidth = actualFillWidth;
             int currentFillStart = actualFillStart;
 
-            // First time drawing - set up the border and initial state
-            if (lastStrokeWidth == -1) {
-                tft.fillRect(x, y, width, height, ST77XX_BLACK);
-                tft.drawRoundRect(x, y, width, height, 4, COLOR_WHITE);
+            // First time drawing, or painted over - set up the border and
+            // initial state
+            if (repaintAll() || lastStrokeWidth == -1) {
+                gfx().fillRect(x, y, width, height, ST77XX_BLACK);
+                gfx().drawRoundRect(x, y, width, height, 4, COLOR_WHITE);
 
                 // Draw the initial fill bar
                 if (actualFillWidth > 0) {
                     int screenFillStart = x + borderMargin + actualFillStart;
-                    tft.fillRect(screenFillStart, y + 1, actualFillWidth,
+                    gfx().fillRect(screenFillStart, y + 1, actualFillWidth,
                                  height - 2, COLOR_WHITE);
                 }
 
@@ -129,7 +129,7 @@ class LinearRailGraph : public DisplayObject {
                         int clearWidth =
                             min(screenNewStart, screenOldEnd) - screenOldStart;
                         if (clearWidth > 0) {
-                            tft.fillRect(screenOldStart, y + 1, clearWidth,
+                            gfx().fillRect(screenOldStart, y + 1, clearWidth,
                                          height - 2, ST77XX_BLACK);
                         }
                     }
@@ -140,7 +140,7 @@ class LinearRailGraph : public DisplayObject {
                         int clearStart = max(screenNewEnd, screenOldStart);
                         int clearWidth = screenOldEnd - clearStart;
                         if (clearWidth > 0) {
-                            tft.fillRect(clearStart, y + 1, clearWidth,
+                            gfx().fillRect(clearStart, y + 1, clearWidth,
                                          height - 2, ST77XX_BLACK);
                         }
                     }
@@ -154,7 +154,7 @@ class LinearRailGraph : public DisplayObject {
                         int fillWidth =
                             min(screenOldStart, screenNewEnd) - screenNewStart;
                         if (fillWidth > 0) {
-                            tft.fillRect(screenNewStart, y + 1, fillWidth,
+                            gfx().fillRect(screenNewStart, y + 1, fillWidth,
                                          height - 2, COLOR_WHITE);
                         }
                     }
@@ -165,7 +165,7 @@ class LinearRailGraph : public DisplayObject {
                         int fillStart = max(screenOldEnd, screenNewStart);
                         int fillWidth = screenNewEnd - fillStart;
                         if (fillWidth > 0) {
-                            tft.fillRect(fillStart, y + 1, fillWidth,
+                            gfx().fillRect(fillStart, y + 1, fillWidth,
                                          height - 2, COLOR_WHITE);
                         }
                     }
@@ -8,6 +8,8 @@
 #include "constants/Colors.h"
 #include "DisplayObject.h"
 #include "../services/display.h"
+#include "../services/input.h"
+#include "../services/text.h"
 
 extern Adafruit_ST7789 tft;
 extern SemaphoreHandle_t displayMutex;
@@ -60,7 +62,7 @@ public:
         
         // Only check pin state if a valid pin is assigned
         if (buttonPin != NO_PIN) {
-            currentState = digitalRead(buttonPin) == LOW;
+            currentState = isInputPressed(buttonPin);
             stateChanged = currentState != lastButtonState;
         }
         
@@ -77,39 +79,31 @@ public:
         
         // Only check pin state if a valid pin is assigned
         if (buttonPin != NO_PIN) {
-            currentState = digitalRead(buttonPin) == LOW;
+            currentState = isInputPressed(buttonPin);
         }
         
         if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
             // Clear the button area
-            tft.fillRect(x, y, width, height, ST77XX_BLACK);
-            
-            tft.setFont(&FreeSans9pt7b);
-            
-            if (!currentState) {
-                // Use filled rectangle for improved visuals 
-                //(border-only near physical screen border can cause visual artifacts)
-                tft.fillRoundRect(x, y, width, height, 5, backgroundColor);
-                tft.setTextColor(textColor);
-            } else {                
-                tft.fillRoundRect(x, y, width, height, 5, pressedBackgroundColor);
-                tft.setTextColor(pressedTextColor);
-            }
+            gfx().fillRect(x, y, width, height, ST77XX_BLACK);
             
+            uint16_t fillColor = currentState ? pressedBackgroundColor : backgroundColor;
+            uint16_t labelColor = currentState ? pressedTextColor : textColor;
+
+            // Use filled rectangle for improved visuals
+            //(border-only near physical screen border can cause visual artifacts)
+            gfx().fillRoundRect(x, y, width, height, 5, fillColor);
+
             // Calculate text position for proper centering (matching genericPages.cpp style)
-            int16_t x1, y1;
-            uint16_t textWidth, textHeight;
-            tft.getTextBounds(buttonText.c_str(), 0, 0, &x1, &y1, &textWidth, &textHeight);
-            
+            TextMetrics bounds = measureText(TextFont::Sans9, buttonText.c_str());
+
             // Horizontal centering
-            int16_t textX = x + (width - textWidth) / 2;
-            
+            int16_t textX = x + (width - bounds.width) / 2;
+
             // Vertical centering - using same formula as Device Stopped screen buttons
-            int16_t textY = y + (height + textHeight) / 2;
-            
-            tft.setCursor(textX, textY);
-            tft.print(buttonText);
-            
+            int16_t textY = y + (height + bounds.height) / 2;
+
+            drawText(TextFont::Sans9, buttonText.c_str(), textX, textY, labelColor, fillColor, gfx());
+
             xSemaphoreGive(displayMutex);
         }
         
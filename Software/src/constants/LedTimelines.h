@@ -0,0 +1,39 @@
+#ifndef LED_TIMELINES_H
+#define LED_TIMELINES_H
+
+#include "utils/LedTimeline.h"
+
+// inline so every translation unit shares one copy; playLedAnimation tells
+// timelines apart by address.
+namespace LedTimelines {
+    using LedTimeline::Keyframe;
+
+    inline constexpr Keyframe pulseFrames[] = {
+        {0x0000, 40}, {0x4000, 255}, {0x8000, 40}};
+
+    inline constexpr Keyframe breatheFrames[] = {
+        {0x0000, 20},  {0x2000, 60},  {0x4000, 150}, {0x6000, 230},
+        {0x8000, 255}, {0xA000, 230}, {0xC000, 150}, {0xE000, 60}};
+
+    inline constexpr Keyframe chaseFrames[] = {
+        {0x0000, 255}, {0x3000, 30}, {0xD000, 30}};
+
+    // Sharp flash at the start of every cycle.
+    inline constexpr Keyframe strobeFrames[] = {
+        {0x0000, 255}, {0x2000, 20}, {0xF000, 20}};
+
+    // Connecting and reconnecting.
+    inline constexpr LedTimeline::Timeline pulse =
+        LedTimeline::make(pulseFrames, 1000);
+    // Idle in the menus.
+    inline constexpr LedTimeline::Timeline breathe =
+        LedTimeline::make(breatheFrames, 4000);
+    // Scanning; each LED runs a third of a cycle behind the previous one.
+    inline constexpr LedTimeline::Timeline chase =
+        LedTimeline::make(chaseFrames, 900, 0x10000 / 3);
+    // One flash per stroke, following the LED pace.
+    inline constexpr LedTimeline::Timeline strobe =
+        LedTimeline::make(strobeFrames, 0);
+}
+
+#endif  // LED_TIMELINES_H
@@ -13,7 +13,7 @@ Device* ButtplugIODeviceFactory(
     String deviceName = String(advertisedDevice->getName().c_str());
 
     // Read and parse registry.json
-    JsonDocument registryDoc;
+    JsonDocument registryDoc(jsonAllocator());
     if (!readJsonFile("/registry.json", registryDoc)) {
         return nullptr;
     }
@@ -38,7 +38,7 @@ Device* ButtplugIODeviceFactory(
     for (JsonString configFileRow : configFiles) {
         configFileName = configFileRow.c_str();
 
-        JsonDocument configDoc;
+        JsonDocument configDoc(jsonAllocator());
         if (!readJsonFile(configFileName, configDoc)) {
             vTaskDelay(1);
             continue;
@@ -82,3 +82,29 @@ Device* ButtplugIODeviceFactory(
              deviceName.c_str());
     return nullptr;
 }
+
+Device* ButtplugIOPeerFactory(const PeerRecord& peer) {
+    String configFileName = peer.protocolFile;
+    if (configFileName.isEmpty()) {
+        return nullptr;
+    }
+
+    JsonDocument configDoc(jsonAllocator());
+    if (!readJsonFile(configFileName, configDoc) ||
+        !validateConfigStructure(configDoc, configFileName)) {
+        return nullptr;
+    }
+    vTaskDelay(1);
+
+    JsonObjectConst characteristics =
+        extractCharacteristics(configDoc, peer.serviceUUID);
+    if (characteristics.isNull()) {
+        ESP_LOGW("BUTTPLUGIO", "No characteristics for %s in %s",
+                 peer.serviceUUID, configFileName.c_str());
+        return nullptr;
+    }
+
+    return new LovenseDevice(NimBLEAddress(peer.address, peer.addressType),
+                             NimBLEUUID(peer.serviceUUID), configFileName,
+                             characteristics);
+}
@@ -8,10 +8,17 @@
 
 #include "../device.h"
 #include "../lovense/LovenseDevice.hpp"
+#include "structs/PeerRecord.h"
 
 /// @brief A device factory for devices that use the ButtplugIO protocol.
 /// @param advertisedDevice The advertised BLE device to create a device for
 /// @return A pointer to the created Device, or nullptr if creation failed
 Device* ButtplugIODeviceFactory(const NimBLEAdvertisedDevice* advertisedDevice);
 
+/// @brief Recreates a ButtplugIO device from a remembered peer, using the
+/// protocol file resolved when it was first connected.
+/// @param peer The stored peer record
+/// @return A pointer to the created Device, or nullptr if creation failed
+Device* ButtplugIOPeerFactory(const PeerRecord& peer);
+
 #endif  // BUTTPLUGIO_DEVICE_H
@@ -1,13 +1,16 @@
 #include <ArduinoJson.h>
 #include <NimBLEUUID.h>
 
+#include "services/heap.h"
+#include "services/sessionArena.h"
 #include "utils.h"
 
 class ButtplugIoProtocol {
   protected:
     NimBLEUUID serviceUUID;
-    JsonDocument config;
-    JsonDocument protocol;
+    // Kept for the whole session, unlike the documents parsed along the way.
+    JsonDocument config{sessionJsonAllocator()};
+    JsonDocument protocol{sessionJsonAllocator()};
     String configFileName;
     String deviceType;
     String deviceName;
@@ -15,8 +18,7 @@ class ButtplugIoProtocol {
   public:
     // Constructor accepting the service UUID and config
     ButtplugIoProtocol(const String& configFileName,
-                       const JsonObjectConst& characteristicsConfig)
-        : serviceUUID(serviceUUID), config() {
+                       const JsonObjectConst& characteristicsConfig) {
         // Copy the characteristics data into our own config document
         // to avoid lifetime issues with the original JsonObjectConst
         config.set(characteristicsConfig);
@@ -27,7 +29,7 @@ class ButtplugIoProtocol {
 
     void setProtocol(const String& identifierString) {
         // read the config file
-        JsonDocument doc;
+        JsonDocument doc(jsonAllocator());
         if (!readJsonFile(configFileName, doc)) {
             ESP_LOGE("BUTTPLUGIO_PROTOCOL", "Failed to read config file: %s",
                      configFileName.c_str());
@@ -1,19 +1,102 @@
 #include "device.h"
 
-#include <services/buzzer.h>
+#include <esp_timer.h>
+#include <services/feedback.h>
 
 #include "pages/genericPages.h"
+#include "pages/pageHost.h"
+#include "services/coms.h"
+#include "services/hotlog.h"
 #include "services/leds.h"
-#include "state/remote.h"
+#include "services/trace.h"
+#include "state/dispatcher.h"
+#include "utils/StaticRtos.h"
 
 Device *device = nullptr;
 
+// Connect timeout for a remembered address that was not seen in a scan.
+static const uint32_t DIRECT_CONNECT_TIMEOUT_MS = 2000;
+
+// Time spent in send(), reported every SEND_STATS_WRITES writes, e.g. to
+// compare HOTLOG_DEFERRED builds. Sends come from the page, dispatcher and
+// connection tasks, so the counters are kept under sendStatsMux.
+static const uint32_t SEND_STATS_WRITES = 64;
+struct SendStats {
+    uint32_t writes = 0;
+    uint32_t totalUs = 0;
+    uint32_t maxUs = 0;
+};
+static SendStats sendStats;
+static portMUX_TYPE sendStatsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Connections run one at a time on a task that lives for good. A new Device
+// leaves itself in pendingConnection and wakes the task; a newer one takes
+// the place of a request that has not started yet. The device being
+// connected is activeConnection; destroying it sets connectionCancelled and
+// leaves the delete to the task.
+static StaticTask<10 * configMINIMAL_STACK_SIZE> connectionTaskMemory;
+static TaskHandle_t connectionTaskHandle = NULL;
+static portMUX_TYPE connectionMux = portMUX_INITIALIZER_UNLOCKED;
+static Device *pendingConnection = nullptr;
+static Device *activeConnection = nullptr;
+static bool connectionCancelled = false;
+
+static bool isConnectionCancelled() {
+    portENTER_CRITICAL(&connectionMux);
+    bool cancelled = connectionCancelled;
+    portEXIT_CRITICAL(&connectionMux);
+    return cancelled;
+}
+
+// Pages may still be drawing a device that was just unhooked.
+static void deleteBetweenFrames(Device *device) {
+    runBetweenFrames([](void *arg) { delete static_cast<Device *>(arg); },
+                     device);
+}
+
+static void recordSendTime(uint32_t elapsedUs) {
+    SendStats report;
+    portENTER_CRITICAL(&sendStatsMux);
+    sendStats.writes++;
+    sendStats.totalUs += elapsedUs;
+    sendStats.maxUs = max(sendStats.maxUs, elapsedUs);
+    bool full = sendStats.writes >= SEND_STATS_WRITES;
+    if (full) {
+        report = sendStats;
+        sendStats = SendStats();
+    }
+    portEXIT_CRITICAL(&sendStatsMux);
+
+    if (full) {
+        HOT_LOGD(DEVICE, "send(): %lu us avg, %lu us max over %lu writes",
+                 (unsigned long)(report.totalUs / report.writes),
+                 (unsigned long)report.maxUs, (unsigned long)report.writes);
+    }
+}
+
 Device::Device(const NimBLEAdvertisedDevice *advertisedDevice)
-    : advertisedDevice(advertisedDevice) {
+    : advertisedDevice(advertisedDevice),
+      peerAddress(advertisedDevice->getAddress()) {
     startConnectionTask();
 }
 
+Device::Device(const NimBLEAddress &peerAddress)
+    : advertisedDevice(nullptr), peerAddress(peerAddress) {
+    startConnectionTask();
+}
+
+// A direct connection started at boot can finish before the state machine
+// exists; the event waits in the queue until the dispatcher starts.
+static void reportConnectionError() { postEvent<connected_error_event>(); }
+
 Device::~Device() {
+    // Too late to connect it if it is still waiting its turn.
+    portENTER_CRITICAL(&connectionMux);
+    if (pendingConnection == this) {
+        pendingConnection = nullptr;
+    }
+    portEXIT_CRITICAL(&connectionMux);
+
     displayObjects.clear();
     ESP_LOGD(TAG, "Cleared %zu display objects", displayObjects.size());
 
@@ -37,10 +120,29 @@ Device::~Device() {
     ESP_LOGD(TAG, "Device destructor completed");
 }
 
-void Device::connectionTask(void *pvParameter) {
-    Device *device = (Device *)pvParameter;
+void Device::destroy(Device *device) {
+    portENTER_CRITICAL(&connectionMux);
+    if (pendingConnection == device) {
+        pendingConnection = nullptr;
+    }
+    bool connecting = activeConnection == device;
+    if (connecting) {
+        connectionCancelled = true;
+    }
+    portEXIT_CRITICAL(&connectionMux);
+
+    if (connecting) {
+        ESP_LOGI(TAG, "Abandoning the connection in progress");
+        return;
+    }
+    deleteBetweenFrames(device);
+}
+
+void Device::runConnection(Device *device) {
     const NimBLEAdvertisedDevice *advDevice = device->advertisedDevice;
+    const NimBLEAddress peerAddress = device->peerAddress;
     bool connected = false;
+    TRACE_BEGIN(ConnectionTask, 0);
 
     updateStatusText("Initializing connection...");
 
@@ -48,6 +150,9 @@ void Device::connectionTask(void *pvParameter) {
         ESP_LOGI(TAG, "Connection task running");
 
         vTaskDelay(1000);
+        if (isConnectionCancelled()) {
+            break;
+        }
         NimBLEClient *pClient = nullptr;
 
         /** Check if we have a client we should reuse first **/
@@ -68,14 +173,19 @@ void Device::connectionTask(void *pvParameter) {
              * service database. This saves considerable time and power.
              */
             pClient =
-                NimBLEDevice::getClientByPeerAddress(advDevice->getAddress());
+                NimBLEDevice::getClientByPeerAddress(peerAddress);
             if (pClient) {
                 updateStatusText("Attempting fast reconnect...");
                 ESP_LOGD(TAG,
                          "Found existing client for peer: %s; attempting fast "
                          "reconnect (no svc refresh)",
-                         advDevice->getAddress().toString().c_str());
-                if (!pClient->connect(advDevice, false)) {
+                         peerAddress.toString().c_str());
+                TRACE_BEGIN(BleConnect, 0);
+                bool reconnected = advDevice
+                                       ? pClient->connect(advDevice, false)
+                                       : pClient->connect(peerAddress, false);
+                TRACE_END(BleConnect, 0);
+                if (!reconnected) {
                     updateStatusText("Reconnection failed, retrying...");
                     ESP_LOGE(
                         TAG,
@@ -147,23 +257,32 @@ void Device::connectionTask(void *pvParameter) {
                      "latency=0, timeout=1500ms");
 
             /** Set how long we are willing to wait for the connection to
-             * complete (milliseconds), default is 30000. */
-            pClient->setConnectTimeout(5 * 1000);
-            ESP_LOGD(TAG, "Connect timeout set: %dms", 5 * 1000);
+             * complete (milliseconds), default is 30000. A remembered peer
+             * that is switched off should fall back to scanning quickly. */
+            uint32_t connectTimeoutMs =
+                advDevice ? 5 * 1000 : DIRECT_CONNECT_TIMEOUT_MS;
+            pClient->setConnectTimeout(connectTimeoutMs);
+            ESP_LOGD(TAG, "Connect timeout set: %lums",
+                     (unsigned long)connectTimeoutMs);
 
             ESP_LOGI(TAG, "Connecting to peer (new client): %s",
-                     advDevice->getAddress().toString().c_str());
+                     peerAddress.toString().c_str());
             updateStatusText(String("Connecting to ") +
-                             advDevice->getAddress().toString().c_str() +
-                             "...");
+                             peerAddress.toString().c_str() + "...");
             vTaskDelay(11);
-            if (!pClient->connect(advDevice, true, false, false)) {
+            TRACE_BEGIN(BleConnect, 1);
+            bool connectedNow =
+                advDevice ? pClient->connect(advDevice, true, false, false)
+                          : pClient->connect(peerAddress, true, false, false);
+            TRACE_END(BleConnect, 1);
+            if (!connectedNow) {
                 updateStatusText("Connection failed, please try again.");
                 /** Created a client but failed to connect, don't need to keep
                  * it as it has no data */
                 NimBLEDevice::deleteClient(pClient);
                 ESP_LOGE(TAG, "Failed to connect, deleted client");
                 connected = false;
+                reportConnectionError();
                 break;
             }
             ESP_LOGD(TAG, "Initial connect (new client) succeeded");
@@ -177,10 +296,13 @@ void Device::connectionTask(void *pvParameter) {
             ESP_LOGW(TAG,
                      "Client instance exists but not connected; attempting "
                      "normal connect");
-            if (!pClient->connect(advDevice)) {
+            bool connectedNow = advDevice ? pClient->connect(advDevice)
+                                          : pClient->connect(peerAddress);
+            if (!connectedNow) {
                 updateStatusText("Connection failed, please try again.");
                 ESP_LOGE(TAG, "Failed to connect");
                 connected = false;
+                reportConnectionError();
                 break;
             }
             ESP_LOGD(TAG, "Connect after existence check succeeded");
@@ -192,14 +314,19 @@ void Device::connectionTask(void *pvParameter) {
                  pClient->getRssi());
         updateStatusText("Connected! Setting up device...");
 
+        // Owned by the device from here, so deleting it disconnects the
+        // client and drops its callbacks.
         device->pClient = pClient;
+        if (isConnectionCancelled()) {
+            break;
+        }
+        TRACE_BEGIN(ServiceDiscovery, 0);
         device->pService = pClient->getService(device->getServiceUUID());
         if (device->pService == nullptr) {
+            TRACE_END(ServiceDiscovery, 0);
             updateStatusText("Device service not found!");
             ESP_LOGE(TAG, "Service not found");
-            if (stateMachine) {
-                stateMachine->process_event(connected_error_event());
-            }
+            reportConnectionError();
             NimBLEDevice::getScan()->start(0);
             break;
         }
@@ -223,47 +350,90 @@ void Device::connectionTask(void *pvParameter) {
             }
         }
 
+        TRACE_END(ServiceDiscovery, 0);
+
         vTaskDelay(1);
+        if (isConnectionCancelled()) {
+            break;
+        }
         updateStatusText("Initializing device settings...");
 
         // run the user defined "on connect" method.
+        TRACE_BEGIN(DeviceOnConnect, 0);
         device->onConnect();
-        // Now signal the UI/state machine that we're ready
-        if (stateMachine) {
-            stateMachine->process_event(connected_event());
-        }
+        TRACE_END(DeviceOnConnect, 0);
+        onDeviceConnected(device);
+        // Now signal the UI/state machine that we're ready. A connection
+        // started at boot can get here before the state machine exists; the
+        // event is handled once it does.
+        postEvent<connected_event>();
 
         ESP_LOGI(TAG, "Done with this device!");
         updateStatusText("Device ready! Loading interface...");
         break;
     }
-    vTaskDelete(NULL);
+    TRACE_END(ConnectionTask, 0);
+}
+
+void Device::connectionTask(void *pvParameter) {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        portENTER_CRITICAL(&connectionMux);
+        Device *next = pendingConnection;
+        pendingConnection = nullptr;
+        activeConnection = next;
+        connectionCancelled = false;
+        portEXIT_CRITICAL(&connectionMux);
+        if (next == nullptr) {
+            continue;
+        }
+
+        runConnection(next);
+
+        portENTER_CRITICAL(&connectionMux);
+        bool cancelled = connectionCancelled;
+        activeConnection = nullptr;
+        connectionCancelled = false;
+        portEXIT_CRITICAL(&connectionMux);
+        if (cancelled) {
+            ESP_LOGI(TAG, "Connection abandoned, deleting its device");
+            deleteBetweenFrames(next);
+        }
+    }
 }
 
 void Device::startConnectionTask() {
-    xTaskCreatePinnedToCore(Device::connectionTask, "connectionTask",
-                            10 * configMINIMAL_STACK_SIZE, this, 1,
-                            &connectionTaskHandle, 0);
+    portENTER_CRITICAL(&connectionMux);
+    pendingConnection = this;
+    portEXIT_CRITICAL(&connectionMux);
+    if (connectionTaskHandle == NULL) {
+        connectionTaskHandle = connectionTaskMemory.start(
+            Device::connectionTask, "connectionTask", NULL, 1, 0);
+    }
+    xTaskNotifyGive(connectionTaskHandle);
 }
 
 void Device::onConnect(NimBLEClient *pClient) {
     ESP_LOGD(TAG, "Connected to %s", getName());
-    playBuzzerPattern(BuzzerPattern::DEVICE_CONNECTED);
+    playFeedback(FeedbackCue::DEVICE_CONNECTED);
+    stopLedAnimation();
     setLed(LEDColors::connected, 255, 1500);
 }
 
 void Device::onDisconnect(NimBLEClient *pClient, int reason) {
-    playBuzzerPattern(BuzzerPattern::DEVICE_DISCONNECTED);
+    playFeedback(FeedbackCue::DEVICE_DISCONNECTED);
     ESP_LOGD(TAG, "Disconnected from %s", getName());
     NimBLEDevice::getScan()->start(0);
     if (stateMachine) {
-        stateMachine->process_event(disconnected_event());
+        postEvent<disconnected_event>();
     }
     this->onDisconnect();
+    showLedAlert(Colors::red);
     setLed(LEDColors::logoBlue, 255, 1500);
 }
 
 bool Device::send(const std::string &command, const std::string &value) {
+    int64_t startUs = esp_timer_get_time();
     auto it = characteristics.find(command);
     if (it == characteristics.end()) {
         ESP_LOGW(TAG, "Characteristic '%s' not found for device '%s'",
@@ -286,13 +456,19 @@ bool Device::send(const std::string &command, const std::string &value) {
         return false;
     }
 
-    ESP_LOGI(TAG, "Writing value '%s' to characteristic '%s' on device '%s'",
-             value.c_str(), command.c_str(), getName());
+    HOT_LOGI(DEVICE, "Writing value '%s' to characteristic '%s' on device '%s'",
+             value, command, getName());
     std::string encodedValue = value;
     if (it->second.encode) {
         encodedValue = it->second.encode(value);
     }
-    return pChr->writeValue(encodedValue);
+    bool written;
+    {
+        TRACE_SCOPE(BleWrite, encodedValue.size());
+        written = pChr->writeValue(encodedValue);
+    }
+    recordSendTime(esp_timer_get_time() - startUs);
+    return written;
 }
 
 std::string Device::readString(const std::string &characteristicName) {
@@ -318,12 +494,12 @@ std::string Device::readString(const std::string &characteristicName) {
         return std::string();
     }
 
-    ESP_LOGD(TAG, "Reading value from characteristic '%s' on device '%s'",
-             characteristicName.c_str(), getName());
+    HOT_LOGD(DEVICE, "Reading value from characteristic '%s' on device '%s'",
+             characteristicName, getName());
     NimBLEAttValue rawValue = pChr->readValue();
 
-    ESP_LOGI(TAG, "Read value from characteristic '%s' on device '%s': %s",
-             characteristicName.c_str(), getName(), rawValue.c_str());
+    HOT_LOGI(DEVICE, "Read value from characteristic '%s' on device '%s': %s",
+             characteristicName, getName(), rawValue.c_str());
     return rawValue.c_str();
 }
 
@@ -343,7 +519,7 @@ std::string Device::readJsonString(const std::string &command) {
 }
 
 void Device::drawDeviceMenu() {
-    activeMenu = &menu;
+    activeMenu = menu.data();
     activeMenuCount = menu.size();
 
     drawMenu();
@@ -5,7 +5,9 @@
 
 #include <ArduinoJson.h>
 #include <NimBLEDevice.h>
-#include <components/DisplayObject.h>
+#include <atomic>
+#include <components/DisplayGroup.h>
+#include <constants/Sizes.h>
 #include <functional>
 #include <memory>
 #include <structs/Menus.h>
@@ -14,6 +16,9 @@
 #include <vector>
 
 #include "devices/serviceUUIDs.h"
+#include "services/heap.h"
+#include "services/sessionArena.h"
+#include "utils/StringPool.h"
 
 static const char *TAG = "DEVICE";
 
@@ -32,33 +37,52 @@ struct DeviceCharacteristics {
     NimBLERemoteCharacteristic::notify_callback notifyCallback = nullptr;
 };
 
+using CharacteristicMap = std::unordered_map<
+    std::string, DeviceCharacteristics, std::hash<std::string>,
+    std::equal_to<std::string>,
+    SessionAllocator<std::pair<const std::string, DeviceCharacteristics>>>;
+
 struct DeviceDisplayObject {
     std::string name;
     DisplayObject *displayObject;
 };
 
-class Device : public NimBLEClientCallbacks {
+class Device : public NimBLEClientCallbacks, public SessionAllocated {
   public:
+    // Null when connecting straight to a remembered address.
     const NimBLEAdvertisedDevice *advertisedDevice;
+    NimBLEAddress peerAddress;
     NimBLEClient *pClient;
     NimBLERemoteService *pService;
 
-    bool isConnected = false;
+    // Set by the BLE callbacks, read by the dispatcher and the pages.
+    std::atomic<bool> isConnected{false};
     bool isPaused = false;
     bool isTested = false;
 
-    std::vector<MenuItem> menu;
-    std::vector<MenuItem> settingsMenu;
+    MenuList menu;
+    MenuList settingsMenu;
+    // Names and descriptions for the items above.
+    StringPool<PlacedAllocator<char, HeapUser::Strings>> menuStrings;
 
-    std::unordered_map<std::string, DeviceCharacteristics> characteristics;
-    std::vector<std::unique_ptr<DisplayObject>> displayObjects;
+    CharacteristicMap characteristics;
+    // Retained widget tree for the device's pages, covering the whole screen.
+    DisplayGroup displayObjects{0, 0, Display::WIDTH, Display::HEIGHT};
 
     // Constructor with settings document size parameter
     explicit Device(const NimBLEAdvertisedDevice *advertisedDevice);
 
+    // Connects directly to a known address without a scan result.
+    explicit Device(const NimBLEAddress &peerAddress);
+
     // Virtual destructor for proper cleanup
     virtual ~Device();
 
+    // Deletes `device`. If the connection task is connecting it right now,
+    // the connection is abandoned instead and the task deletes the device
+    // once it lets go of it.
+    static void destroy(Device *device);
+
     // Virtual methods that child classes can optionally override
     virtual void onRightBumperClick() {}
     virtual void onLeftBumperClick() {}
@@ -95,18 +119,19 @@ class Device : public NimBLEClientCallbacks {
     virtual NimBLEUUID getServiceUUID() = 0;
     virtual const char *getName() = 0;
 
+    // Protocol file the device was resolved with, if any. Stored with the
+    // peer so it does not need resolving again on reconnect.
+    virtual const char *getProtocolFile() const { return ""; }
+
     // Display object helpers
     template <typename TDisplayObject, typename... TArgs>
     TDisplayObject *draw(TArgs &&...args) {
-        auto uniquePtr =
-            std::make_unique<TDisplayObject>(std::forward<TArgs>(args)...);
-        TDisplayObject *rawPtr = uniquePtr.get();
-        displayObjects.emplace_back(std::move(uniquePtr));
-        return rawPtr;
+        return displayObjects.add<TDisplayObject>(std::forward<TArgs>(args)...);
     }
 
   protected:
-    TaskHandle_t connectionTaskHandle;
+    // Connects `device`; runs on the connection task.
+    static void runConnection(Device *device);
     static void connectionTask(void *pvParameter);
 
     void onConnect(NimBLEClient *pClient) override;
@@ -124,7 +149,7 @@ class Device : public NimBLEClientCallbacks {
     T readJsonValue(const std::string &characteristicName, const char *key,
                     T defaultValue) {
         auto value = readString(characteristicName);
-        JsonDocument doc;
+        JsonDocument doc(jsonAllocator());
         DeserializationError error = deserializeJson(doc, value.c_str());
 
         if (error) {
@@ -144,7 +169,7 @@ class Device : public NimBLEClientCallbacks {
     bool readJson(const std::string &command,
                   std::function<void(const T &)> callback) {
         auto value = readString(command);
-        JsonDocument doc;
+        JsonDocument doc(jsonAllocator());
         DeserializationError error = deserializeJson(doc, value.c_str());
 
         if (error) {
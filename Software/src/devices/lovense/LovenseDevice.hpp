@@ -22,34 +22,18 @@ class LovenseDevice : public Device, public ButtplugIoProtocol {
                   const JsonObjectConst &characteristicsConfig)
         : Device(advertisedDevice),
           ButtplugIoProtocol(configFileName, characteristicsConfig) {
-        ESP_LOGI("LOVENSE", "LovenseDevice constructor");
-        // We assume these characteristics are present.
-
-        // print the characteristics config
-        String characteristicsConfigString = "";
-        serializeJson(config, characteristicsConfigString);
-        ESP_LOGI("LOVENSE", "Characteristics config: %s",
-                 characteristicsConfigString.c_str());
-
-        String tx = config["tx"].as<String>();
-        String rx = config["rx"].as<String>();
-
-        ESP_LOGI("LOVENSE", "tx: %s", tx.c_str());
-        ESP_LOGI("LOVENSE", "rx: %s", rx.c_str());
+        serviceUUID = advertisedDevice->getServiceUUID();
+        initCharacteristics();
+    }
 
-        characteristics = {
-            {"tx", {NimBLEUUID(tx.c_str())}},
-            {"rx",
-             DeviceCharacteristics{
-                 NimBLEUUID(rx.c_str()),
-                 .notifyCallback =
-                     [this](NimBLERemoteCharacteristic *pRemoteCharacteristic,
-                            uint8_t *pData, size_t length, bool isNotify) {
-                         rxValue =
-                             String(reinterpret_cast<char *>(pData), length);
-                         ESP_LOGD("LOVENSE", "Notification received, value: %s",
-                                  rxValue.c_str());
-                     }}}};
+    // Reconnects to a remembered peer with an already resolved config file.
+    LovenseDevice(const NimBLEAddress &peerAddress,
+                  const NimBLEUUID &serviceUUID, const String &configFileName,
+                  const JsonObjectConst &characteristicsConfig)
+        : Device(peerAddress),
+          ButtplugIoProtocol(configFileName, characteristicsConfig) {
+        this->serviceUUID = serviceUUID;
+        initCharacteristics();
     }
 
     String rxValue = "";
@@ -99,8 +83,10 @@ class LovenseDevice : public Device, public ButtplugIoProtocol {
         isConnected = true;
     }
 
-    NimBLEUUID getServiceUUID() override {
-        return advertisedDevice->getServiceUUID();
+    NimBLEUUID getServiceUUID() override { return serviceUUID; }
+
+    const char *getProtocolFile() const override {
+        return configFileName.c_str();
     }
 
     void drawControls() override {
@@ -142,6 +128,38 @@ class LovenseDevice : public Device, public ButtplugIoProtocol {
     }
 
     const char *getName() override { return "Lovense"; }
+
+  private:
+    void initCharacteristics() {
+        ESP_LOGI("LOVENSE", "LovenseDevice constructor");
+        // We assume these characteristics are present.
+
+        // print the characteristics config
+        String characteristicsConfigString = "";
+        serializeJson(config, characteristicsConfigString);
+        ESP_LOGI("LOVENSE", "Characteristics config: %s",
+                 characteristicsConfigString.c_str());
+
+        String tx = config["tx"].as<String>();
+        String rx = config["rx"].as<String>();
+
+        ESP_LOGI("LOVENSE", "tx: %s", tx.c_str());
+        ESP_LOGI("LOVENSE", "rx: %s", rx.c_str());
+
+        characteristics = {
+            {"tx", {NimBLEUUID(tx.c_str())}},
+            {"rx",
+             DeviceCharacteristics{
+                 NimBLEUUID(rx.c_str()),
+                 .notifyCallback =
+                     [this](NimBLERemoteCharacteristic *pRemoteCharacteristic,
+                            uint8_t *pData, size_t length, bool isNotify) {
+                         rxValue =
+                             String(reinterpret_cast<char *>(pData), length);
+                         ESP_LOGD("LOVENSE", "Notification received, value: %s",
+                                  rxValue.c_str());
+                     }}}};
+    }
 };
 
 #endif  // LOVENSE_DEVICE_HPP
\ No newline at end of file
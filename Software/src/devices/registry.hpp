@@ -48,7 +48,7 @@ inline const std::unordered_map<std::string, DeviceFactory> &getRegistry() {
                         String jsonString = file.readString();
                         file.close();
 
-                        JsonDocument doc;
+                        JsonDocument doc(jsonAllocator());
                         DeserializationError error =
                             deserializeJson(doc, jsonString);
                         vTaskDelay(1);
@@ -111,4 +111,29 @@ inline const DeviceFactory *getDeviceFactory(const NimBLEUUID &serviceUUID) {
     return &it->second;
 }
 
-#endif
\ No newline at end of file
+// Recreates the device for a remembered peer without scanning for it.
+// Returns nullptr if the peer's service is no longer supported.
+inline Device *createDeviceForPeer(const PeerRecord &peer) {
+    NimBLEUUID serviceUUID(peer.serviceUUID);
+    std::string uuidStr = serviceUUID.toString().c_str();
+    std::transform(uuidStr.begin(), uuidStr.end(), uuidStr.begin(), ::toupper);
+
+    const auto &registry = getRegistry();
+    auto it = registry.find(uuidStr);
+    if (it == registry.end()) {
+        return nullptr;
+    }
+
+    if (uuidStr == OSSM_SERVICE_ID) {
+        return new OSSM(NimBLEAddress(peer.address, peer.addressType));
+    }
+    if (it->second == ButtplugIODeviceFactory) {
+        return ButtplugIOPeerFactory(peer);
+    }
+
+    ESP_LOGW(REGISTRY_TAG, "No direct connect support for %s",
+             uuidStr.c_str());
+    return nullptr;
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <components/EncoderDial.h>
 #include <components/LinearRailGraph.h>
 #include <components/TextButton.h>
+#include <constants/LedTimelines.h>
 #include <pages/menus.h>
 #include <services/leds.h>
 
@@ -25,6 +26,10 @@ extern void resetMiddleButtonCounter();
 #define OSSM_CHARACTERISTIC_UUID_PATTERN_DESCRIPTION \
     "522b443a-4f53-534d-3010-420badbabe69"
 
+// Rough stroke rate at 100% speed, used to pace the LEDs. The real rate also
+// depends on stroke length and pattern.
+#define OSSM_MAX_STROKES_PER_MINUTE 180.0f
+
 class OSSM : public Device {
   public:
     SettingPercents settings;
@@ -53,15 +58,11 @@ class OSSM : public Device {
 
     explicit OSSM(const NimBLEAdvertisedDevice *advertisedDevice)
         : Device(advertisedDevice) {
-        characteristics = {
-            {"command", {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_COMMAND)}},
-            {"speedKnobLimit",
-             {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_SET_SPEED_KNOB_LIMIT)}},
-            {"patterns", {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_PATTERNS)}},
-            {"patternDescription",
-             {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_PATTERN_DESCRIPTION)}},
-            {"state", {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_STATE)}},
-        };
+        initCharacteristics();
+    }
+
+    explicit OSSM(const NimBLEAddress &peerAddress) : Device(peerAddress) {
+        initCharacteristics();
     }
 
     const char *getName() override { return "OSSM"; }
@@ -176,10 +177,11 @@ class OSSM : public Device {
             readJson<JsonArray>("patterns", [this](const JsonArray &patterns) {
                 // clear the patterns vector
                 this->menu.clear();
+                this->menuStrings.clear();
 
                 for (JsonVariant v : patterns) {
                     auto icon = researchAndDesireWaves;
-                    std::string name = v["name"].as<const char *>();
+                    const char *name = v["name"].as<const char *>();
                     std::string lowerName = name;
                     std::transform(lowerName.begin(), lowerName.end(),
                                    lowerName.begin(), ::tolower);
@@ -204,16 +206,18 @@ class OSSM : public Device {
 
                     int idx = v["idx"].as<int>();
 
-                    std::optional<std::string> description = std::nullopt;
+                    const char *description = nullptr;
                     if (send("patternDescription", std::to_string(idx))) {
-                        description = readString("patternDescription");
-                        ESP_LOGI(TAG, "Description: %s", description->c_str());
+                        description = menuStrings.get(menuStrings.intern(
+                            readString("patternDescription")));
+                        ESP_LOGI(TAG, "Description: %s", description);
                     }
 
-                    ESP_LOGI(TAG, "Pattern: %s, %d", name.c_str(), idx);
-                    this->menu.push_back(MenuItem{MenuItemE::DEVICE_MENU_ITEM,
-                                                  name, icon, description,
-                                                  .metaIndex = idx});
+                    ESP_LOGI(TAG, "Pattern: %s, %d", name, idx);
+                    this->menu.push_back(MenuItem{
+                        MenuItemE::DEVICE_MENU_ITEM,
+                        menuStrings.get(menuStrings.intern(name)), icon,
+                        description, .metaIndex = idx});
                 }
 
                 updatePatternNameFromState();
@@ -239,10 +243,11 @@ class OSSM : public Device {
     }
 
     void onPause(bool fullStop = false) override {
-        playBuzzerPattern(BuzzerPattern::PAUSED);
+        playFeedback(FeedbackCue::PAUSED);
         isPaused = true;
         setSpeed(0);
         leftEncoder.setEncoderValue(0);
+        stopLedAnimation();
 
         patternName = "Paused";
         
@@ -291,11 +296,13 @@ class OSSM : public Device {
     }
 
     void onResume() override {
-        // playBuzzerPattern(BuzzerPattern::PLAY);
+        // playFeedback(FeedbackCue::PLAY);
         leftEncoder.setBoundaries(0, 100);
         isPaused = false;
         resetMiddleButtonCounter();
-        setMiddleLed(Colors::white, 50);
+        // The middle LED flashes once per stroke while playing.
+        releaseIndividualLed(1);
+        playLedAnimation(LedTimelines::strobe, LEDColors::idle, 50);
         
         // Guard: Only update UI elements if displayObjects hasn't been cleared
         if (displayObjects.empty()) {
@@ -341,6 +348,7 @@ class OSSM : public Device {
         } while (isConnected && !isInMenu);
 
         //release all leds back to global control
+        stopLedAnimation();
         for (uint8_t i = 0; i < pins::NUM_LEDS; i++) {
             releaseIndividualLed(i);
         }
@@ -349,7 +357,7 @@ class OSSM : public Device {
     void onDeviceMenuItemSelected(int index) override { setPattern(index); }
 
     void drawDeviceMenu() override {
-        activeMenu = &menu;
+        activeMenu = menu.data();
         activeMenuCount = menu.size();
 
         // Find the menu index that corresponds to the current pattern
@@ -373,6 +381,7 @@ class OSSM : public Device {
         }
         settings.speed = speed;
         speed = constrain(speed, 0, 100);
+        setLedPaceRpm(speed * OSSM_MAX_STROKES_PER_MINUTE / 100.0f);
         return send("command",
                     std::string("set:speed:") + std::to_string(speed));
     }
@@ -499,6 +508,18 @@ class OSSM : public Device {
     const char *getLeftEncoderParameterName() const override { return "Speed"; }
 
   private:
+    void initCharacteristics() {
+        characteristics = {
+            {"command", {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_COMMAND)}},
+            {"speedKnobLimit",
+             {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_SET_SPEED_KNOB_LIMIT)}},
+            {"patterns", {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_PATTERNS)}},
+            {"patternDescription",
+             {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_PATTERN_DESCRIPTION)}},
+            {"state", {NimBLEUUID(OSSM_CHARACTERISTIC_UUID_STATE)}},
+        };
+    }
+
     void updatePatternNameFromState() {
         // Find the pattern name that corresponds to the current pattern from
         // BLE state
@@ -1,43 +1,185 @@
 #include <Arduino.h>
 
-#include <OneButton.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
 #include "components/AnimatedIcons.h"
 #include "constants.h"
+#include "constants/Colors.h"
 #include "esp_log.h"
 #include "pins.h"
 #include "services/battery.h"
-#include "services/buzzer.h"
+#include "services/boot.h"
 #include "services/coms.h"
 #include "services/display.h"
 #include "services/encoder.h"
+#include "services/feedback.h"
+#include "services/heap.h"
+#include "services/hotlog.h"
 #include "services/imu.h"
+#include "services/input.h"
 #include "services/leds.h"
 #include "services/lastInteraction.h"
 #include "services/memory.h"
-#include "services/vibrator.h"
+#include "services/power.h"
+#include "services/resume.h"
+#include "services/sessionArena.h"
+#include "services/stackAudit.h"
+#include "services/text.h"
+#include "services/trace.h"
 #include "services/wm.h"
-#include "state/remote.h"
+#include "services/workers.h"
+#include "pages/menus.h"
+#include "pages/pageHost.h"
+#include "state/dispatcher.h"
 
 // Function declaration for resetting middle button counter
 extern void resetMiddleButtonCounter();
 
-OneButton leftShoulderBtn;
-OneButton rightShoulderBtn;
-OneButton underLeftBtn;
-OneButton underCenterBtn;
-OneButton underRightBtn;
-
 // Global variables for middle button press tracking
 static int middleButtonPressCount = 0;
 
 // Function to reset middle button counter (can be called from device)
 void resetMiddleButtonCounter() { middleButtonPressCount = 0; }
 
+static void onButtonEvent(const InputEvent &event) {
+    if (event.type == InputEventType::LongPress &&
+        event.button == InputButton::UnderCenter) {
+        setNotIdle("under_center_hold");
+        postEvent<sleep_button_pressed>(EventSource::Input);
+        return;
+    }
+    if (event.type != InputEventType::Click) {
+        return;
+    }
+
+    switch (event.button) {
+        case InputButton::LeftShoulder:
+            setNotIdle("left_shoulder_btn");
+            postEvent<left_shoulder_pressed>(EventSource::Input);
+            break;
+        case InputButton::RightShoulder:
+            setNotIdle("right_shoulder_btn");
+            postEvent<right_shoulder_pressed>(EventSource::Input);
+            break;
+        case InputButton::UnderLeft:
+            setNotIdle("under_left_btn");
+            postEvent<left_button_pressed>(EventSource::Input);
+            break;
+        case InputButton::UnderCenter:
+            setNotIdle("under_center_btn");
+            middleButtonPressCount++;
+            if (middleButtonPressCount == 1) {
+                // First press action
+                postEvent<middle_button_pressed>(EventSource::Input);
+            } else if (middleButtonPressCount >= 2) {
+                // Second press action
+                resetMiddleButtonCounter();
+                postEvent<middle_button_second_press>(EventSource::Input);
+            }
+            break;
+        case InputButton::UnderRight:
+            setNotIdle("under_right_btn");
+            postEvent<right_button_pressed>(EventSource::Input);
+            break;
+        default:
+            break;
+    }
+}
+
+// Everything the state machine's first page needs is ahead of it; WiFi,
+// the battery gauge and the status bar come up alongside or after it.
+static const BootStep BOOT_STEPS[] = {
+    {BootService::Memory, "memory", 0, tskNO_AFFINITY,
+     [] { initMemoryService(); }},
+    {BootService::Encoders, "encoders", 0, tskNO_AFFINITY,
+     [] {
+         initEncoderService();
+         if (isResuming()) {
+             const ResumeState &resume = getResumeState();
+             currentOption = resume.menuOption;
+             leftEncoder.setEncoderValue(resume.leftEncoder);
+             rightEncoder.setEncoderValue(resume.rightEncoder);
+         }
+     }},
+    {BootService::Leds, "leds", 0, tskNO_AFFINITY,
+     [] {
+         initFastLEDs();
+         if (!isResuming()) {
+             setLed(LEDColors::logoBlue, 255, 1500);
+         }
+     }},
+    {BootService::Display, "display", 0, tskNO_AFFINITY, [] { initDisplay(); }},
+    {BootService::Text, "text", 0, tskNO_AFFINITY, [] { initText(); }},
+    {BootService::PageHost, "pageHost", bootBit(BootService::Display),
+     tskNO_AFFINITY, [] { initPageHost(); }},
+    // The radio stacks run their own tasks on core 0.
+    {BootService::Ble, "ble", 0, 0, [] { initBLE(); }},
+    // Connect to the last device while the rest of the remote starts up.
+    // The state machine picks this up and skips the scan. Waking from sleep
+    // taken on the main menu goes straight back there instead.
+    {BootService::Reconnect, "reconnect",
+     bootBit(BootService::Memory) | bootBit(BootService::Ble), tskNO_AFFINITY,
+     [] {
+         if (!isResuming() ||
+             getResumeState().screen == ResumeScreen::DeviceControls) {
+             startPeerReconnect();
+         }
+     }},
+    // After BLE so the two don't bring up the shared radio at once.
+    {BootService::Wifi, "wifi", bootBit(BootService::Ble), 0,
+     [] { initWM(); }},
+    {BootService::Feedback, "feedback", 0, tskNO_AFFINITY,
+     [] {
+         initFeedback();
+         if (!isResuming()) {
+             playFeedback(FeedbackCue::BOOT);
+         }
+     }},
+    {BootService::Workers, "workers", 0, tskNO_AFFINITY, [] { initWorkers(); }},
+    // Draws the first page and, unless reconnecting, starts the scan.
+    {BootService::StateMachine, "stateMachine",
+     bootBit(BootService::Encoders) | bootBit(BootService::Leds) |
+         bootBit(BootService::Text) | bootBit(BootService::PageHost) |
+         bootBit(BootService::Reconnect) | bootBit(BootService::Feedback) |
+         bootBit(BootService::Workers),
+     tskNO_AFFINITY, [] { initStateMachine(); }},
+    // Shares the I2C bus the memory step starts.
+    {BootService::Battery, "battery", bootBit(BootService::Memory),
+     tskNO_AFFINITY, [] { initBattery(); }},
+    {BootService::StatusBar, "statusBar",
+     bootBit(BootService::Display) | bootBit(BootService::Wifi) |
+         bootBit(BootService::Battery),
+     tskNO_AFFINITY, [] { setupAnimatedIcons(); }},
+    // Clock changes wait until the peripherals above are configured.
+    {BootService::Power, "power", bootBit(BootService::StateMachine),
+     tskNO_AFFINITY, [] { initPowerGovernor(); }},
+    {BootService::IdleMonitor, "idleMonitor", bootBit(BootService::Power),
+     tskNO_AFFINITY, [] { setupIdleMonitor(); }},
+    // Buttons come last so no event reaches a half-initialised service.
+    {BootService::Input, "input",
+     bootBit(BootService::StateMachine) | bootBit(BootService::Wifi) |
+         bootBit(BootService::StatusBar) | bootBit(BootService::IdleMonitor),
+     tskNO_AFFINITY,
+     [] {
+         subscribeInput(onButtonEvent);
+         initInput();
+     }},
+};
+
 void setup() {
     Serial.begin(115200);
+    initTrace();
+    TRACE_SCOPE(Setup, 0);
+    initHotLog();
+    initStackAudit();
+    initHeapCensus();
+    initSessionArena();
+    // Boot tasks may post events before the state machine is up.
+    initEventQueue();
+
+    // Before anything else touches the wake button's pin.
+    initResume();
 
     // Version 1.x of the PCB Boards cannot use PSRAM
     if (psramInit()) {
@@ -48,67 +190,18 @@ void setup() {
 
     ESP_LOGD(TAG, "PSRAM found: %d", psramFound());
 
-    // init buttons
-    leftShoulderBtn = OneButton(pins::BTN_L_SHOULDER, true, true);
-    leftShoulderBtn.attachClick(
-        []() { setNotIdle("left_shoulder_btn"); stateMachine->process_event(left_shoulder_pressed()); });
-    rightShoulderBtn = OneButton(pins::BTN_R_SHOULDER, true, true);
-    rightShoulderBtn.attachClick(
-        []() { setNotIdle("right_shoulder_btn"); stateMachine->process_event(right_shoulder_pressed()); });
-    underLeftBtn = OneButton(pins::BTN_UNDER_L, true, true);
-    underLeftBtn.attachClick(
-        []() { setNotIdle("under_left_btn"); stateMachine->process_event(left_button_pressed()); });
-    underCenterBtn = OneButton(pins::BTN_UNDER_C, true, true);
-    underCenterBtn.attachClick([]() {
-        setNotIdle("under_center_btn");
-        middleButtonPressCount++;
-        if (middleButtonPressCount == 1) {
-            // First press action
-            stateMachine->process_event(middle_button_pressed());
-        } else if (middleButtonPressCount >= 2) {
-            // Second press action
-            resetMiddleButtonCounter();
-            stateMachine->process_event(middle_button_second_press());
-        }
-    });
-    underRightBtn = OneButton(pins::BTN_UNDER_R, true, true);
-    underRightBtn.attachClick(
-        []() { setNotIdle("under_right_btn"); stateMachine->process_event(right_button_pressed()); });
-
-    initMemoryService();
-    initEncoderService();
-    initFastLEDs();
-    initWM();
-    initDisplay();
-    initBuzzer();
-    initVibrator();
-    initBLE();
-    initStateMachine();
-    initBattery();
-
     // initIMUService();
     // updateIMUReadings();
 
-    setupAnimatedIcons();
-    setupIdleMonitor();
-
-    xTaskCreatePinnedToCore(
-        [](void *pvParameters) {
-            while (true) {
-                vTaskDelay(10);
-                leftShoulderBtn.tick();
-                rightShoulderBtn.tick();
-                underLeftBtn.tick();
-                underCenterBtn.tick();
-                underRightBtn.tick();
-                wm.process();
-            }
-        },
-        "buttonTask", 6 * configMINIMAL_STACK_SIZE, NULL,
-        configMAX_PRIORITIES - 1, NULL, 0);
+    runBoot(BOOT_STEPS, sizeof(BOOT_STEPS) / sizeof(BOOT_STEPS[0]));
 }
 
 void loop() {
+    // setup() ran the boot on this task, so its stack goes in the report.
+    auditStack(xTaskGetCurrentTaskHandle(), "loopTask",
+               getArduinoLoopTaskStackSize());
+    auditStackBeforeExit();
+
     // delete the loop task. Everything is managed by the state machine now.
     vTaskDelete(NULL);
 }
@@ -25,6 +25,12 @@ static const TextPage deviceConnectingPage = {
     .leftButtonText = CANCEL_STRING,
 };
 
+static const TextPage deviceReconnectingPage = {
+    .title = "Reconnecting",
+    .description = "Connecting to your last device...",
+    .leftButtonText = CANCEL_STRING,
+};
+
 static const TextPage deviceStopPage = {.title = DEVICE_STOP_TITLE,
                                         .description = DEVICE_STOP_DESCRIPTION,
                                         .leftButtonText = GO_BACK,
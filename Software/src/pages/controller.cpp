@@ -1,113 +1,234 @@
 #include <Arduino.h>
+#include <atomic>
 #include "controller.h"
 #include <components/TextButton.h>
 #include <constants.h>
 #include <state/remote.h>
 #include <services/encoder.h>
+#include <services/input.h>
 #include <services/lastInteraction.h>
+#include <services/trace.h>
+#include <services/resume.h>
+#include <services/text.h>
 #include <components/Image.h>
 #include <devices/researchAndDesire/ossm/ossm_device.hpp>
 #include <components/LinearRailGraph.h>
 
 using namespace sml;
-void drawControllerTask(void *pvParameters)
-{
-    clearPage();
-    ESP_LOGI(TAG, "IN THE CONTROL TASK");
 
-    Device *device = static_cast<Device *>(pvParameters);
+// Bumper presses not yet handed to the device, filled from the input task.
+static std::atomic<uint8_t> leftBumperPresses{0};
+static std::atomic<uint8_t> rightBumperPresses{0};
 
-    // wait until the device is connected
-    ESP_LOGI(TAG, "Waiting for device to connect");
-    while (!device->isConnected)
+static void onBumperEvent(const InputEvent &event)
+{
+    if (event.type != InputEventType::Press)
+    {
+        return;
+    }
+    if (event.button == InputButton::LeftShoulder)
     {
-        // TODO: UI / UX here.
-        vTaskDelay(10 / portTICK_PERIOD_MS);
+        leftBumperPresses++;
     }
+    else if (event.button == InputButton::RightShoulder)
+    {
+        rightBumperPresses++;
+    }
+}
 
-    device->displayObjects.clear();
-    // give other tasks a chance to catch up.
-    vTaskDelay(100 / portTICK_PERIOD_MS);
+// Set once the device has drawn its controls and synced the encoders to its
+// settings; until then the encoder handlers decline their values.
+static std::atomic<bool> controlsReady{false};
 
-    // Clear only the page area, preserving top 30px for status icons
-    if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        tft.fillRect(0, Display::PageY, Display::WIDTH, Display::PageHeight + 32, ST77XX_BLACK);
-        xSemaphoreGive(displayMutex);
+// Latest encoder values not yet handed to the device, LONG_MIN for none.
+// Filled from the input task and applied by the page task, which owns the
+// device's widgets and BLE writes.
+static std::atomic<long> pendingLeftEncoder{LONG_MIN};
+static std::atomic<long> pendingRightEncoder{LONG_MIN};
+
+static bool onControllerLeftEncoder(long value)
+{
+    if (!controlsReady)
+    {
+        return false;
     }
+    setNotIdle("left_encoder");
+    pendingLeftEncoder = value;
+    return true;
+}
 
-    device->drawControls();
+static bool onControllerRightEncoder(long value)
+{
+    if (!controlsReady)
+    {
+        return false;
+    }
+    setNotIdle("right_encoder");
+    pendingRightEncoder = value;
+    return true;
+}
 
-    bool lastLeftShoulderState = HIGH;
-    bool lastRightShoulderState = HIGH;
-    bool currentLeftShoulderState = HIGH;
-    bool currentRightShoulderState = HIGH;
+static const EncoderRoute controllerRoute = {
+    "controller", onControllerLeftEncoder, onControllerRightEncoder};
 
-    int lastLeftEncoderValue = -1;
-    int currentLeftEncoderValue = -1;
+void routeEncodersToController()
+{
+    controlsReady = false;
+    setEncoderRoute(&controllerRoute);
+}
 
-    int lastRightEncoderValue = -1;
-    int currentRightEncoderValue = -1;
+// Per-frame text cost, reported every TEXT_STATS_FRAMES frames
+static constexpr int TEXT_STATS_FRAMES = 120;
+static int textStatsFrames = 0;
+static uint32_t textStatsUs = 0;
+static uint32_t textStatsPeakUs = 0;
+
+// The controls are drawn once the device has been connected for
+// CONTROLS_SETTLE_MS, giving other tasks a chance to catch up. The page keeps
+// ticking meanwhile rather than sleeping with the frame held.
+static constexpr uint32_t CONTROLS_SETTLE_MS = 100;
+static bool controlsDrawn = false;
+static bool connectedSeen = false;
+static TickType_t connectedTick = 0;
+
+static void drawControls()
+{
+    // enterControls left the page area clear; the widgets paint their own
+    // boxes.
+    device->displayObjects.clear();
 
-    auto isInCorrectState = []()
+    TRACE_BEGIN(ControlsDraw, 0);
+    device->drawControls();
+    TRACE_END(ControlsDraw, 0);
+    pendingLeftEncoder = LONG_MIN;
+    pendingRightEncoder = LONG_MIN;
+    controlsReady = true;
+    refreshEncoderRoute();
+
+    // Power-on or wake to first usable controls, mainly to track boot
+    // reconnects.
+    noteInteractive("Controls");
+
+    static bool bumpersSubscribed = false;
+    if (!bumpersSubscribed)
     {
-        return stateMachine->is("device_draw_control"_s);
-    };
+        bumpersSubscribed = subscribeInput(onBumperEvent);
+    }
+    // Presses from before the controls were shown are not meant for them.
+    leftBumperPresses = 0;
+    rightBumperPresses = 0;
+
+    textStatsFrames = 0;
+    textStatsUs = 0;
+    textStatsPeakUs = 0;
+    takeTextStats();
+}
 
-    while (isInCorrectState() && device != nullptr)
+static void enterControls(void *arg)
+{
+    // Coming back from the device menu, which erased only what it drew.
+    if (!previousPageErased())
     {
-        currentLeftShoulderState = digitalRead(pins::BTN_L_SHOULDER);
-        currentRightShoulderState = digitalRead(pins::BTN_R_SHOULDER);
-
-        if (currentLeftShoulderState == LOW && lastLeftShoulderState == HIGH)
-        {
-            device->onLeftBumperClick();
-        }
-        if (currentRightShoulderState == LOW && lastRightShoulderState == HIGH)
-        {
-            device->onRightBumperClick();
-        }
+        clearPage();
+    }
+    ESP_LOGI(TAG, "Showing controls");
+    controlsDrawn = false;
+    connectedSeen = false;
+}
 
+// Reads the global device every frame: disconnecting clears it, and frees
+// the old one between frames.
+static bool tickControls(void *arg)
+{
+    if (!stateMachine->is("device_draw_control"_s) || device == nullptr)
+    {
+        return false;
+    }
 
-        // check if device has persistent left encoder monitoring enabled
-        //  if it does, we do not read the left encoder here, as it is being
-        //  monitored by the leftEncoderMonitor task
-        if (!device->needsPersistentLeftEncoderMonitoring()) {
-            currentLeftEncoderValue = leftEncoder.readEncoder();
-            if (currentLeftEncoderValue != lastLeftEncoderValue) {
-                setNotIdle("left_encoder");
-                device->onLeftEncoderChange(currentLeftEncoderValue);
-                lastLeftEncoderValue = currentLeftEncoderValue;
-            }
+    if (!controlsDrawn)
+    {
+        // wait until the device is connected
+        if (!device->isConnected)
+        {
+            // TODO: UI / UX here.
+            connectedSeen = false;
+            return true;
         }
-
-        currentRightEncoderValue = rightEncoder.readEncoder();
-
-        if (currentRightEncoderValue != lastRightEncoderValue)
+        if (!connectedSeen)
         {
-            setNotIdle("right_encoder");
-            device->onRightEncoderChange(currentRightEncoderValue);
-            lastRightEncoderValue = currentRightEncoderValue;
+            connectedSeen = true;
+            connectedTick = xTaskGetTickCount();
         }
-
-        // Store current states for next iteration
-        lastLeftShoulderState = currentLeftShoulderState;
-        lastRightShoulderState = currentRightShoulderState;
-
-        for (auto &displayObject : device->displayObjects)
+        if (xTaskGetTickCount() - connectedTick <
+            pdMS_TO_TICKS(CONTROLS_SETTLE_MS))
         {
-            displayObject->tick();
-            vTaskDelay(1 / portTICK_PERIOD_MS);
+            return true;
         }
+        drawControls();
+        controlsDrawn = true;
+    }
 
-                vTaskDelay(16 / portTICK_PERIOD_MS); // ~60fps for smooth updating.
+    for (uint8_t n = leftBumperPresses.exchange(0); n > 0; n--)
+    {
+        device->onLeftBumperClick();
+    }
+    for (uint8_t n = rightBumperPresses.exchange(0); n > 0; n--)
+    {
+        device->onRightBumperClick();
+    }
+    long left = pendingLeftEncoder.exchange(LONG_MIN);
+    if (left != LONG_MIN)
+    {
+        device->onLeftEncoderChange(left);
+    }
+    long right = pendingRightEncoder.exchange(LONG_MIN);
+    if (right != LONG_MIN)
+    {
+        device->onRightEncoderChange(right);
+    }
 
+    // The widget tree repaints only the damaged area: changed children, and
+    // the ones they overlap, in z-order, clipped to the damage.
+    device->displayObjects.tick();
+
+    TextStats frameText = takeTextStats();
+    uint32_t frameTextUs = frameText.measureUs + frameText.drawUs;
+    textStatsUs += frameTextUs;
+    textStatsPeakUs = max(textStatsPeakUs, frameTextUs);
+    if (++textStatsFrames >= TEXT_STATS_FRAMES) {
+        ESP_LOGD(TAG, "Text: %lu us/frame avg, %lu us peak over %d frames",
+                 (unsigned long)(textStatsUs / textStatsFrames),
+                 (unsigned long)textStatsPeakUs, textStatsFrames);
+        textStatsFrames = 0;
+        textStatsUs = 0;
+        textStatsPeakUs = 0;
     }
 
-    // unique_ptr will clean up automatically when the device is destroyed or vector cleared
+    return true;
+}
+
+static void exitControls(void *arg)
+{
+    // Erase the widgets' own boxes rather than the whole page, so the next
+    // page (the device menu, say) can draw straight over what is left. A
+    // disconnect has already unhooked the device, leaving its widgets on
+    // screen for the next page to clear.
     if (device != nullptr)
     {
+        bool erased = device->displayObjects.erase();
+        // unique_ptr will clean up automatically when the device is destroyed or vector cleared
         device->displayObjects.clear();
+        if (erased)
+        {
+            notePageErased();
+        }
+    }
+    else if (!controlsDrawn)
+    {
+        notePageErased();
     }
-
-    vTaskDelete(NULL);
 }
+
+// Ticks at ~60fps while in use, slower once the idle monitor dims the screen.
+const PageController controllerPage = {"controls", enterControls,
+                                       tickControls, exitControls};
@@ -4,7 +4,13 @@
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_http_server.h"
+#include "pages/pageHost.h"
 
-void drawControllerTask(void *pvParameters);
+// The connected device's controls. Waits for the connection, then draws them.
+extern const PageController controllerPage;
+
+// Sends both encoders to the connected device's controls. Values are held
+// back until controllerPage has drawn the controls.
+void routeEncodersToController();
 
 #endif
\ No newline at end of file
@@ -5,14 +5,31 @@
 static const int scrollWidth = 6;
 static const int scrollHeight = Display::HEIGHT - Display::StatusbarHeight;
 
-void drawScrollBar(int currentOption, int numOptions) {
+static const int scrollThumbHeight = 20;
+
+// Thumb position last drawn, or -1 when the bar has to be drawn from scratch.
+static int lastScrollPosition = -1;
+
+void drawScrollBar(int currentOption, int numOptions, bool fullRedraw) {
     // Always use direct drawing to avoid memory allocation
     float scrollPercent = (float)currentOption / (numOptions);
-    int scrollPosition = scrollPercent * (scrollHeight - 20);
+    int scrollPosition = scrollPercent * (scrollHeight - scrollThumbHeight);
+
+    if (!fullRedraw && scrollPosition == lastScrollPosition) {
+        return;
+    }
 
     if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-        tft.fillRect(Display::WIDTH - scrollWidth, Display::StatusbarHeight,
-                     scrollWidth, scrollHeight, Colors::black);
+        if (fullRedraw || lastScrollPosition < 0) {
+            tft.fillRect(Display::WIDTH - scrollWidth,
+                         Display::StatusbarHeight, scrollWidth, scrollHeight,
+                         Colors::black);
+        } else {
+            // Only erase the old thumb.
+            tft.fillRect(Display::WIDTH - scrollWidth,
+                         Display::StatusbarHeight + lastScrollPosition,
+                         scrollWidth, scrollThumbHeight, Colors::black);
+        }
 
         // Track
         tft.drawFastVLine(Display::WIDTH - (scrollWidth / 2),
@@ -23,11 +40,19 @@ void drawScrollBar(int currentOption, int numOptions) {
         // Thumb
         tft.fillRoundRect(Display::WIDTH - scrollWidth,
                           Display::StatusbarHeight + scrollPosition,
-                          scrollWidth, 20, 3, Colors::white);
+                          scrollWidth, scrollThumbHeight, 3, Colors::white);
         xSemaphoreGive(displayMutex);
+
+        lastScrollPosition = scrollPosition;
     }
 }
 
+void eraseScrollBar() {
+    tft.fillRect(Display::WIDTH - scrollWidth, Display::StatusbarHeight,
+                 scrollWidth, scrollHeight, Colors::black);
+    lastScrollPosition = -1;
+}
+
 void clearScreen() {
     if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
         tft.fillScreen(Colors::black);
@@ -74,6 +99,9 @@ void wrapText(Adafruit_GFX &gfx, const String &text,
 
     // Helper to measure width of a string
     auto measureWidth = [&](const String &s) -> uint16_t {
+        if (props.font.has_value()) {
+            return measureText(props.font.value(), s.c_str()).width;
+        }
         int16_t x1, y1;
         uint16_t w, h;
         gfx.getTextBounds(s.c_str(), 0, 0, &x1, &y1, &w, &h);
@@ -8,10 +8,15 @@
 #include <algorithm>
 #include <constants/Colors.h>
 #include <constants/Sizes.h>
+#include <optional>
 #include <qrcode.h>
+#include <services/text.h>
 
-// Draw the vertical scrollbar for menus
-void drawScrollBar(int currentOption, int numOptions);
+// Draw the vertical scrollbar for menus. Unless `fullRedraw` is set, only the
+// thumb is moved.
+void drawScrollBar(int currentOption, int numOptions, bool fullRedraw = true);
+// Clears the scrollbar's strip. Call while holding displayMutex.
+void eraseScrollBar();
 void clearPage(bool clearStatusbar = false);
 
 struct DrawQRCodeProps {
@@ -31,6 +36,9 @@ struct WrapTextProps {
     int x = 0;
     int y = 8;
     int rightPadding = 0;
+    // Font currently set on gfx. When known, line widths come from the text
+    // service's run cache instead of getTextBounds.
+    std::optional<TextFont> font;
 };
 
 void wrapText(Adafruit_GFX &gfx, const String &text,
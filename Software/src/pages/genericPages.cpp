@@ -2,44 +2,40 @@
 
 #include <Adafruit_GFX.h>
 #include <Fonts/FreeSans9pt7b.h>
-#include <Fonts/FreeSansBold12pt7b.h>
 #include <components/TextButton.h>
 #include <constants/Colors.h>
 #include <constants/Sizes.h>
 #include <pins.h>
 #include <qrcode.h>
 #include <services/display.h>
+#include <services/text.h>
+#include <services/trace.h>
 
 #include "displayUtils.h"
 
-void drawPageTask(void *pvParameters) {
-    TextPage *params = static_cast<TextPage *>(pvParameters);
+static void enterTextPage(void *arg) {
+    const TextPage *params = static_cast<const TextPage *>(arg);
 
     if (params == nullptr) {
-        vTaskDelete(NULL);
         return;
     }
 
+    TRACE_BEGIN(PageDraw, 0);
     if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
         // Clear the page area first
         clearPage();
 
-        // Draw title with large bold font
-        tft.setFont(&FreeSansBold12pt7b);
-        tft.setTextColor(Colors::white);
-
-        // Get title bounds for centering
-        int16_t titleX1, titleY1;
-        uint16_t titleWidth, titleHeight;
-        tft.getTextBounds(params->title.c_str(), 0, 0, &titleX1, &titleY1,
-                          &titleWidth, &titleHeight);
+        // Draw title with large bold font, measuring for centering
+        TextMetrics titleBounds =
+            measureText(TextFont::SansBold12, params->title.c_str());
+        uint16_t titleHeight = titleBounds.height;
 
         // Center title horizontally
-        int16_t titleX = (Display::WIDTH - titleWidth) / 2;
+        int16_t titleX = (Display::WIDTH - titleBounds.width) / 2;
         int16_t titleY = Display::PageY + Display::Padding::P3 -
-                         titleY1;  // Top padding from page start
-        tft.setCursor(titleX, titleY);
-        tft.print(params->title);
+                         titleBounds.y1;  // Top padding from page start
+        drawText(TextFont::SansBold12, params->title.c_str(), titleX, titleY,
+                 Colors::white, Colors::black);
 
         // Draw description with smaller font and proper text wrapping
         tft.setFont(&FreeSans9pt7b);
@@ -65,7 +61,8 @@ void drawPageTask(void *pvParameters) {
         wrapText(tft, params->description,
                  {.x = textMargin,
                   .y = descY,
-                  .rightPadding = textMargin + qrCodeWidth});
+                  .rightPadding = textMargin + qrCodeWidth,
+                  .font = TextFont::Sans9});
 
         xSemaphoreGive(displayMutex);
     }
@@ -92,13 +89,13 @@ void drawPageTask(void *pvParameters) {
                                Display::WIDTH - 90, buttonY);
         rightButton.tick();
     }
-
-    // Clean up dynamically allocated parameters if they came from
-    // updateStatusText For now, just avoid the delete to prevent crashes -
-    // memory leak is better than crash delete params;
-    vTaskDelete(NULL);
+    TRACE_END(PageDraw, 0);
 }
 
+// Drawn once; the page stays up until the next one replaces it.
+const PageController textPageController = {"text", enterTextPage, nullptr,
+                                           nullptr};
+
 void updateStatusText(const String &statusMessage) {
     // Simple flag to prevent multiple concurrent status updates
     static bool updateInProgress = false;
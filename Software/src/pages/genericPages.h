@@ -4,8 +4,10 @@
 #include "constants/Sizes.h"
 #include "constants/Strings.h"
 #include "pages/TextPages.h"
+#include "pages/pageHost.h"
 
-void drawPageTask(void *pvParameters);
+// Shows the TextPage passed to showPage().
+extern const PageController textPageController;
 void updateStatusText(const String &statusMessage);  // Future plans to expand
                                                      // to include text color.
 
@@ -4,17 +4,24 @@
 #include <devices/device.h>
 #include <services/encoder.h>
 #include <services/coms.h>
+#include <services/input.h>
+#include <services/lastInteraction.h>
+#include <services/trace.h>
 #include <state/remote.h>
 
 #include "displayUtils.h"
+#include "pageHost.h"
 #include "services/display.h"
+#include "services/text.h"
 
-TaskHandle_t menuTaskHandle = NULL;
-static volatile bool menuTaskExitRequested = false;
+#include <esp_timer.h>
 
-std::vector<MenuItem> *activeMenu = &mainMenu;
+#include <atomic>
+
+const MenuItem *activeMenu = mainMenu;
 int activeMenuCount = numMainMenu;
-int currentOption = 0;
+std::atomic<int> currentOption{0};
+std::atomic<int> previousOption{0};
 
 static const int scrollWidth = 6;
 
@@ -25,116 +32,333 @@ static const int menuWidth =
 static const int menuItemHeight = Display::Icons::Small + Display::Padding::P2;
 static const int menuItemDescriptionHeight = menuItemHeight * 1.5;
 
-static int menuYOffset = 0;
+static const int menuX = Display::Padding::P1;
+static const int menuY = Display::StatusbarHeight + Display::Padding::P1;
+static const int maxVisibleRows = 5;
+static const int menuAreaHeight =
+    (maxVisibleRows - 1) * menuItemHeight + menuItemDescriptionHeight;
+
+// Shadow of the menu area in PSRAM. Rows that are still visible after a
+// scroll are moved inside this buffer instead of being re-rendered; boards
+// without PSRAM draw rows straight to the display.
+static GFXcanvas16 *menuCanvas = nullptr;
+
+// A menu row as drawn. Rows are produced on demand for the visible window
+// only, so long or changing lists (e.g. scan results) never have to be
+// materialised as MenuItems.
+struct MenuRow {
+    // Identifies the row's content; rows with the same key look the same.
+    uintptr_t key = 0;
+    const char *name = "";
+    const uint8_t *bitmap = nullptr;
+    const char *description = nullptr;
+    int color = -1;
+    int unfocusedColor = -1;
+};
+
+// Fills `row` for the option at `index`. `nameBuffer` (32 bytes) may be
+// used to hold a name copied from elsewhere.
+typedef void (*MenuRowSource)(int index, MenuRow &row, char *nameBuffer);
+
+static const int rowNameLength = 32;
+
+// What is currently on screen, used to work out which rows changed.
+struct MenuFrame {
+    int count = 0;
+    int windowStart = 0;
+    int selected = -1;
+    int rows = 0;
+    uintptr_t rowKey[maxVisibleRows] = {};
+    bool rowSelected[maxVisibleRows] = {};
+    int rowY[maxVisibleRows] = {};
+    int rowHeight[maxVisibleRows] = {};
+    int height = 0;
+    bool valid = false;
+};
+
+static MenuFrame shownFrame;
+
+// Forces the next drawMenuFrame() to repaint every row.
+static void invalidateMenuFrame() { shownFrame.valid = false; }
+
+static int getRowHeight(const MenuRow &row, bool selected) {
+    return selected && row.description != nullptr ? menuItemDescriptionHeight
+                                                   : menuItemHeight;
+}
 
-static void drawMenuItem(int index, const MenuItem &option,
-                         bool selected = false) {
-    auto text = option.name;
-    auto bitmap = option.bitmap;
+// Draws one row into `gfx`, whose x = 0 sits at `originX` on screen. Row
+// appearance depends only on the row's content and selection state, so a
+// drawn row can be moved to another slot unchanged.
+static void drawMenuItem(Adafruit_GFX &gfx, int originX, int y,
+                         int optionIndex, const MenuRow &option,
+                         bool selected) {
     auto color = option.color > 0 ? option.color : Colors::textForeground;
     auto unfocusedColor = option.unfocusedColor > 0 ? option.unfocusedColor
                                                     : Colors::textBackground;
 
-    int y = Display::StatusbarHeight + Display::Padding::P1 + menuYOffset;
-    int x = Display::Padding::P1;
+    int x = menuX - originX;
+    int height = getRowHeight(option, selected);
 
-    bool shouldDrawDescription = option.description.has_value() && selected;
+    bool shouldDrawDescription = option.description != nullptr && selected;
 
-    if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-        // Clear menu item area
-        tft.fillRect(x, y, menuWidth, menuItemHeight, Colors::black);
+    // Clear menu item area
+    gfx.fillRect(x, y, menuWidth, height, Colors::black);
 
-        if (index > 0) {
-            tft.drawFastHLine(x + Display::Padding::P1, y,
-                              menuWidth - Display::Padding::P2,
-                              Colors::bgGray900);
-        }
+    if (optionIndex > 0) {
+        gfx.drawFastHLine(x + Display::Padding::P1, y,
+                          menuWidth - Display::Padding::P2, Colors::bgGray900);
+    }
 
-        if (selected) {
-            tft.fillRoundRect(x, y, menuWidth,
-                              shouldDrawDescription ? menuItemDescriptionHeight
-                                                    : menuItemHeight,
-                              3, Colors::bgGray900);
-        }
+    if (selected) {
+        gfx.fillRoundRect(x, y, menuWidth, height, 3, Colors::bgGray900);
+    }
 
-        tft.setTextColor(selected ? color : unfocusedColor);
-        tft.setFont(&FreeSans9pt7b);
+    int padding = Display::Padding::P2;
+    int textOffset = 6;
+
+    gfx.drawBitmap(x + padding, y + textOffset, option.bitmap,
+                   Display::Icons::Small, Display::Icons::Small,
+                   selected ? color : unfocusedColor);
+
+    padding += Display::Icons::Small + Display::Padding::P2;
+    drawText(TextFont::Sans9, option.name, x + padding,
+             y + textOffset + menuItemHeight / 2,
+             selected ? color : unfocusedColor,
+             selected ? Colors::bgGray900 : Colors::black, gfx);
+
+    if (shouldDrawDescription) {
+        gfx.setFont();
+        gfx.setTextColor(Colors::textForegroundSecondary);
+
+        // Keep the same right edge on screen whatever the target's width.
+        int rightEdge = Display::WIDTH - Display::Padding::P3 - originX;
+        wrapText(gfx, option.description,
+                 {.x = x + Display::Padding::P2,
+                  .y = y + textOffset + Display::Icons::Small +
+                       Display::Padding::P0,
+                  .rightPadding = gfx.width() - rightEdge});
+    }
+}
 
-        int padding = Display::Padding::P2;
-        int textOffset = 6;
+// Rows of the active MenuItem menu.
+static void menuItemRow(int index, MenuRow &row, char *nameBuffer) {
+    const MenuItem &item = activeMenu[index];
+    row.key = reinterpret_cast<uintptr_t>(&item);
+    row.name = item.name;
+    row.bitmap = item.bitmap;
+    row.description = item.description;
+    row.color = item.color;
+    row.unfocusedColor = item.unfocusedColor;
+}
 
-        tft.drawBitmap(x + padding, y + textOffset, bitmap,
-                       Display::Icons::Small, Display::Icons::Small,
-                       selected ? color : unfocusedColor);
+// Draws the rows of the given source around `selection`. Only rows whose
+// content or selection state changed since the last frame are rendered.
+static void drawMenuFrame(MenuRowSource rowAt, int numOptions,
+                          int selection) {
+    if (numOptions <= 0) {
+        return;
+    }
+
+    // Since wrap-around is disabled, selection should always be within bounds
+    // Just clamp it as a safety measure
+    int safeCurrentOption = constrain(selection, 0, numOptions - 1);
 
-        padding += Display::Icons::Small + Display::Padding::P2;
-        tft.setCursor(x + padding, y + textOffset + menuItemHeight / 2);
-        tft.print(text.c_str());
+    const int rows = min(numOptions, maxVisibleRows);
 
-        if (shouldDrawDescription) {
-            tft.setFont();
-            tft.setTextColor(Colors::textForegroundSecondary);
+    bool canReuse = shownFrame.valid;
 
-            wrapText(tft, option.description.value().c_str(),
-                     {.x = x + Display::Padding::P2,
-                      .y = y + textOffset + Display::Icons::Small +
-                           Display::Padding::P0,
-                      .rightPadding = Display::Padding::P3});
+    // The window only scrolls when the selection leaves it.
+    int windowStart;
+    if (canReuse) {
+        windowStart = shownFrame.windowStart;
+        if (safeCurrentOption < windowStart) {
+            windowStart = safeCurrentOption;
+        } else if (safeCurrentOption >= windowStart + rows) {
+            windowStart = safeCurrentOption - rows + 1;
         }
+        windowStart = constrain(windowStart, 0, numOptions - rows);
+    } else {
+        windowStart = constrain(safeCurrentOption - rows / 2, 0,
+                                numOptions - rows);
+    }
 
-        menuYOffset +=
-            shouldDrawDescription ? menuItemDescriptionHeight : menuItemHeight;
+    // Row views for the visible window only. Only one menu task draws at a
+    // time, so these can live outside the task's stack.
+    static MenuRow visibleRows[maxVisibleRows];
+    static char visibleNames[maxVisibleRows][rowNameLength];
+
+    MenuFrame frame;
+    frame.count = numOptions;
+    frame.windowStart = windowStart;
+    frame.selected = safeCurrentOption;
+    frame.rows = rows;
+    for (int slot = 0; slot < rows; slot++) {
+        int optionIndex = windowStart + slot;
+        visibleRows[slot] = MenuRow();
+        rowAt(optionIndex, visibleRows[slot], visibleNames[slot]);
+        frame.rowKey[slot] = visibleRows[slot].key;
+        frame.rowSelected[slot] = optionIndex == safeCurrentOption;
+        frame.rowY[slot] = frame.height;
+        frame.rowHeight[slot] =
+            getRowHeight(visibleRows[slot], frame.rowSelected[slot]);
+        frame.height += frame.rowHeight[slot];
+    }
 
-        xSemaphoreGive(displayMutex);
+    if (canReuse && frame.count == shownFrame.count &&
+        frame.windowStart == shownFrame.windowStart &&
+        frame.selected == shownFrame.selected && frame.rows == shownFrame.rows &&
+        memcmp(frame.rowKey, shownFrame.rowKey, sizeof(frame.rowKey)) == 0) {
+        return;
     }
-}
 
-void drawMenuFrame() {
-    int numOptions = activeMenuCount;
-    const MenuItem *options = activeMenu->data();
+    if (menuCanvas == nullptr && psramFound()) {
+        menuCanvas = new GFXcanvas16(menuWidth, menuAreaHeight);
+        if (menuCanvas->getBuffer() == nullptr) {
+            delete menuCanvas;
+            menuCanvas = nullptr;
+        }
+    }
 
-    // Since wrap-around is disabled, currentOption should always be within bounds
-    // Just clamp it as a safety measure
-    int safeCurrentOption = currentOption;
-    if (safeCurrentOption < 0) safeCurrentOption = 0;
-    if (safeCurrentOption >= numOptions) safeCurrentOption = numOptions - 1;
+    // Work out, per slot, whether the row already on screen can be kept
+    // (same content and selection state), moved, or has to be drawn.
+    bool redraw[maxVisibleRows];
+    int moveFrom = -1;  // y of the moved block in the shown frame
+    int moveTo = -1;    // y of the moved block in the new frame
+    int moveHeight = 0;
 
-    menuYOffset = 0;
+    for (int slot = 0; slot < rows; slot++) {
+        redraw[slot] = true;
+        if (!canReuse) {
+            continue;
+        }
+
+        int shownSlot = -1;
+        for (int i = 0; i < shownFrame.rows; i++) {
+            if (shownFrame.rowKey[i] == frame.rowKey[slot]) {
+                shownSlot = i;
+                break;
+            }
+        }
+        if (shownSlot < 0 ||
+            shownFrame.rowSelected[shownSlot] != frame.rowSelected[slot]) {
+            continue;
+        }
 
-    menuYOffset = 0;
+        int fromY = shownFrame.rowY[shownSlot];
+        int toY = frame.rowY[slot];
+        if (fromY == toY) {
+            redraw[slot] = false;
+            continue;
+        }
 
-    if (numOptions <= 5) {
-        for (int i = 0; i < numOptions; i++) {
-            const MenuItem &option = options[i];
-            bool isSelected = i == safeCurrentOption;
-            drawMenuItem(i, option, isSelected);
+        // Rows that moved must form one contiguous block shifted by a single
+        // offset to be moved in the shadow buffer.
+        if (menuCanvas == nullptr) {
+            continue;
         }
+        if (moveHeight == 0) {
+            moveFrom = fromY;
+            moveTo = toY;
+            moveHeight = frame.rowHeight[slot];
+            redraw[slot] = false;
+        } else if (fromY - toY == moveFrom - moveTo &&
+                   toY == moveTo + moveHeight) {
+            moveHeight += frame.rowHeight[slot];
+            redraw[slot] = false;
+        }
+    }
+
+    // Damaged span of the menu area, relative to menuY.
+    int dirtyTop = frame.height;
+    int dirtyBottom = 0;
+    auto markDirty = [&](int top, int bottom) {
+        dirtyTop = min(dirtyTop, top);
+        dirtyBottom = max(dirtyBottom, bottom);
+    };
+
+    if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) != pdTRUE) {
         return;
     }
 
-    drawScrollBar(safeCurrentOption, numOptions - 1);
-
-    for (int i = 0; i < 5; i++) {
-        int optionIndex = safeCurrentOption - 2 + i;
-        
-        // Check if this position should show a menu item or be blank
-        if (optionIndex < 0 || optionIndex >= numOptions) {
-            // Draw actual blank area to clear any previous content
-            int y = Display::StatusbarHeight + Display::Padding::P1 + menuYOffset;
-            int x = Display::Padding::P1;
-            
-            if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-                tft.fillRect(x, y, menuWidth, menuItemHeight, Colors::black);
-                xSemaphoreGive(displayMutex);
+    if (menuCanvas != nullptr) {
+        uint16_t *buffer = menuCanvas->getBuffer();
+        if (moveHeight > 0) {
+            memmove(buffer + moveTo * menuWidth, buffer + moveFrom * menuWidth,
+                    moveHeight * menuWidth * sizeof(uint16_t));
+            markDirty(moveTo, moveTo + moveHeight);
+        }
+        for (int slot = 0; slot < rows; slot++) {
+            if (!redraw[slot]) {
+                continue;
             }
-            menuYOffset += menuItemHeight;
-            continue;
+            drawMenuItem(*menuCanvas, menuX, frame.rowY[slot],
+                         windowStart + slot, visibleRows[slot],
+                         frame.rowSelected[slot]);
+            markDirty(frame.rowY[slot],
+                      frame.rowY[slot] + frame.rowHeight[slot]);
         }
+    } else {
+        for (int slot = 0; slot < rows; slot++) {
+            if (!redraw[slot]) {
+                continue;
+            }
+            drawMenuItem(tft, 0, menuY + frame.rowY[slot], windowStart + slot,
+                         visibleRows[slot], frame.rowSelected[slot]);
+        }
+    }
 
-        const MenuItem &option = options[optionIndex];
-        bool isSelected = optionIndex == safeCurrentOption;
-        drawMenuItem(i, option, isSelected);
+    // Clear whatever the previous frame left below the new last row.
+    int previousHeight = canReuse ? shownFrame.height : menuAreaHeight;
+    if (previousHeight > frame.height) {
+        if (menuCanvas != nullptr) {
+            menuCanvas->fillRect(0, frame.height, menuWidth,
+                                 previousHeight - frame.height,
+                                 Colors::black);
+            markDirty(frame.height, previousHeight);
+        } else {
+            tft.fillRect(menuX, menuY + frame.height, menuWidth,
+                         previousHeight - frame.height, Colors::black);
+        }
+    }
+
+    if (menuCanvas != nullptr && dirtyBottom > dirtyTop) {
+        tft.drawRGBBitmap(menuX, menuY + dirtyTop,
+                          menuCanvas->getBuffer() + dirtyTop * menuWidth,
+                          menuWidth, dirtyBottom - dirtyTop);
     }
+
+    xSemaphoreGive(displayMutex);
+
+    if (numOptions > maxVisibleRows) {
+        drawScrollBar(safeCurrentOption, numOptions - 1,
+                      !canReuse || shownFrame.count <= maxVisibleRows);
+    }
+
+    if (canReuse && safeCurrentOption != shownFrame.selected) {
+        ESP_LOGD("MENU", "Notch to pixel: %lld us",
+                 esp_timer_get_time() - getRightEncoderChangedAtUs());
+    }
+
+    shownFrame = frame;
+    shownFrame.valid = true;
+}
+
+// Clears the rows and scrollbar on screen, rather than the whole page.
+// False if the display was busy and nothing was cleared.
+static bool eraseMenuFrame() {
+    if (!shownFrame.valid) {
+        return true;
+    }
+    if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) != pdTRUE) {
+        return false;
+    }
+    tft.fillRect(menuX, menuY, menuWidth, shownFrame.height, Colors::black);
+    if (shownFrame.count > maxVisibleRows) {
+        eraseScrollBar();
+    }
+    xSemaphoreGive(displayMutex);
+    invalidateMenuFrame();
+    return true;
 }
 
 // Global string for dynamic text display - lives at file scope for persistence
@@ -157,263 +381,261 @@ static void createEncoderDisplayObject() {
     }
 }
 
-void drawMenuTask(void *pvParameters) {
-    int lastEncoderValue = -1;
-
-    auto isInCorrectState = []() {
-        return stateMachine->is("main_menu"_s) ||
-               stateMachine->is("settings_menu"_s) ||
-               stateMachine->is("device_menu"_s);
-    };
-
-    auto isInNestedState = []() { return stateMachine->is("device_menu"_s); };
-
-    // Ensure global handle is set for lifecycle coordination
-    menuTaskHandle = xTaskGetCurrentTaskHandle();
+static int lastMenuEncoderValue = -1;
+static int lastLeftEncoderValue = -1;
+static bool isFirstDeviceMenuEntry = true;
+// Left encoder value waiting for the device, LONG_MIN for none. Written by
+// the input task.
+static std::atomic<long> pendingMenuLeftEncoder{LONG_MIN};
+
+static void enterMenu(void *arg) {
+    lastMenuEncoderValue = -1;
+    // The device controls erase their own widgets on the way here.
+    if (!previousPageErased()) {
+        clearPage();
+    }
+    invalidateMenuFrame();
 
     // Mark encoder display as needing creation for device menu
     if (device != nullptr && stateMachine->is("device_menu"_s) &&
         device->needsPersistentLeftEncoderMonitoring()) {
         encoderDisplayNeedsCreation = true;
     }
+}
 
-    // Important!!
-    // Never run setEncoderValue without ensuring you're in the expected
-    // state. Not doing this can cause the device_controller to receive the
-    // update, causing unexpected setting to be sent to the device.
-    bool initialized = false;
-    while (!initialized) {
-        if (isInCorrectState()) {
-            // Disable wrap-around (false) to eliminate the problematic behavior
-            rightEncoder.setBoundaries(0, activeMenuCount - 1, false);
-            rightEncoder.setAcceleration(0);
-            // Ensure currentOption is within bounds for the new menu
-            int boundedCurrentOption = currentOption % activeMenuCount;
-            if (boundedCurrentOption < 0) {
-                boundedCurrentOption += activeMenuCount;
-            }
-            rightEncoder.setEncoderValue(boundedCurrentOption);
-            currentOption = boundedCurrentOption;
-            
-            initialized = true;
-        }
-        vTaskDelay(1);
+static bool tickMenu(void *arg) {
+    bool isInCorrectState = stateMachine->is("main_menu"_s) ||
+                            stateMachine->is("settings_menu"_s) ||
+                            stateMachine->is("device_menu"_s);
+    if (!isInCorrectState) {
+        return false;
     }
 
-    while (isInCorrectState() && !menuTaskExitRequested) {
-        int rawEncoderValue = rightEncoder.readEncoder();
-        currentOption = rawEncoderValue;
+    auto isInNestedState = []() { return stateMachine->is("device_menu"_s); };
 
-        // Check if we need to update left encoder persistent display for
-        // devices with persistent encoder monitoring
-        static int lastLeftEncoderValue = -1;
-        static bool isFirstDeviceMenuEntry = true;
-        bool shouldUpdateLeftEncoderValue = false;
-        int currentLeftEncoderValue = 0;
+    long pendingLeft = pendingMenuLeftEncoder.exchange(LONG_MIN);
+    if (pendingLeft != LONG_MIN && isInNestedState() && device != nullptr) {
+        device->onLeftEncoderChange(pendingLeft);
+    }
 
-        if (isInNestedState() && device != nullptr &&
-            device->needsPersistentLeftEncoderMonitoring()) {
-            currentLeftEncoderValue = device->getCurrentLeftEncoderValue();
+    // Check if we need to update left encoder persistent display for
+    // devices with persistent encoder monitoring
+    bool shouldUpdateLeftEncoderValue = false;
+    int currentLeftEncoderValue = 0;
 
-            // Create display object on first entry
-            createEncoderDisplayObject();
+    if (isInNestedState() && device != nullptr &&
+        device->needsPersistentLeftEncoderMonitoring()) {
+        currentLeftEncoderValue = device->getCurrentLeftEncoderValue();
 
-            // Force display on first entry or when left encoder value changes
-            if (isFirstDeviceMenuEntry ||
-                currentLeftEncoderValue != lastLeftEncoderValue) {
-                lastLeftEncoderValue = currentLeftEncoderValue;
-                shouldUpdateLeftEncoderValue = true;
-                isFirstDeviceMenuEntry = false;
-            }
-        } else {
-            // Reset flag when not in device menu
-            isFirstDeviceMenuEntry = true;
-        }
+        // Create display object on first entry
+        createEncoderDisplayObject();
 
-        if (lastEncoderValue == currentOption &&
-            !shouldUpdateLeftEncoderValue) {
-            // No changes needed, just tick display objects
-        } else {
-            if (lastEncoderValue != currentOption) {
-                lastEncoderValue = currentOption;
-                drawMenuFrame();
-            }
+        // Force display on first entry or when left encoder value changes
+        if (isFirstDeviceMenuEntry ||
+            currentLeftEncoderValue != lastLeftEncoderValue) {
+            lastLeftEncoderValue = currentLeftEncoderValue;
+            shouldUpdateLeftEncoderValue = true;
+            isFirstDeviceMenuEntry = false;
+        }
+    } else {
+        // Reset flag when not in device menu
+        isFirstDeviceMenuEntry = true;
+    }
 
-            if (shouldUpdateLeftEncoderValue) {
-                updateLeftEncoderValue(device->getLeftEncoderParameterName(),
-                                       currentLeftEncoderValue);
-            }
+    // One read, so the row drawn is the one compared.
+    int option = currentOption;
+    if (lastMenuEncoderValue == option && !shouldUpdateLeftEncoderValue) {
+        // No changes needed, just tick display objects
+    } else {
+        if (lastMenuEncoderValue != option) {
+            TRACE_SCOPE(MenuDraw, option);
+            lastMenuEncoderValue = option;
+            drawMenuFrame(menuItemRow, activeMenuCount, option);
         }
 
-        // Tick all display objects
-        if (device != nullptr) {
-            for (auto &displayObject : device->displayObjects) {
-                displayObject->tick();
-            }
+        if (shouldUpdateLeftEncoderValue) {
+            updateLeftEncoderValue(device->getLeftEncoderParameterName(),
+                                   currentLeftEncoderValue);
         }
+    }
 
-        vTaskDelay(16 / portTICK_PERIOD_MS);
+    // Tick all display objects
+    if (device != nullptr) {
+        device->displayObjects.tick();
     }
+    return true;
+}
 
-    // Mark as finished before self-delete so creator can proceed safely
-    menuTaskHandle = NULL;
-    vTaskDelete(NULL);
+// Erases what the menu drew, so the page shown next can skip clearing the
+// whole page.
+static void exitMenu(void *arg) {
+    bool erased = eraseMenuFrame();
+    if (device != nullptr) {
+        erased &= device->displayObjects.erase();
+        device->displayObjects.clear();
+    } else if (!encoderDisplayNeedsCreation) {
+        // The device went with its encoder display still on screen.
+        erased = false;
+    }
+    encoderDisplayNeedsCreation = true;
+    if (erased) {
+        notePageErased();
+    }
 }
 
-void drawMenu() {
-    // If an existing task is running, request cooperative exit and wait
-    if (menuTaskHandle != NULL) {
-        menuTaskExitRequested = true;
-        // Reduced timeout for faster transitions
-        const TickType_t waitStart = xTaskGetTickCount();
-        const TickType_t waitTimeout =
-            pdMS_TO_TICKS(50);  // Reduced from 200ms to 50ms
-        while (menuTaskHandle != NULL &&
-               (xTaskGetTickCount() - waitStart) < waitTimeout) {
-            vTaskDelay(1);
-        }
-        // If still not null after timeout, force cleanup
-        if (menuTaskHandle != NULL) {
-            vTaskSuspend(menuTaskHandle);
-            vTaskDelete(menuTaskHandle);
-            menuTaskHandle = NULL;
-        }
+static const PageController menuPage = {"menu", enterMenu, tickMenu,
+                                        exitMenu};
+
+static bool onMenuRightEncoder(long value) {
+    int option = static_cast<int>(value);
+    int previous = currentOption.exchange(option);
+    if (previous != option) {
+        previousOption = previous;
     }
+    return true;
+}
+
+// Devices with persistent left encoder monitoring keep speed on the left
+// knob while their menu is open. The value is handed to tickMenu, which
+// applies it on the page task.
+static bool onDeviceMenuLeftEncoder(long value) {
+    setNotIdle("left_encoder");
+    pendingMenuLeftEncoder = value;
+    return true;
+}
 
-    // Reset exit flag before creating a new task
-    menuTaskExitRequested = false;
+static const EncoderRoute menuRoute = {"menu", nullptr, onMenuRightEncoder};
+static const EncoderRoute persistentDeviceMenuRoute = {
+    "device_menu", onDeviceMenuLeftEncoder, onMenuRightEncoder};
 
+void drawMenu() {
     ESP_LOGD("MENU", "Drawing menu");
 
-    clearPage();
-    // Reduced delay for faster startup
-    vTaskDelay(10 / portTICK_PERIOD_MS);  // Reduced from 50ms to 10ms
-    xTaskCreatePinnedToCore(drawMenuTask, "drawMenuTask",
-                            5 * configMINIMAL_STACK_SIZE, NULL, 5,
-                            &menuTaskHandle, 1);
+    // This runs from the menu state's entry action, after the previous
+    // state's route was dropped, so no other consumer sees the encoder
+    // being reset here.
+    // Disable wrap-around (false) to eliminate the problematic behavior
+    rightEncoder.setBoundaries(0, activeMenuCount - 1, false);
+    rightEncoder.setAcceleration(0);
+    // Ensure currentOption is within bounds for the new menu
+    int boundedCurrentOption = currentOption.load() % activeMenuCount;
+    if (boundedCurrentOption < 0) {
+        boundedCurrentOption += activeMenuCount;
+    }
+    rightEncoder.setEncoderValue(boundedCurrentOption);
+    currentOption = boundedCurrentOption;
+
+    bool persistentLeftEncoder = device != nullptr &&
+                                 stateMachine->is("device_menu"_s) &&
+                                 device->needsPersistentLeftEncoderMonitoring();
+    pendingMenuLeftEncoder = LONG_MIN;
+    setEncoderRoute(persistentLeftEncoder ? &persistentDeviceMenuRoute
+                                          : &menuRoute);
+
+    showPage(menuPage);
 }
 
-// Device list management
-static std::vector<MenuItem> deviceListMenu;
-static int deviceListCount = 0;
-TaskHandle_t deviceListTaskHandle = NULL;
-static volatile bool deviceListTaskExitRequested = false;
+// Rows of the device list, read straight from the scan's device table.
+static void deviceListRow(int index, MenuRow &row, char *nameBuffer) {
+    DiscoveredDevice dev;
+    row.bitmap = bitmap_ble_connect;
+
+    if (!getDiscoveredDevice(index, dev)) {
+        // Shown when the scan finished without finding anything.
+        row.key = UINTPTR_MAX;
+        row.name = "No devices found";
+        row.color = Colors::textForegroundSecondary;
+        row.unfocusedColor = Colors::textForegroundSecondary;
+        return;
+    }
 
-void buildDeviceListMenu() {
-    deviceListMenu.clear();
-    
-    auto& devices = getDiscoveredDevices();
-    
-    if (devices.empty()) {
-        // Add a "No devices found" placeholder
-        deviceListMenu.push_back({
-            MenuItemE::DEVICE_MENU_ITEM,
-            "No devices found",
-            bitmap_ble_connect,
-            std::nullopt,
-            Colors::textForegroundSecondary,
-            Colors::textForegroundSecondary,
-            -1
-        });
-    } else {
-        for (size_t i = 0; i < devices.size(); i++) {
-            std::string displayName = devices[i].name;
-            if (displayName.empty()) {
-                displayName = "Unknown Device";
-            }
-            
-            // Add RSSI indicator
-            // displayName += " (" + std::to_string(devices[i].rssi) + " dBm)";
-            
-            deviceListMenu.push_back({
-                MenuItemE::DEVICE_MENU_ITEM,
-                displayName,
-                bitmap_ble_connect,
-                std::nullopt,
-                Colors::textForeground,
-                Colors::textBackground,
-                static_cast<int>(i)
-            });
-        }
+    strlcpy(nameBuffer, dev.name[0] != '\0' ? dev.name : "Unknown Device",
+            rowNameLength);
+    row.name = nameBuffer;
+    row.color = Colors::textForeground;
+    row.unfocusedColor = Colors::textBackground;
+
+    // The name can arrive after the device is listed, so it is part of the
+    // row's identity.
+    uintptr_t key = 2166136261u ^ dev.id;
+    for (const char *c = nameBuffer; *c != '\0'; c++) {
+        key = (key ^ static_cast<uint8_t>(*c)) * 16777619u;
     }
-    
-    deviceListCount = deviceListMenu.size();
+    row.key = key;
 }
 
-void drawDeviceListTask(void *pvParameters) {
-    int lastEncoderValue = -1;
-    
-    auto isInCorrectState = []() {
-        return stateMachine->is("device_list"_s);
-    };
-    
-    deviceListTaskHandle = xTaskGetCurrentTaskHandle();
-    
-    bool initialized = false;
-    while (!initialized) {
-        if (isInCorrectState()) {
-            rightEncoder.setBoundaries(0, deviceListCount - 1, false);
-            rightEncoder.setAcceleration(0);
-            rightEncoder.setEncoderValue(0);
-            currentOption = 0;
-            initialized = true;
+static int lastListEncoderValue = -1;
+static uint32_t shownVersion = 0;
+static int rowCount = 0;
+// Keeps the highlighted device selected when the list re-sorts.
+static int selectedId = -1;
+
+static void enterDeviceList(void *arg) {
+    lastListEncoderValue = -1;
+    shownVersion = getDiscoveredDevicesVersion() - 1;
+    rowCount = 0;
+    selectedId = -1;
+    clearPage();
+    invalidateMenuFrame();
+}
+
+static bool tickDeviceList(void *arg) {
+    if (!stateMachine->is("device_list"_s)) {
+        return false;
+    }
+
+    bool listChanged = false;
+    uint32_t version = getDiscoveredDevicesVersion();
+    if (version != shownVersion) {
+        shownVersion = version;
+        listChanged = true;
+
+        // At least one row, for the "No devices found" placeholder.
+        rowCount = max(getDiscoveredDeviceCount(), 1);
+        rightEncoder.setBoundaries(0, rowCount - 1, false);
+
+        int selectedIndex =
+            selectedId >= 0 ? findDiscoveredDevice(selectedId) : -1;
+        if (selectedIndex >= 0 && selectedIndex != currentOption) {
+            rightEncoder.setEncoderValue(selectedIndex);
+            currentOption = selectedIndex;
+        } else {
+            currentOption = constrain(currentOption.load(), 0, rowCount - 1);
         }
-        vTaskDelay(1);
+        // Hand the adjusted value back through the route.
+        refreshEncoderRoute();
     }
-    
-    while (isInCorrectState() && !deviceListTaskExitRequested) {
-        int rawEncoderValue = rightEncoder.readEncoder();
-        currentOption = rawEncoderValue;
-        
-        if (lastEncoderValue != currentOption) {
-            lastEncoderValue = currentOption;
-            
-            // Redraw menu with updated selection
-            activeMenu = &deviceListMenu;
-            activeMenuCount = deviceListCount;
-            drawMenuFrame();
+
+    // One read, so the device selected is the row drawn.
+    int option = currentOption;
+    if (lastListEncoderValue != option || listChanged) {
+        lastListEncoderValue = option;
+
+        DiscoveredDevice dev;
+        if (getDiscoveredDevice(option, dev)) {
+            selectedId = dev.id;
         }
-        
-        vTaskDelay(16 / portTICK_PERIOD_MS);
+
+        // Redraw menu with updated selection
+        drawMenuFrame(deviceListRow, rowCount, option);
     }
-    
-    deviceListTaskHandle = NULL;
-    vTaskDelete(NULL);
+    return true;
 }
 
+static const PageController deviceListPage = {"device_list", enterDeviceList,
+                                              tickDeviceList, nullptr};
+
+static const EncoderRoute deviceListRoute = {"device_list", nullptr,
+                                             onMenuRightEncoder};
+
 void drawDeviceListMenu() {
-    // Stop any existing device list task
-    if (deviceListTaskHandle != NULL) {
-        deviceListTaskExitRequested = true;
-        const TickType_t waitStart = xTaskGetTickCount();
-        const TickType_t waitTimeout = pdMS_TO_TICKS(50);
-        while (deviceListTaskHandle != NULL &&
-               (xTaskGetTickCount() - waitStart) < waitTimeout) {
-            vTaskDelay(1);
-        }
-        if (deviceListTaskHandle != NULL) {
-            vTaskSuspend(deviceListTaskHandle);
-            vTaskDelete(deviceListTaskHandle);
-            deviceListTaskHandle = NULL;
-        }
-    }
-    
-    deviceListTaskExitRequested = false;
-    
     ESP_LOGD("DEVICE_LIST", "Drawing device list");
     
-    // Build the menu from discovered devices
-    buildDeviceListMenu();
-    
-    // Set active menu
-    activeMenu = &deviceListMenu;
-    activeMenuCount = deviceListCount;
+    rightEncoder.setAcceleration(0);
+    rightEncoder.setBoundaries(0, 0, false);
+    rightEncoder.setEncoderValue(0);
     currentOption = 0;
-    
-    clearPage();
-    vTaskDelay(10 / portTICK_PERIOD_MS);
-    
-    xTaskCreatePinnedToCore(drawDeviceListTask, "drawDeviceListTask",
-                            5 * configMINIMAL_STACK_SIZE, NULL, 5,
-                            &deviceListTaskHandle, 1);
-}
\ No newline at end of file
+    setEncoderRoute(&deviceListRoute);
+
+    showPage(deviceListPage);
+}
@@ -11,11 +11,17 @@
 #include <Fonts/FreeSans9pt7b.h>
 #include "services/display.h"
 
-extern std::vector<MenuItem> *activeMenu;
-extern int activeMenuCount;
-extern int currentOption;
+#include <atomic>
 
-extern TaskHandle_t menuTaskHandle;
+// Items of the menu on screen; a built-in table or a device's menu.
+extern const MenuItem *activeMenu;
+extern int activeMenuCount;
+// The highlighted option. Written by the encoder route on the input task, read
+// by the page task and the event dispatcher; load it once per use.
+extern std::atomic<int> currentOption;
+// The option highlighted before currentOption, e.g. to wake on it rather than
+// on the Sleep item.
+extern std::atomic<int> previousOption;
 
 void drawMenu();
 void drawDeviceListMenu();
@@ -0,0 +1,148 @@
+#include "pageHost.h"
+
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include "esp_log.h"
+#include "services/power.h"
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "PAGE_HOST";
+
+// Statistics are logged after this many transitions.
+static const uint32_t STATS_EVERY = 32;
+
+struct PageRequest {
+    const PageController *page;
+    void *arg;
+    uint32_t requestedUs;
+};
+
+// Holds at most the latest request; a newer one replaces it.
+static QueueHandle_t pageMailbox = NULL;
+// Held by the render task while it runs a hook.
+static SemaphoreHandle_t frameMutex = NULL;
+
+static StaticQueue<PageRequest, 1> pageMailboxMemory;
+static StaticMutex frameMutexMemory;
+// Sized for the device controls, the deepest page.
+static StaticTask<16 * configMINIMAL_STACK_SIZE> pageHostTaskMemory;
+
+// Set by notePageErased(), cleared once the next page has entered. Only
+// touched with frameMutex held.
+static bool pageErased = false;
+
+static portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;
+static PageHostStats stats = {};
+
+static uint32_t nowUs() { return (uint32_t)esp_timer_get_time(); }
+
+static uint8_t heapFragmentation() {
+    const uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    size_t freeBytes = heap_caps_get_free_size(caps);
+    if (freeBytes == 0) {
+        return 100;
+    }
+    size_t largest = heap_caps_get_largest_free_block(caps);
+    return (uint8_t)(100 - (100 * largest) / freeBytes);
+}
+
+static void recordTransition(const PageRequest &request) {
+    uint32_t transitionUs = nowUs() - request.requestedUs;
+    uint8_t fragmentation = heapFragmentation();
+
+    portENTER_CRITICAL(&statsLock);
+    stats.transitions++;
+    stats.lastTransitionUs = transitionUs;
+    stats.maxTransitionUs = max(stats.maxTransitionUs, transitionUs);
+    stats.totalTransitionUs += transitionUs;
+    stats.fragmentation = fragmentation;
+    stats.maxFragmentation = max(stats.maxFragmentation, fragmentation);
+    PageHostStats copy = stats;
+    portEXIT_CRITICAL(&statsLock);
+
+    ESP_LOGV(TAG, "%s in %lu us", request.page->name,
+             (unsigned long)transitionUs);
+    if (copy.transitions % STATS_EVERY == 0) {
+        ESP_LOGD(TAG,
+                 "%lu transitions: %lu us avg, %lu us max; fragmentation "
+                 "%u%% (worst %u%%)",
+                 (unsigned long)copy.transitions,
+                 (unsigned long)(copy.totalTransitionUs / copy.transitions),
+                 (unsigned long)copy.maxTransitionUs, copy.fragmentation,
+                 copy.maxFragmentation);
+    }
+}
+
+static void pageHostTask(void *pvParameters) {
+    const PageController *page = nullptr;
+    void *arg = nullptr;
+    PageRequest request;
+
+    while (true) {
+        // Idle until the next page; otherwise the mailbox wait is the frame
+        // delay, so a switch does not wait out the rest of a frame.
+        TickType_t wait =
+            page != nullptr ? powerPeriod(PowerLoop::Render) : portMAX_DELAY;
+        bool switched = xQueueReceive(pageMailbox, &request, wait) == pdTRUE;
+
+        xSemaphoreTakeRecursive(frameMutex, portMAX_DELAY);
+        if (switched) {
+            if (page != nullptr && page->exit != nullptr) {
+                page->exit(arg);
+            }
+            page = request.page;
+            arg = request.arg;
+            if (page->enter != nullptr) {
+                page->enter(arg);
+            }
+            pageErased = false;
+        }
+        if (page != nullptr && (page->tick == nullptr || !page->tick(arg))) {
+            if (page->exit != nullptr) {
+                page->exit(arg);
+            }
+            page = nullptr;
+        }
+        xSemaphoreGiveRecursive(frameMutex);
+
+        if (switched) {
+            recordTransition(request);
+        }
+    }
+}
+
+void initPageHost() {
+    pageMailbox = pageMailboxMemory.create();
+    frameMutex = frameMutexMemory.createRecursive();
+    pageHostTaskMemory.start(pageHostTask, "pageHost", NULL, 5, 1);
+}
+
+void showPage(const PageController &page, void *arg) {
+    PageRequest request = {&page, arg, nowUs()};
+    xQueueOverwrite(pageMailbox, &request);
+}
+
+void runBetweenFrames(void (*job)(void *arg), void *arg) {
+    if (frameMutex == NULL) {
+        job(arg);
+        return;
+    }
+    xSemaphoreTakeRecursive(frameMutex, portMAX_DELAY);
+    pageErased = false;
+    job(arg);
+    xSemaphoreGiveRecursive(frameMutex);
+}
+
+void notePageErased() { pageErased = true; }
+
+bool previousPageErased() { return pageErased; }
+
+PageHostStats getPageHostStats() {
+    portENTER_CRITICAL(&statsLock);
+    PageHostStats copy = stats;
+    portEXIT_CRITICAL(&statsLock);
+    return copy;
+}
@@ -0,0 +1,63 @@
+#ifndef PAGE_HOST_H
+#define PAGE_HOST_H
+
+#include <Arduino.h>
+
+/**
+ * One long-lived render task shows every page. A page is a PageController;
+ * state machine actions switch pages with showPage(), which only leaves a
+ * message for the task, so no task is created or deleted per screen and
+ * a page is never cut off while it holds the display.
+ *
+ * On a switch the task runs the old page's exit, then the new page's enter,
+ * then calls tick once a render period until the page returns false or the
+ * next page arrives. If several pages are requested within one frame only
+ * the last is shown.
+ */
+struct PageController {
+    const char *name;
+    // Draws the page. Optional.
+    void (*enter)(void *arg);
+    // One frame. Returning false ends the page: exit runs and nothing is
+    // ticked until the next showPage(). Optional; without it the page ends
+    // after enter.
+    bool (*tick)(void *arg);
+    // Runs before the next page's enter, or when tick returns false.
+    // Optional.
+    void (*exit)(void *arg);
+};
+
+struct PageHostStats {
+    uint32_t transitions;
+    // From showPage() to the new page's enter returning.
+    uint32_t lastTransitionUs;
+    uint32_t maxTransitionUs;
+    uint32_t totalTransitionUs;
+    // 100 - 100 * largest free block / free internal heap, after the last
+    // transition and the worst seen. 0 is one unbroken free block.
+    uint8_t fragmentation;
+    uint8_t maxFragmentation;
+};
+
+// Starts the render task.
+void initPageHost();
+
+// Shows `page` in place of the current one. `arg` is passed to its hooks
+// and must stay valid until the page ends.
+void showPage(const PageController &page, void *arg = nullptr);
+
+// Runs `job` between frames, so it never overlaps a page's hooks. Use it to
+// free things a page may be drawing, or to draw outside a page.
+void runBetweenFrames(void (*job)(void *arg), void *arg);
+
+// For a page's exit: it has erased everything it drew, so the next page
+// need not clear the page area first.
+void notePageErased();
+
+// For a page's enter: whether the page before it erased itself. A job run
+// between frames since then may have drawn, so it counts as not erased.
+bool previousPageErased();
+
+PageHostStats getPageHostStats();
+
+#endif  // PAGE_HOST_H
@@ -1,23 +1,153 @@
 #include "battery.h"
 
-#include "CircularBuffer.hpp"
+#include <NimBLEDevice.h>
+#include <esp_attr.h>
+
+#include <atomic>
+
 #include "esp_log.h"
+#include "services/display.h"
+#include "services/leds.h"
+#include "utils/StaticRtos.h"
 
 static const char *TAG = "Battery";
 
+// How often the gauge is read. It updates SOC about once a second, but the
+// trend only needs a reading every few seconds.
+static const uint32_t SAMPLE_PERIOD_MS = 10 * 1000;
+
+// Rough current draw of each consumer, for attributing drain. Ballpark
+// figures from the parts' datasheets; good enough to compare consumers, not
+// to predict runtime on their own.
+static const float BASE_MA = 45.0f;           // ESP32-S3 awake, radio idle
+static const float SCREEN_FULL_MA = 35.0f;    // backlight at full brightness
+static const float BLE_SCANNING_MA = 20.0f;   // active scan
+static const float BLE_CONNECTED_MA = 8.0f;   // per connection
+static const float LEDS_FULL_MA = 150.0f;     // every LED full white
+
 // Initialize the global service instance
 Adafruit_MAX17048 batteryService;
 
-// Initialize battery status variables
+// Survives deep sleep, so the history spans sleep cycles. Power-on clears
+// it.
+RTC_DATA_ATTR static BatteryHistory history;
+
+// Owned by batteryTask; history and everything read from other tasks goes
+// through batteryMux.
+static BatteryEstimator estimator;
+static DrainAttribution drain;
+static portMUX_TYPE batteryMux = portMUX_INITIALIZER_UNLOCKED;
+static BatteryTelemetry telemetry = {};
+static BatteryDrain lastDrain = {};
+static std::atomic<bool> gaugeAvailable{false};
+
+static const char *const CONSUMER_NAMES[] = {"base", "screen", "ble", "leds"};
+static_assert(sizeof(CONSUMER_NAMES) / sizeof(CONSUMER_NAMES[0]) ==
+                  static_cast<size_t>(PowerConsumer::COUNT),
+              "CONSUMER_NAMES must match PowerConsumer");
+
+static void estimateCurrents(
+    float (&milliamps)[static_cast<size_t>(PowerConsumer::COUNT)]) {
+    milliamps[static_cast<size_t>(PowerConsumer::Base)] = BASE_MA;
+    milliamps[static_cast<size_t>(PowerConsumer::Screen)] =
+        SCREEN_FULL_MA * getScreenBrightness() / 255.0f;
+
+    float ble = 0.0f;
+    if (NimBLEDevice::isInitialized()) {
+        if (NimBLEDevice::getScan()->isScanning()) {
+            ble += BLE_SCANNING_MA;
+        }
+        ble += BLE_CONNECTED_MA * NimBLEDevice::getConnectedClients().size();
+    }
+    milliamps[static_cast<size_t>(PowerConsumer::Ble)] = ble;
+    milliamps[static_cast<size_t>(PowerConsumer::Leds)] =
+        LEDS_FULL_MA * getLedLoad() / 255.0f;
+}
+
+static void sampleBattery() {
+    BatterySample sample;
+    sample.timeMs = millis();
+    sample.percent = batteryService.cellPercent();
+    sample.voltage = batteryService.cellVoltage();
+    sample.chipRatePercentPerHour = batteryService.chargeRate();
+
+    bool first = !estimator.valid();
+    estimator.add(sample);
+
+    // Currents are sampled at the end of each period and charged for all of
+    // it; consumers change slowly compared to the period.
+    float milliamps[static_cast<size_t>(PowerConsumer::COUNT)];
+    estimateCurrents(milliamps);
+    if (first) {
+        drain.start(sample.percent, sample.timeMs);
+    } else {
+        drain.accumulate(milliamps, sample.timeMs);
+    }
+
+    BatteryTelemetry latest;
+    latest.percent = static_cast<uint8_t>(
+        constrain(sample.percent, 0.0f, 100.0f));
+    latest.voltage = sample.voltage;
+    latest.chipRatePercentPerHour = sample.chipRatePercentPerHour;
+    latest.ratePercentPerHour = estimator.ratePercentPerHour();
+    latest.minutesToEmpty = estimator.minutesToEmpty();
+    latest.charging = estimator.isCharging();
+
+    BatteryDrain latestDrain;
+    latestDrain.sessionMs = drain.sessionMs();
+    latestDrain.totalPercent = drain.drainedPercent(sample.percent);
+    for (size_t i = 0; i < static_cast<size_t>(PowerConsumer::COUNT); i++) {
+        latestDrain.consumerPercent[i] = drain.drainedPercent(
+            static_cast<PowerConsumer>(i), sample.percent);
+    }
+
+    portENTER_CRITICAL(&batteryMux);
+    history.add(sample.percent, sample.voltage);
+    telemetry = latest;
+    lastDrain = latestDrain;
+    portEXIT_CRITICAL(&batteryMux);
+
+    // One line per sample, in a form that can be replayed through
+    // BatteryEstimator off-device.
+    ESP_LOGD(TAG, "sample t=%lu soc=%.3f v=%.3f crate=%.2f -> %.2f%%/h tte=%.0fm",
+             (unsigned long)sample.timeMs, sample.percent, sample.voltage,
+             sample.chipRatePercentPerHour, latest.ratePercentPerHour,
+             latest.minutesToEmpty);
+}
+
+static void batteryTask(void *pvParameters) {
+    TickType_t lastWake = xTaskGetTickCount();
+    while (true) {
+        sampleBattery();
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(SAMPLE_PERIOD_MS));
+    }
+}
+
+uint8_t getBatteryPercent() { return getBatteryTelemetry().percent; }
 
-CircularBuffer<float, 10> voltageBuffer;
-uint8_t voltBatteryPercent = 0;
-float voltBatteryVoltage = 0.0;
-float lastChargeRate = 0.0;
+float getBatteryVoltage() { return getBatteryTelemetry().voltage; }
 
-uint8_t getBatteryPercent() { return voltBatteryPercent; }
+BatteryTelemetry getBatteryTelemetry() {
+    portENTER_CRITICAL(&batteryMux);
+    BatteryTelemetry result = telemetry;
+    portEXIT_CRITICAL(&batteryMux);
+    return result;
+}
 
-float getBatteryVoltage() { return voltBatteryVoltage; }
+BatteryDrain getBatteryDrain() {
+    portENTER_CRITICAL(&batteryMux);
+    BatteryDrain result = lastDrain;
+    portEXIT_CRITICAL(&batteryMux);
+    return result;
+}
+
+size_t getBatteryHistory(size_t level, BatteryHistory::Entry *out,
+                         size_t max) {
+    portENTER_CRITICAL(&batteryMux);
+    size_t count = history.read(level, out, max);
+    portEXIT_CRITICAL(&batteryMux);
+    return count;
+}
 
 bool initBattery() {
     // Initialize the MAX17048 service
@@ -25,99 +155,62 @@ bool initBattery() {
         ESP_LOGE(TAG, "Failed to initialize MAX17048 battery service!");
         return false;
     }
+
+    gaugeAvailable = true;
+    static StaticTask<4 * configMINIMAL_STACK_SIZE> batteryTaskMemory;
+    batteryTaskMemory.start(batteryTask, "batteryTask", nullptr, 1, 0);
     return true;
 }
 
+bool isBatteryGaugeAvailable() { return gaugeAvailable; }
+
 bool isCharging() {
-    return false;  // Disable charging detection.
-
-    // The improved logic below fixes false positives while discharging, but
-    // still gives false negatives when actually charging when at high battery
-    // percent.
-    // We have a hardware LED for charge status, so this is redundant anyway.
-
-    // If the buffer is not full, can't determine slope
-    if (!voltageBuffer.isFull()) return false;
-
-    // Compute the slope of the voltage over the buffer
-    float sumX = 0.0f, sumY = 0.0f, sumXY = 0.0f, sumXX = 0.0f;
-    int n = voltageBuffer.size();
-
-    // Log all voltage readings for debugging
-    ESP_LOGD(TAG, "Voltage buffer contents (size: %d):", n);
-    for (int i = 0; i < n; ++i) {
-        float x = (float)i;
-        float y = voltageBuffer[i];
-        sumX += x;
-        sumY += y;
-        sumXY += x * y;
-        sumXX += x * x;
-        ESP_LOGD(TAG, "  [%d]: %.3fV", i, y);
-    }
+    // We have a hardware LED for charge status, so this only drives the
+    // icon. Near full the current tapers off and this reads as not charging.
+    return getBatteryTelemetry().charging;
+}
 
-    float denominator = n * sumXX - sumX * sumX;
-    float slope = 0.0f;
-    if (denominator != 0.0f) {
-        slope = (n * sumXY - sumX * sumY) / denominator;
-    } else {
-        ESP_LOGW(TAG,
-                 "isCharging: Denominator is zero, cannot calculate slope");
-        return false;
+void printBatteryReport() {
+    if (!gaugeAvailable) {
+        ESP_LOGI(TAG, "No fuel gauge; battery level unknown");
+        return;
     }
 
-    // Calculate additional metrics for better analysis
-    float minVoltage = voltageBuffer[0];
-    float maxVoltage = voltageBuffer[0];
-    float avgVoltage = sumY / n;
-
-    for (int i = 1; i < n; ++i) {
-        if (voltageBuffer[i] < minVoltage) minVoltage = voltageBuffer[i];
-        if (voltageBuffer[i] > maxVoltage) maxVoltage = voltageBuffer[i];
+    BatteryTelemetry now = getBatteryTelemetry();
+    ESP_LOGI(TAG,
+             "%u%% %.3f V, %.2f %%/h (gauge %.2f %%/h), %s, %.0f min to empty",
+             (unsigned)now.percent, now.voltage, now.ratePercentPerHour,
+             now.chipRatePercentPerHour,
+             now.charging ? "charging" : "discharging", now.minutesToEmpty);
+
+    BatteryDrain session = getBatteryDrain();
+    ESP_LOGI(TAG, "Session %lu min: %.2f points drained",
+             (unsigned long)(session.sessionMs / 60000), session.totalPercent);
+    for (size_t i = 0; i < static_cast<size_t>(PowerConsumer::COUNT); i++) {
+        ESP_LOGI(TAG, "  %-7s %.2f points", CONSUMER_NAMES[i],
+                 session.consumerPercent[i]);
     }
 
-    float voltageRange = maxVoltage - minVoltage;
-
-    // Define thresholds for charging detection
-    const float CHARGING_SLOPE_THRESHOLD =
-        0.001f;  // Minimum slope to consider charging (V per sample)
-    const float MIN_VOLTAGE_RANGE =
-        0.005f;  // Minimum range to avoid noise false positives
-
-    bool chargingBySlope = slope > CHARGING_SLOPE_THRESHOLD;
-    bool sufficientRange = voltageRange > MIN_VOLTAGE_RANGE;
-    // Only consider charging if we have both positive slope and sufficient
-    // voltage range
-    bool isCurrentlyCharging = chargingBySlope && sufficientRange;
-
-    return isCurrentlyCharging;
-}
-
-void updateBatteryStatus() {
-    // Single sensor read per field per tick
-    voltBatteryPercent = (uint8_t)batteryService.cellPercent();
-
-    voltBatteryVoltage = batteryService.cellVoltage();
-    voltageBuffer.push(voltBatteryVoltage);
-
-    // Calculate charge rate if we have enough data
-    if (voltageBuffer.isFull()) {
-        static unsigned long lastCalculation = 0;
-        unsigned long now = millis();
-
-        if (lastCalculation > 0) {
-            float timeDelta = (now - lastCalculation) / 1000.0f;  // seconds
-            if (timeDelta > 0) {
-                // Simple rate calculation using oldest and newest values
-                float voltageDelta =
-                    voltageBuffer[voltageBuffer.size() - 1] - voltageBuffer[0];
-                lastChargeRate = voltageDelta / timeDelta;  // V/s
-            }
+    // Oldest and newest entry of each level; the finest covers the last
+    // few minutes, the coarsest the last few hours.
+    BatteryHistory::Entry entries[BatteryHistory::CAPACITY];
+    for (size_t level = 0; level < BatteryHistory::LEVELS; level++) {
+        size_t count =
+            getBatteryHistory(level, entries, BatteryHistory::CAPACITY);
+        if (count == 0) {
+            ESP_LOGI(TAG, "History %u: empty", (unsigned)level);
+            continue;
         }
-        lastCalculation = now;
+        const BatteryHistory::Entry &oldest = entries[0];
+        const BatteryHistory::Entry &newest = entries[count - 1];
+        ESP_LOGI(TAG,
+                 "History %u: %u entries, %u.%02u%% %u mV -> %u.%02u%% %u mV",
+                 (unsigned)level, (unsigned)count,
+                 (unsigned)(oldest.percentCenti / 100),
+                 (unsigned)(oldest.percentCenti % 100),
+                 (unsigned)oldest.millivolts,
+                 (unsigned)(newest.percentCenti / 100),
+                 (unsigned)(newest.percentCenti % 100),
+                 (unsigned)newest.millivolts);
     }
-
-    ESP_LOGV(TAG,
-             "Battery Update - Percent: %d%%, Voltage: %.2fV, Charge Rate: "
-             "%.2f%%/hr",
-             voltBatteryPercent, voltBatteryVoltage, lastChargeRate);
-}
\ No newline at end of file
+}
@@ -5,6 +5,8 @@
 
 #include <Adafruit_MAX1704X.h>
 
+#include "utils/BatteryEstimator.h"
+
 // MAX17048 I2C address and registers
 #define MAX17048_ADDR 0x36
 #define MAX17048_VCELL_REG 0x02
@@ -12,28 +14,52 @@
 #define MAX17048_MODE_REG 0x06
 #define MAX17048_VERSION_REG 0x08
 #define MAX17048_CONFIG_REG 0x0C
+#define MAX17048_CRATE_REG 0x16
 #define MAX17048_COMMAND_REG 0xFE
 
 // Declare the global service instance
 extern Adafruit_MAX17048 batteryService;
 
-// Function declarations
-bool initBattery();  // Kept for API compatibility; capacity unused
+// Latest fuel gauge reading and what the estimator made of it.
+struct BatteryTelemetry {
+    uint8_t percent;
+    float voltage;
+    float chipRatePercentPerHour;  // straight from the gauge
+    float ratePercentPerHour;      // smoothed; negative while discharging
+    float minutesToEmpty;          // -1 while charging or flat
+    bool charging;
+};
+
+// Where the charge used this session went, in percentage points.
+struct BatteryDrain {
+    uint32_t sessionMs;
+    float totalPercent;
+    float consumerPercent[static_cast<size_t>(PowerConsumer::COUNT)];
+};
+
+// Starts sampling the gauge in the background. Returns false if the gauge
+// did not respond.
+bool initBattery();
+
+// False until initBattery() found the gauge. Without it every reading below
+// stays at zero, and the status bar shows the battery as unknown.
+bool isBatteryGaugeAvailable();
 
 // MAX17048 accessors
 uint8_t getBatteryPercent();
 float getBatteryVoltage();
 
-// Battery status variables
-extern uint8_t voltBatteryPercent;
-extern float voltBatteryVoltage;
-extern float lastChargeRate;
-extern unsigned long lastBatteryCheck;
+BatteryTelemetry getBatteryTelemetry();
+BatteryDrain getBatteryDrain();
 
-// Battery update function
-void updateBatteryStatus();
+// Copies up to `max` history entries of `level` (0 = finest), oldest first.
+size_t getBatteryHistory(size_t level, BatteryHistory::Entry *out, size_t max);
 
 // Charging status function
 bool isCharging();
 
-#endif  // BATTERY_H
\ No newline at end of file
+// Logs the telemetry, this session's drain per consumer and the history.
+// In development builds, send 'b' over the monitor to log it.
+void printBatteryReport();
+
+#endif  // BATTERY_H
@@ -0,0 +1,190 @@
+#include "boot.h"
+
+#include <esp_timer.h>
+#include <freertos/event_groups.h>
+
+#include "esp_log.h"
+#include "trace.h"
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "BOOT";
+
+static const size_t SERVICE_COUNT = static_cast<size_t>(BootService::COUNT);
+
+// Event group bits above the services; FreeRTOS leaves 24 usable.
+static const EventBits_t WORKER_DONE_BIT = 1u << 23;
+static_assert(SERVICE_COUNT < 23, "Boot services must fit the event group");
+
+static const BootStep *bootSteps = nullptr;
+static size_t bootStepCount = 0;
+static uint32_t allMask = 0;
+
+// Guarded by bootMutex.
+static uint32_t startedMask = 0;
+static uint32_t doneMask = 0;
+static BootRecord timeline[SERVICE_COUNT];
+static size_t timelineCount = 0;
+
+static SemaphoreHandle_t bootMutex = NULL;
+static EventGroupHandle_t bootEvents = NULL;
+
+// Every dependency has to be declared earlier, which also rules out cycles.
+static bool validateSteps(const BootStep *steps, size_t count) {
+    uint32_t declared = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t missing = steps[i].dependsOn & ~declared;
+        if (missing != 0) {
+            ESP_LOGE(TAG, "%s depends on services declared after it (0x%lx)",
+                     steps[i].name, (unsigned long)missing);
+            return false;
+        }
+        declared |= bootBit(steps[i].service);
+    }
+    return true;
+}
+
+static void runStep(const BootStep &step) {
+    TRACE_BEGIN(BootStep, step.service);
+    uint32_t startUs = (uint32_t)esp_timer_get_time();
+    step.init();
+    uint32_t endUs = (uint32_t)esp_timer_get_time();
+    TRACE_END(BootStep, step.service);
+
+    xSemaphoreTake(bootMutex, portMAX_DELAY);
+    doneMask |= bootBit(step.service);
+    if (timelineCount < SERVICE_COUNT) {
+        timeline[timelineCount++] = {step.name, startUs, endUs,
+                                     (uint8_t)xPortGetCoreID()};
+    }
+    xSemaphoreGive(bootMutex);
+    xEventGroupSetBits(bootEvents, bootBit(step.service));
+}
+
+// The first step in table order that may run on `core` now. Call with
+// bootMutex held.
+static const BootStep *claimStep(BaseType_t core) {
+    for (size_t i = 0; i < bootStepCount; i++) {
+        const BootStep &step = bootSteps[i];
+        uint32_t bit = bootBit(step.service);
+        if ((startedMask & bit) != 0 || (step.dependsOn & ~doneMask) != 0) {
+            continue;
+        }
+        if (step.core != tskNO_AFFINITY && step.core != core) {
+            continue;
+        }
+        startedMask |= bit;
+        return &step;
+    }
+    return nullptr;
+}
+
+static void runSteps(BaseType_t core) {
+    while (true) {
+        xSemaphoreTake(bootMutex, portMAX_DELAY);
+        uint32_t done = doneMask;
+        const BootStep *step = done == allMask ? nullptr : claimStep(core);
+        xSemaphoreGive(bootMutex);
+
+        if (done == allMask) {
+            return;
+        }
+        if (step != nullptr) {
+            runStep(*step);
+            continue;
+        }
+        // Nothing ready here yet; wait for any outstanding step to finish.
+        xEventGroupWaitBits(bootEvents, allMask & ~done, pdFALSE, pdFALSE,
+                            portMAX_DELAY);
+    }
+}
+
+// Only needed while booting, so it comes from the heap and gives the
+// memory back.
+static const uint32_t BOOT_WORKER_STACK = 12 * configMINIMAL_STACK_SIZE;
+
+static void bootWorkerTask(void *param) {
+    auditStack(xTaskGetCurrentTaskHandle(), "bootWorker", BOOT_WORKER_STACK);
+    runSteps(xPortGetCoreID());
+    auditStackBeforeExit();
+    xEventGroupSetBits(bootEvents, WORKER_DONE_BIT);
+    vTaskDelete(NULL);
+}
+
+void runBoot(const BootStep *steps, size_t count) {
+    bootSteps = steps;
+    bootStepCount = count;
+    allMask = 0;
+    for (size_t i = 0; i < count; i++) {
+        allMask |= bootBit(steps[i].service);
+    }
+    startedMask = 0;
+    doneMask = 0;
+    timelineCount = 0;
+
+    if (bootMutex == NULL) {
+        static StaticMutex bootMutexMemory;
+        static StaticEventGroup bootEventsMemory;
+        bootMutex = bootMutexMemory.create();
+        bootEvents = bootEventsMemory.create();
+    }
+    xEventGroupClearBits(bootEvents, allMask | WORKER_DONE_BIT);
+
+    BaseType_t core = xPortGetCoreID();
+    BaseType_t otherCore = core == 0 ? 1 : 0;
+    bool parallel =
+        validateSteps(steps, count) &&
+        xTaskCreatePinnedToCore(bootWorkerTask, "bootWorker",
+                                BOOT_WORKER_STACK, NULL,
+                                uxTaskPriorityGet(NULL), NULL,
+                                otherCore) == pdPASS;
+
+    if (parallel) {
+        runSteps(core);
+        xEventGroupWaitBits(bootEvents, WORKER_DONE_BIT, pdFALSE, pdTRUE,
+                            portMAX_DELAY);
+    } else {
+        // One step at a time, in table order, on this core.
+        ESP_LOGE(TAG, "Falling back to a sequential boot");
+        for (size_t i = 0; i < count; i++) {
+            startedMask |= bootBit(steps[i].service);
+            runStep(steps[i]);
+        }
+    }
+    printBootTimeline();
+}
+
+size_t getBootTimeline(BootRecord *out, size_t max) {
+    if (bootMutex == NULL) {
+        return 0;
+    }
+    xSemaphoreTake(bootMutex, portMAX_DELAY);
+    size_t count = min(max, timelineCount);
+    memcpy(out, timeline, count * sizeof(BootRecord));
+    xSemaphoreGive(bootMutex);
+    return count;
+}
+
+void printBootTimeline() {
+    BootRecord records[SERVICE_COUNT];
+    size_t count = getBootTimeline(records, SERVICE_COUNT);
+    if (count == 0) {
+        return;
+    }
+
+    uint32_t firstUs = records[0].startUs;
+    uint32_t lastUs = records[0].endUs;
+    uint32_t busyUs = 0;
+    for (size_t i = 0; i < count; i++) {
+        const BootRecord &record = records[i];
+        firstUs = min(firstUs, record.startUs);
+        lastUs = max(lastUs, record.endUs);
+        busyUs += record.endUs - record.startUs;
+        ESP_LOGI(TAG, "%-12s core %u  %7.1f -> %7.1f ms  (%.1f ms)",
+                 record.name, record.core, record.startUs / 1000.0f,
+                 record.endUs / 1000.0f,
+                 (record.endUs - record.startUs) / 1000.0f);
+    }
+    // Busy time above wall time is what running on both cores saved.
+    ESP_LOGI(TAG, "Boot took %.1f ms for %.1f ms of init",
+             (lastUs - firstUs) / 1000.0f, busyUs / 1000.0f);
+}
@@ -0,0 +1,62 @@
+#ifndef BOOT_SERVICE_H
+#define BOOT_SERVICE_H
+
+#include <Arduino.h>
+
+// Everything setup() brings up, in table order.
+enum class BootService : uint8_t {
+    Memory,
+    Encoders,
+    Leds,
+    Display,
+    Text,
+    PageHost,
+    Ble,
+    Reconnect,
+    Wifi,
+    Feedback,
+    Workers,
+    StateMachine,
+    Battery,
+    StatusBar,
+    Power,
+    IdleMonitor,
+    Input,
+    COUNT
+};
+
+constexpr uint32_t bootBit(BootService service) {
+    return 1u << static_cast<uint8_t>(service);
+}
+
+struct BootStep {
+    BootService service;
+    const char *name;
+    // bootBit()s of the services that must be up first. They must come
+    // earlier in the table.
+    uint32_t dependsOn;
+    // Core to run on, or tskNO_AFFINITY for whichever is free first.
+    BaseType_t core;
+    void (*init)();
+};
+
+// When one step ran, in microseconds since the app started.
+struct BootRecord {
+    const char *name;
+    uint32_t startUs;
+    uint32_t endUs;
+    uint8_t core;
+};
+
+// Runs every step once its dependencies are up, with one worker on each
+// core so independent steps overlap. Returns when all steps have finished,
+// then logs the timeline.
+void runBoot(const BootStep *steps, size_t count);
+
+// Copies the timeline of the last runBoot(), in the order steps finished.
+size_t getBootTimeline(BootRecord *out, size_t max);
+
+// Logs the timeline over serial.
+void printBootTimeline();
+
+#endif  // BOOT_SERVICE_H
@@ -12,9 +12,15 @@
 
 #include <NimBLEDevice.h>
 #include <esp_log.h>
+#include <atomic>
 #include <queue>
 #include <regex>
 
+#include "services/hotlog.h"
+#include "services/memory.h"
+#include "utils/SpscQueue.h"
+#include "utils/StaticRtos.h"
+
 static const char *TAG_COMS = "COMS";
 
 static const NimBLEAdvertisedDevice *advDevice;
@@ -23,7 +29,54 @@ static uint32_t scanTimeMs =
     0; /** scan time in milliseconds, 0 = scan forever */
 
 static std::queue<String> commandQueue;
-static std::vector<DiscoveredDevice> discoveredDevices;
+
+// One advertisement from a supported device, handed from the NimBLE host task
+// to the scan monitor.
+struct ScanSighting {
+    const NimBLEAdvertisedDevice *advertisedDevice;
+    const DeviceFactory *factory;
+    int8_t rssi;
+};
+
+static SpscQueue<ScanSighting, 32> scanQueue;
+// The monitor task lives for good and waits on scanMonitorStart between
+// scans. It gives scanMonitorIdle back once a scan has finished, so the next
+// startScan can block until the queue has no consumer. Its callbacks only
+// post events, so it needs no room for the actions they lead to.
+static StaticTask<6 * configMINIMAL_STACK_SIZE> scanMonitorTaskMemory;
+static StaticSemaphore scanMonitorStartMemory;
+static StaticSemaphore scanMonitorIdleMemory;
+static TaskHandle_t scanMonitorHandle = NULL;
+static SemaphoreHandle_t scanMonitorStart = NULL;
+static SemaphoreHandle_t scanMonitorIdle = NULL;
+static volatile bool scanMonitorRunning = false;
+static volatile bool scanMonitorExitRequested = false;
+
+// The scan the monitor is running. Only one scan runs at a time.
+struct ActiveScan {
+    ScanPolicy policy;
+    void (*onComplete)();
+    void (*onKnownDevice)();
+};
+static ActiveScan activeScan;
+// Tick the current scan started at, 0 once a connection was logged.
+static TickType_t scanStartTick = 0;
+
+static NimBLEAddress lastConnectedAddress;
+static bool hasLastConnectedAddress = false;
+
+// Device table, guarded by deviceTableMutex. `deviceOrder` holds table slots
+// sorted by smoothed RSSI.
+static DiscoveredDevice discoveredDevices[MAX_DISCOVERED_DEVICES];
+static uint8_t deviceOrder[MAX_DISCOVERED_DEVICES];
+static int discoveredDeviceCount = 0;
+static uint16_t nextDeviceId = 0;
+static std::atomic<uint32_t> discoveredDevicesVersion{0};
+static SemaphoreHandle_t deviceTableMutex = NULL;
+
+// A device only moves above its neighbour once it is this much stronger, so
+// the list does not shuffle on RSSI noise. 3 dBm in 1/16 dBm.
+static const int16_t RSSI_REORDER_HYSTERESIS = 3 * 16;
 
 /** Define a class to handle the callbacks when scan events are received */
 class ScanCallbacks : public NimBLEScanCallbacks {
@@ -32,14 +85,11 @@ class ScanCallbacks : public NimBLEScanCallbacks {
         const DeviceFactory *factory = nullptr;
         auto countOfServiceUUIDs = advertisedDevice->getServiceUUIDCount();
         for (int i = 0; i < countOfServiceUUIDs; i++) {
-            vTaskDelay(1);
             auto serviceUUID = advertisedDevice->getServiceUUID(i);
 
-            auto name = advertisedDevice->getName();
-
             // print the service UUID and name
-            ESP_LOGI("DEBUG_FOLLOWER", "Service UUID: %s, Name: %s",
-                     serviceUUID.toString().c_str(), name.c_str());
+            HOT_LOGV(COMS, "Service UUID: %s, Name: %s",
+                     serviceUUID.toString(), advertisedDevice->getName());
 
             // check if the service UUID is in the registry
             factory = getDeviceFactory(serviceUUID);
@@ -53,31 +103,18 @@ class ScanCallbacks : public NimBLEScanCallbacks {
             return;
         }
 
-        // Check if device already exists in list (by address)
-        std::string address = advertisedDevice->getAddress().toString();
-        for (auto &dev : discoveredDevices) {
-            if (dev.advertisedDevice->getAddress().toString() == address) {
-                // Update RSSI if device already in list
-                dev.rssi = advertisedDevice->getRSSI();
-                return;
-            }
+        // With duplicates enabled this runs for every advertisement, so just
+        // hand it over; the scan monitor does the bookkeeping.
+        scanQueue.push({advertisedDevice, factory,
+                         static_cast<int8_t>(advertisedDevice->getRSSI())});
+        if (scanMonitorRunning) {
+            xTaskNotifyGive(scanMonitorHandle);
         }
-
-        // Add new device to list
-        DiscoveredDevice newDevice;
-        newDevice.advertisedDevice = advertisedDevice;
-        newDevice.factory = factory;
-        newDevice.name = advertisedDevice->getName().c_str();
-        newDevice.rssi = advertisedDevice->getRSSI();
-        discoveredDevices.push_back(newDevice);
-
-        ESP_LOGI(TAG_COMS, "Found device: %s (RSSI: %d)", newDevice.name.c_str(), newDevice.rssi);
-
-        return;
     }
-    
+
     void onScanEnd(const NimBLEScanResults& results, int reason) override {
-        ESP_LOGI(TAG_COMS, "Scan ended. Found %d devices", discoveredDevices.size());
+        ESP_LOGI(TAG_COMS, "Scan ended. Found %d devices",
+                 getDiscoveredDeviceCount());
     }
 } scanCallbacks;
 
@@ -159,8 +196,12 @@ void initBLE() {
     NimBLEDevice::setPower(9); /** 9dBm */
     NimBLEScan *pScan = NimBLEDevice::getScan();
 
-    /** Set the callbacks to call when scan events occur, no duplicates */
-    pScan->setScanCallbacks(&scanCallbacks, false);
+    static StaticMutex deviceTableMutexMemory;
+    deviceTableMutex = deviceTableMutexMemory.create();
+
+    /** Set the callbacks to call when scan events occur. Duplicates are
+     * reported so the device list can track RSSI while it is shown. */
+    pScan->setScanCallbacks(&scanCallbacks, true);
 
     /** Set scan interval (how often) and window (how long) in milliseconds */
     pScan->setInterval(100);
@@ -177,23 +218,143 @@ void initBLE() {
     ESP_LOGI(TAG_COMS, "Scanning for peripherals");
 }
 
-std::vector<DiscoveredDevice>& getDiscoveredDevices() {
-    return discoveredDevices;
+// Moves the entry at `position` in deviceOrder up past weaker neighbours.
+static bool bubbleUp(int position) {
+    bool moved = false;
+    while (position > 0) {
+        const DiscoveredDevice &current =
+            discoveredDevices[deviceOrder[position]];
+        const DiscoveredDevice &above =
+            discoveredDevices[deviceOrder[position - 1]];
+        if (current.rssiQ4 - above.rssiQ4 <= RSSI_REORDER_HYSTERESIS) {
+            break;
+        }
+        std::swap(deviceOrder[position], deviceOrder[position - 1]);
+        position--;
+        moved = true;
+    }
+    return moved;
+}
+
+// Folds one sighting into the device table. Returns true if the visible list
+// changed. Must be called with deviceTableMutex held.
+static bool applySighting(const ScanSighting &sighting) {
+    int16_t rssiQ4 = sighting.rssi * 16;
+
+    for (int position = 0; position < discoveredDeviceCount; position++) {
+        DiscoveredDevice &dev = discoveredDevices[deviceOrder[position]];
+        if (dev.advertisedDevice != sighting.advertisedDevice) {
+            continue;
+        }
+
+        dev.rssiQ4 += (rssiQ4 - dev.rssiQ4) / 4;
+
+        bool changed = false;
+        // The name often only arrives with the scan response.
+        if (dev.name[0] == '\0') {
+            std::string name = sighting.advertisedDevice->getName();
+            if (!name.empty()) {
+                strlcpy(dev.name, name.c_str(), sizeof(dev.name));
+                changed = true;
+            }
+        }
+        return bubbleUp(position) || changed;
+    }
+
+    if (discoveredDeviceCount >= MAX_DISCOVERED_DEVICES) {
+        return false;
+    }
+
+    int slot = discoveredDeviceCount;
+    DiscoveredDevice &dev = discoveredDevices[slot];
+    dev.advertisedDevice = sighting.advertisedDevice;
+    dev.factory = sighting.factory;
+    strlcpy(dev.name, sighting.advertisedDevice->getName().c_str(),
+            sizeof(dev.name));
+    dev.rssiQ4 = rssiQ4;
+    dev.id = nextDeviceId++;
+    deviceOrder[discoveredDeviceCount++] = slot;
+    bubbleUp(discoveredDeviceCount - 1);
+
+    HOT_LOGI(COMS, "Found device: %s (RSSI: %d)", dev.name, sighting.rssi);
+    return true;
+}
+
+static bool isKnownAddress(const NimBLEAddress &address) {
+    return (hasLastConnectedAddress && address == lastConnectedAddress) ||
+           NimBLEDevice::isBonded(address);
+}
+
+// Drains queued sightings into the device table. Only the scan monitor calls
+// this, keeping scanQueue single-consumer. Returns true if the list changed;
+// `added` is set to the number of new devices.
+static bool drainScanQueue(int &added) {
+    bool changed = false;
+    ScanSighting sighting;
+    xSemaphoreTake(deviceTableMutex, portMAX_DELAY);
+    int countBefore = discoveredDeviceCount;
+    while (scanQueue.pop(sighting)) {
+        changed |= applySighting(sighting);
+    }
+    added = discoveredDeviceCount - countBefore;
+    xSemaphoreGive(deviceTableMutex);
+
+    if (changed) {
+        discoveredDevicesVersion++;
+    }
+    return changed;
+}
+
+int getDiscoveredDeviceCount() {
+    xSemaphoreTake(deviceTableMutex, portMAX_DELAY);
+    int count = discoveredDeviceCount;
+    xSemaphoreGive(deviceTableMutex);
+    return count;
+}
+
+bool getDiscoveredDevice(int index, DiscoveredDevice &out) {
+    bool found = false;
+    xSemaphoreTake(deviceTableMutex, portMAX_DELAY);
+    if (index >= 0 && index < discoveredDeviceCount) {
+        out = discoveredDevices[deviceOrder[index]];
+        found = true;
+    }
+    xSemaphoreGive(deviceTableMutex);
+    return found;
 }
 
+int findDiscoveredDevice(uint16_t id) {
+    int index = -1;
+    xSemaphoreTake(deviceTableMutex, portMAX_DELAY);
+    for (int position = 0; position < discoveredDeviceCount; position++) {
+        if (discoveredDevices[deviceOrder[position]].id == id) {
+            index = position;
+            break;
+        }
+    }
+    xSemaphoreGive(deviceTableMutex);
+    return index;
+}
+
+uint32_t getDiscoveredDevicesVersion() { return discoveredDevicesVersion; }
+
 void clearDiscoveredDevices() {
-    discoveredDevices.clear();
+    xSemaphoreTake(deviceTableMutex, portMAX_DELAY);
+    discoveredDeviceCount = 0;
+    nextDeviceId = 0;
+    xSemaphoreGive(deviceTableMutex);
+    discoveredDevicesVersion++;
     ESP_LOGI(TAG_COMS, "Cleared discovered devices list");
 }
 
 void connectToDiscoveredDevice(int index) {
-    if (index < 0 || index >= discoveredDevices.size()) {
+    DiscoveredDevice selectedDevice;
+    if (!getDiscoveredDevice(index, selectedDevice)) {
         ESP_LOGE(TAG_COMS, "Invalid device index: %d", index);
         return;
     }
 
-    const DiscoveredDevice &selectedDevice = discoveredDevices[index];
-    ESP_LOGI(TAG_COMS, "Connecting to device: %s", selectedDevice.name.c_str());
+    ESP_LOGI(TAG_COMS, "Connecting to device: %s", selectedDevice.name);
 
     // Stop scanning
     NimBLEDevice::getScan()->stop();
@@ -203,32 +364,202 @@ void connectToDiscoveredDevice(int index) {
     device = (*selectedDevice.factory)(selectedDevice.advertisedDevice);
 }
 
-void startScanWithTimeout(int timeoutMs, void (*onComplete)()) {
-    clearDiscoveredDevices();
+int findKnownDevice() {
+    int index = -1;
+    xSemaphoreTake(deviceTableMutex, portMAX_DELAY);
+    for (int position = 0; position < discoveredDeviceCount; position++) {
+        const DiscoveredDevice &dev = discoveredDevices[deviceOrder[position]];
+        if (isKnownAddress(dev.advertisedDevice->getAddress())) {
+            index = position;
+            break;
+        }
+    }
+    xSemaphoreGive(deviceTableMutex);
+    return index;
+}
+
+void onDeviceConnected(Device *connectedDevice) {
+    NimBLEAddress address = connectedDevice->pClient->getPeerAddress();
+    lastConnectedAddress = address;
+    hasLastConnectedAddress = true;
+
+    PeerRecord peer;
+    memcpy(peer.address, address.getVal(), sizeof(peer.address));
+    peer.addressType = address.getType();
+    strlcpy(peer.serviceUUID,
+            connectedDevice->getServiceUUID().toString().c_str(),
+            sizeof(peer.serviceUUID));
+    strlcpy(peer.protocolFile, connectedDevice->getProtocolFile(),
+            sizeof(peer.protocolFile));
+    saveLastPeer(peer);
+
+    if (scanStartTick != 0) {
+        ESP_LOGI(TAG_COMS, "[%s] Connected %lu ms after scan start",
+                 activeScan.policy.name,
+                 (unsigned long)pdTICKS_TO_MS(xTaskGetTickCount() -
+                                              scanStartTick));
+        scanStartTick = 0;
+    }
+}
+
+bool startPeerReconnect() {
+    PeerRecord peer;
+    if (!loadLastPeer(peer)) {
+        return false;
+    }
+
+    NimBLEAddress address(peer.address, peer.addressType);
+    lastConnectedAddress = address;
+    hasLastConnectedAddress = true;
+
+    Device *peerDevice = createDeviceForPeer(peer);
+    if (peerDevice == nullptr) {
+        ESP_LOGW(TAG_COMS, "Stored peer %s is not supported",
+                 peer.serviceUUID);
+        return false;
+    }
+
+    ESP_LOGI(TAG_COMS, "Reconnecting to %s (%s)", address.toString().c_str(),
+             peerDevice->getName());
+    advDevice = nullptr;
+    device = peerDevice;
+    return true;
+}
+
+static void monitorScan() {
+    const ScanPolicy &policy = activeScan.policy;
+    const TickType_t start = xTaskGetTickCount();
+    const TickType_t timeout = pdMS_TO_TICKS(policy.timeoutMs);
+    const TickType_t quietPeriod = pdMS_TO_TICKS(policy.quietPeriodMs);
+    TickType_t lastNewDevice = 0;
+    bool reported = false;
+    bool connecting = false;
+    const char *endReason = "timeout";
+
+    auto elapsedMs = [&]() {
+        return (unsigned long)pdTICKS_TO_MS(xTaskGetTickCount() - start);
+    };
+
+    while (!scanMonitorExitRequested) {
+        TickType_t now = xTaskGetTickCount();
+        if (now - start >= timeout) {
+            break;
+        }
+        if (lastNewDevice != 0 && now - lastNewDevice >= quietPeriod) {
+            endReason = "quiet period";
+            break;
+        }
+
+        // Woken by the scan callback as soon as something is queued.
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+
+        int added = 0;
+        if (!drainScanQueue(added)) {
+            continue;
+        }
+        if (added > 0) {
+            lastNewDevice = xTaskGetTickCount();
+        }
+
+        if (findKnownDevice() >= 0) {
+            if (policy.autoConnectKnownDevice && activeScan.onKnownDevice) {
+                ESP_LOGI(TAG_COMS, "[%s] Known device seen after %lu ms",
+                         policy.name, elapsedMs());
+                connecting = true;
+                activeScan.onKnownDevice();
+                break;
+            }
+            // Nothing else is likely to be wanted; the list is shown below
+            // if it is not up yet.
+            endReason = "known device";
+            break;
+        }
+
+        if (!reported && getDiscoveredDeviceCount() > 0) {
+            reported = true;
+            ESP_LOGI(TAG_COMS, "[%s] Device list shown after %lu ms",
+                     policy.name, elapsedMs());
+            if (activeScan.onComplete) {
+                activeScan.onComplete();
+            }
+        }
+    }
+
+    // Stop scanning
     NimBLEScan *pScan = NimBLEDevice::getScan();
-    
-    // Start a task to monitor scanning and call callback
-    // NOTE: Stack size must be large enough to handle the callback chain,
-    // which includes state machine processing and UI operations
-    xTaskCreate([](void* param) {
-        auto callback = (void (*)())param;
-        
-        // Wait for scan timeout
-        vTaskDelay(5000 / portTICK_PERIOD_MS);
-        
-        // Stop scanning
-        NimBLEScan *pScan = NimBLEDevice::getScan();
-        if (pScan->isScanning()) {
-            pScan->stop();
-        }
-        
-        // Call completion callback
-        if (callback) {
-            callback();
-        }
-        
-        vTaskDelete(NULL);
-    }, "scanMonitor", 8192, (void*)onComplete, 1, NULL);
-    
+    if (pScan->isScanning()) {
+        pScan->stop();
+    }
+    int added = 0;
+    drainScanQueue(added);
+
+    if (!connecting) {
+        ESP_LOGI(TAG_COMS, "[%s] Scan ended after %lu ms (%s), %d devices",
+                 policy.name, elapsedMs(), endReason,
+                 getDiscoveredDeviceCount());
+
+        // Still report when nothing was found so the (empty) list is shown.
+        if (!reported && !scanMonitorExitRequested && activeScan.onComplete) {
+            ESP_LOGI(TAG_COMS, "[%s] Device list shown after %lu ms",
+                     policy.name, elapsedMs());
+            activeScan.onComplete();
+        }
+    }
+}
+
+static void scanMonitorTask(void *param) {
+    while (true) {
+        xSemaphoreTake(scanMonitorStart, portMAX_DELAY);
+        // Drop wakeups left over from the last scan.
+        ulTaskNotifyTake(pdTRUE, 0);
+        monitorScan();
+        scanMonitorRunning = false;
+        xSemaphoreGive(scanMonitorIdle);
+    }
+}
+
+void startScan(const ScanPolicy &policy, void (*onComplete)(),
+               void (*onKnownDevice)()) {
+    NimBLEScan *pScan = NimBLEDevice::getScan();
+
+    if (scanMonitorHandle == NULL) {
+        scanMonitorStart = scanMonitorStartMemory.create();
+        scanMonitorIdle = scanMonitorIdleMemory.create();
+        xSemaphoreGive(scanMonitorIdle);
+        scanMonitorHandle = scanMonitorTaskMemory.start(
+            scanMonitorTask, "scanMonitor", NULL, 1, tskNO_AFFINITY);
+    }
+
+    // Only one monitor may consume the scan queue at a time: ask a running
+    // scan to end and wait until it has.
+    if (scanMonitorRunning) {
+        scanMonitorExitRequested = true;
+        xTaskNotifyGive(scanMonitorHandle);
+    }
+    xSemaphoreTake(scanMonitorIdle, portMAX_DELAY);
+    if (pScan->isScanning()) {
+        pScan->stop();
+    }
+    scanMonitorExitRequested = false;
+
+    // Queued sightings point into the previous scan's results, which are
+    // freed when the next scan starts.
+    scanQueue.clear();
+    clearDiscoveredDevices();
+
+    activeScan = {policy, onComplete, onKnownDevice};
+    scanStartTick = xTaskGetTickCount();
+
+    // Wake the task that monitors scanning and calls the callbacks
+    scanMonitorRunning = true;
+    xSemaphoreGive(scanMonitorStart);
+
     pScan->start(0);
 }
+
+void startScanWithTimeout(int timeoutMs, void (*onComplete)()) {
+    // Without a quiet period the scan always runs for the full timeout.
+    startScan({"timeout", static_cast<uint32_t>(timeoutMs),
+               static_cast<uint32_t>(timeoutMs), false},
+              onComplete);
+}
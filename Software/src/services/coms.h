@@ -11,11 +11,17 @@
 #include <devices/device.h>
 #include <vector>
 
+// Maximum number of devices kept from one scan.
+static const int MAX_DISCOVERED_DEVICES = 16;
+
 struct DiscoveredDevice {
     const NimBLEAdvertisedDevice *advertisedDevice;
     const DeviceFactory *factory;
-    std::string name;
-    int rssi;
+    char name[32];
+    // RSSI smoothed with an exponential moving average, in 1/16 dBm.
+    int16_t rssiQ4;
+    // Unique within one scan; stays with the device when the list re-sorts.
+    uint16_t id;
 };
 
 void sendCommand(const String &command);
@@ -23,9 +29,48 @@ void sendCommand(const String &command);
 void initBLE();
 
 // Device list management
-std::vector<DiscoveredDevice>& getDiscoveredDevices();
+//
+// Scan results are streamed into a fixed-size table while the scan runs,
+// sorted by smoothed RSSI (strongest first). Positions below refer to that
+// order.
+int getDiscoveredDeviceCount();
+// Copies the device at `index`. Returns false if the index is out of range.
+bool getDiscoveredDevice(int index, DiscoveredDevice &out);
+// Current position of the device with `id`, or -1 if it is not listed.
+int findDiscoveredDevice(uint16_t id);
+// Incremented whenever devices are added, renamed or re-ordered.
+uint32_t getDiscoveredDevicesVersion();
 void clearDiscoveredDevices();
 void connectToDiscoveredDevice(int index);
+
+// When a device scan ends.
+struct ScanPolicy {
+    const char *name;
+    // Hard limit for the whole scan.
+    uint32_t timeoutMs;
+    // Once something was found, stop after this long without a new device.
+    uint32_t quietPeriodMs;
+    // Connect straight away when the last connected (or a bonded) device is
+    // seen, instead of showing the list.
+    bool autoConnectKnownDevice;
+};
+
+// Scans for supported devices. `onComplete` runs as soon as the first device
+// is found (or when the scan ends without finding any); the scan keeps
+// running in the background so the list can fill in. `onKnownDevice` runs
+// instead when the policy auto-connects to a known device.
+void startScan(const ScanPolicy &policy, void (*onComplete)(),
+               void (*onKnownDevice)() = nullptr);
 void startScanWithTimeout(int timeoutMs, void (*onComplete)());
 
+// Position of the last connected (or a bonded) device in the list, or -1.
+int findKnownDevice();
+// Records a successful connection for the known-device fast path, persists
+// it for the next boot and logs how long it took from the start of the scan.
+void onDeviceConnected(Device *connectedDevice);
+
+// Starts connecting straight to the peer stored in memory, without scanning.
+// Returns false if there is no usable stored peer.
+bool startPeerReconnect();
+
 #endif
\ No newline at end of file
@@ -1,11 +1,12 @@
 #include "display.h"
 #include "esp_log.h"
+#include "utils/StaticRtos.h"
 
 static const char* TAG = "DISPLAY";
 
 // PWM configuration for backlight
 // LEDC channel allocation (see also any global PWM/channel docs):
-//   - Channel 0 : reserved by Tone library
+//   - Channel 0 : buzzer (services/feedback.cpp)
 //   - Channel 7 : reserved for TFT backlight (BACKLIGHT_PWM_CHANNEL)
 //
 // NOTE: Do not reuse channel 7 elsewhere; allocate new LEDC channels only
@@ -20,8 +21,14 @@ static uint8_t currentBrightness = BRIGHTNESS_FULL;
 // Screen setup
 Adafruit_ST7789 tft = Adafruit_ST7789(&SPI, pins::TFT_CS, pins::TFT_DC, pins::TFT_RST);
 
+Adafruit_GFX &screenGFX()
+{
+    return tft;
+}
+
 // Create the display mutex
-SemaphoreHandle_t displayMutex = xSemaphoreCreateMutex();
+static StaticMutex displayMutexMemory;
+SemaphoreHandle_t displayMutex = displayMutexMemory.create();
 
 bool initDisplay()
 {
@@ -49,6 +56,11 @@ void setScreenBrightness(uint8_t brightness)
     currentBrightness = brightness;
 }
 
+uint8_t getScreenBrightness()
+{
+    return currentBrightness;
+}
+
 void dimScreen()
 {
     setScreenBrightness(BRIGHTNESS_DIM);
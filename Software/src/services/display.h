@@ -9,6 +9,10 @@
 // Global TFT instance
 extern Adafruit_ST7789 tft;
 
+// The same screen as a plain Adafruit_GFX, e.g. for widgets that are
+// otherwise drawn through a clipping wrapper
+Adafruit_GFX &screenGFX();
+
 // Display semaphore for thread-safe access
 extern SemaphoreHandle_t displayMutex;
 
@@ -22,6 +26,7 @@ bool initDisplay();
 
 // Set screen brightness (0-255)
 void setScreenBrightness(uint8_t brightness);
+uint8_t getScreenBrightness();
 
 // Convenience functions
 void dimScreen();
@@ -1,49 +1,175 @@
 #include "encoder.h"
 
 #include "memory.h"
+#include "trace.h"
+
+#include <driver/gpio.h>
+#include <esp_timer.h>
 
 // Initialize the global service instances
-DRAM_ATTR AiEsp32RotaryEncoder leftEncoder(pins::LEFT_ENCODER_A,
-                                           pins::LEFT_ENCODER_B, -1, -1, 4);
-DRAM_ATTR AiEsp32RotaryEncoder rightEncoder(pins::RIGHT_ENCODER_A,
-                                            pins::RIGHT_ENCODER_B, -1, -1, 4);
-
-// Movement tracking state
-static bool leftEncoderHasChanged = false;
-static bool rightEncoderHasChanged = false;
-
-void IRAM_ATTR readLeftEncoder() {
-    leftEncoder.readEncoder_ISR();
-    leftEncoderHasChanged = true;
+RotaryEncoder leftEncoder(pins::LEFT_ENCODER_A, pins::LEFT_ENCODER_B);
+RotaryEncoder rightEncoder(pins::RIGHT_ENCODER_A, pins::RIGHT_ENCODER_B);
+
+static void IRAM_ATTR onEncoderEdge(void *arg) {
+    static_cast<RotaryEncoder *>(arg)->onEdge();
+}
+
+RotaryEncoder::RotaryEncoder(uint8_t pinA, uint8_t pinB)
+    : pinA(pinA), pinB(pinB) {}
+
+void RotaryEncoder::setPins(uint8_t pinA, uint8_t pinB) {
+    this->pinA = pinA;
+    this->pinB = pinB;
+}
+
+void RotaryEncoder::begin() {
+    // Same pin setup AiEsp32RotaryEncoder used by default.
+    pinMode(pinA, INPUT_PULLDOWN);
+    pinMode(pinB, INPUT_PULLDOWN);
+    pinState = (digitalRead(pinB) << 1) | digitalRead(pinA);
+
+    attachInterruptArg(digitalPinToInterrupt(pinA), onEncoderEdge, this,
+                       CHANGE);
+    attachInterruptArg(digitalPinToInterrupt(pinB), onEncoderEdge, this,
+                       CHANGE);
+}
+
+void RotaryEncoder::end() {
+    detachInterrupt(digitalPinToInterrupt(pinA));
+    detachInterrupt(digitalPinToInterrupt(pinB));
+}
+
+// Both pins of an encoder are attached from the same core, so the shared GPIO
+// interrupt handler never runs this twice at once for one encoder.
+void IRAM_ATTR RotaryEncoder::onEdge() {
+    uint8_t state = (gpio_get_level(static_cast<gpio_num_t>(pinB)) << 1) |
+                    gpio_get_level(static_cast<gpio_num_t>(pinA));
+    int8_t step = EncoderMath::quadratureStep(pinState, state);
+    pinState = state;
+    if (step == 0) {
+        return;
+    }
+
+    quarterSteps += step;
+    if (quarterSteps > -EncoderMath::STEPS_PER_DETENT &&
+        quarterSteps < EncoderMath::STEPS_PER_DETENT) {
+        return;
+    }
+
+    int8_t direction = quarterSteps > 0 ? 1 : -1;
+    quarterSteps = 0;
+    detents += direction;
+    TRACE_INSTANT(EncoderDetent, pinA);
+
+    int64_t now = esp_timer_get_time();
+    velocity.addDetent(static_cast<uint32_t>(now), direction);
+    snapshot.write({detents, velocity.speedQ8, velocity.lastDetentUs});
+
+    changed = true;
+    changedAtUs = now;
+
+    if (notifyTask != NULL) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(notifyTask, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
+}
+
+long RotaryEncoder::bound(long candidate) const {
+    if (candidate > maxValue) {
+        return circleValues ? minValue : maxValue;
+    }
+    if (candidate < minValue) {
+        return circleValues ? maxValue : minValue;
+    }
+    return candidate;
 }
 
-void IRAM_ATTR readRightEncoder() {
-    rightEncoder.readEncoder_ISR();
-    rightEncoderHasChanged = true;
+long RotaryEncoder::readEncoder() {
+    Snapshot latest = snapshot.read();
+    uint32_t speedQ8 = EncoderMath::speedAt(
+        latest.speedQ8, latest.lastDetentUs,
+        static_cast<uint32_t>(esp_timer_get_time()));
+
+    portENTER_CRITICAL(&mux);
+    int32_t delta = latest.detents - consumedDetents;
+    consumedDetents = latest.detents;
+    if (delta != 0) {
+        value = bound(value + curve.apply(delta, speedQ8, residueQ8));
+    }
+    long result = value;
+    portEXIT_CRITICAL(&mux);
+    return result;
+}
+
+void RotaryEncoder::setEncoderValue(long newValue) {
+    Snapshot latest = snapshot.read();
+
+    // Turns from before the value was set are dropped, as they would have
+    // been overwritten anyway.
+    portENTER_CRITICAL(&mux);
+    consumedDetents = latest.detents;
+    residueQ8 = 0;
+    value = bound(newValue);
+    portEXIT_CRITICAL(&mux);
+}
+
+void RotaryEncoder::setBoundaries(long minValue, long maxValue,
+                                  bool circleValues) {
+    portENTER_CRITICAL(&mux);
+    this->minValue = minValue;
+    this->maxValue = maxValue;
+    this->circleValues = circleValues;
+    value = constrain(value, minValue, maxValue);
+    portEXIT_CRITICAL(&mux);
+}
+
+void RotaryEncoder::setAccelerationCurve(const AccelerationCurve &curve) {
+    portENTER_CRITICAL(&mux);
+    this->curve = curve;
+    residueQ8 = 0;
+    portEXIT_CRITICAL(&mux);
+}
+
+void RotaryEncoder::setAcceleration(uint16_t acceleration) {
+    AccelerationCurve curve;
+    if (acceleration > 0) {
+        curve.thresholdDetentsPerSec = 5;
+        // Roughly 3x at 50 detents/s for the 50 the OSSM controls use.
+        curve.gainQ8 = acceleration >= 4 ? acceleration / 4 : 1;
+        curve.maxMultiplier = 10;
+    }
+    setAccelerationCurve(curve);
+}
+
+bool RotaryEncoder::hasChanged(bool reset) {
+    bool result = changed;
+    if (reset) {
+        changed = false;  // Reset after reading
+    }
+    return result;
 }
 
 void initEncoderService() {
     // if the memory chip is found, then please reinit the encoder.
     // This is a wiring issue.
     if (isMemoryChipFound) {
-        leftEncoder = AiEsp32RotaryEncoder(pins::LEFT_ENCODER_B,
-                                           pins::LEFT_ENCODER_A, -1, -1, 4);
+        leftEncoder.setPins(pins::LEFT_ENCODER_B, pins::LEFT_ENCODER_A);
     }
 
     // Initialize encoders
     leftEncoder.begin();
     rightEncoder.begin();
 
-    leftEncoder.setup(readLeftEncoder);
-    rightEncoder.setup(readRightEncoder);
-
     // Set encoder boundaries and step size
     leftEncoder.setBoundaries(0, 100, false);  // 0-100% speed
-    leftEncoder.setAcceleration(0);  // No acceleration for linear response
+    leftEncoder.setAccelerationCurve(
+        AccelerationCurve::linear());  // linear response
     rightEncoder.setBoundaries(
         0, 100,
         false);  // 0-100% focus switcher on "stroke", "sensation", "depth", etc
-    rightEncoder.setAcceleration(0);  // No acceleration for linear response
+    rightEncoder.setAccelerationCurve(
+        AccelerationCurve::linear());  // linear response
 
     // Set initial values
     leftEncoder.setEncoderValue(50);   // Start at 50%
@@ -54,18 +180,10 @@ bool hasLeftEncoderChanged() { return hasLeftEncoderChanged(false); }
 bool hasRightEncoderChanged() { return hasRightEncoderChanged(false); }
 
 // Helper functions to check encoder change state
-bool hasLeftEncoderChanged(bool reset) {
-    bool changed = leftEncoderHasChanged;
-    if (reset) {
-        leftEncoderHasChanged = false;  // Reset after reading
-    }
-    return changed;
-}
+bool hasLeftEncoderChanged(bool reset) { return leftEncoder.hasChanged(reset); }
 
 bool hasRightEncoderChanged(bool reset) {
-    bool changed = rightEncoderHasChanged;
-    if (reset) {
-        rightEncoderHasChanged = false;  // Reset after reading
-    }
-    return changed;
-}
\ No newline at end of file
+    return rightEncoder.hasChanged(reset);
+}
+
+int64_t getRightEncoderChangedAtUs() { return rightEncoder.getChangedAtUs(); }
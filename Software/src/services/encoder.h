@@ -2,14 +2,92 @@
 #define ENCODER_SERVICE_H
 
 #include <Arduino.h>
-
-#include <AiEsp32RotaryEncoder.h>
+#include <limits.h>
 
 #include "pins.h"
+#include "utils/EncoderMath.h"
+#include "utils/Seqlock.h"
+
+using EncoderMath::AccelerationCurve;
+
+/**
+ * @brief Quadrature encoder decoded in its own pin interrupts.
+ *
+ * The interrupt counts detents and keeps a velocity estimate, publishing both
+ * through a seqlock snapshot. Everything else (acceleration, boundaries and
+ * the current value) is applied when a consumer calls readEncoder(), so the
+ * interrupt does a fixed, small amount of work per transition.
+ *
+ * The value API matches the AiEsp32RotaryEncoder one it replaces.
+ */
+class RotaryEncoder {
+  public:
+    RotaryEncoder(uint8_t pinA, uint8_t pinB);
+
+    // Only valid before begin().
+    void setPins(uint8_t pinA, uint8_t pinB);
+
+    // Configures the pins and attaches the interrupts.
+    void begin();
+    void end();
+
+    // Applies detents turned since the last call and returns the value.
+    long readEncoder();
+    void setEncoderValue(long newValue);
+    void setBoundaries(long minValue, long maxValue,
+                       bool circleValues = false);
+
+    // Acceleration for whoever is reading the encoder now; pages set their own
+    // curve when they take over the knob.
+    void setAccelerationCurve(const AccelerationCurve &curve);
+    // AiEsp32RotaryEncoder-style amount: 0 is linear, larger accelerates
+    // harder.
+    void setAcceleration(uint16_t acceleration);
+
+    // Task to notify on every detent.
+    void notifyOnChange(TaskHandle_t task) { notifyTask = task; }
+
+    bool hasChanged(bool reset);
+    int64_t getChangedAtUs() const { return changedAtUs; }
+
+    void onEdge();
+
+  private:
+    struct Snapshot {
+        int32_t detents;
+        uint32_t speedQ8;
+        uint32_t lastDetentUs;
+    };
+
+    long bound(long candidate) const;
+
+    uint8_t pinA;
+    uint8_t pinB;
+
+    // Interrupt side
+    uint8_t pinState = 0;
+    int8_t quarterSteps = 0;
+    int32_t detents = 0;
+    EncoderMath::VelocityFilter velocity;
+    Seqlock<Snapshot> snapshot;
+    volatile bool changed = false;
+    volatile int64_t changedAtUs = 0;
+    TaskHandle_t notifyTask = NULL;
+
+    // Consumer side, guarded by mux
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+    int32_t consumedDetents = 0;
+    int32_t residueQ8 = 0;
+    long value = 0;
+    long minValue = LONG_MIN;
+    long maxValue = LONG_MAX;
+    bool circleValues = false;
+    AccelerationCurve curve;
+};
 
 // Declare the global service instance
-extern DRAM_ATTR AiEsp32RotaryEncoder leftEncoder;
-extern DRAM_ATTR AiEsp32RotaryEncoder rightEncoder;
+extern RotaryEncoder leftEncoder;
+extern RotaryEncoder rightEncoder;
 
 void initEncoderService();
 
@@ -21,4 +99,7 @@ bool hasRightEncoderChanged();
 bool hasLeftEncoderChanged(bool reset);
 bool hasRightEncoderChanged(bool reset);
 
-#endif  // ENCODER_SERVICE_H
\ No newline at end of file
+// esp_timer time of the last right encoder step, for input latency logging.
+int64_t getRightEncoderChangedAtUs();
+
+#endif  // ENCODER_SERVICE_H
@@ -0,0 +1,365 @@
+#include "feedback.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+static const char *TAG = "FEEDBACK";
+
+// LEDC channel 0 is the buzzer's; see the channel map in display.cpp.
+static const uint8_t BUZZER_LEDC_CHANNEL = 0;
+
+// Cues waiting behind a higher priority one. A full queue drops the newest
+// lowest priority request.
+static const uint8_t QUEUE_LENGTH = 4;
+// A queued cue that could not start within this long is dropped.
+static const int64_t STALE_US = 500 * 1000;
+// Request-to-first-output latency is logged once per this many cues.
+static const int LATENCY_STATS_CUES = 16;
+
+namespace {
+    // Buzzer steps are a frequency in Hz, vibrator steps are on (1) or off
+    // (0). 0 Hz is a rest.
+    struct Step {
+        uint16_t level;
+        uint16_t durationMs;
+    };
+
+    struct Track {
+        const Step *steps;
+        uint8_t count;
+    };
+
+    struct Pattern {
+        FeedbackCue cue;
+        FeedbackPriority priority;
+        Track buzzer;
+        Track vibrator;
+    };
+
+    template <size_t N>
+    constexpr Track track(const Step (&steps)[N]) {
+        return Track{steps, static_cast<uint8_t>(N)};
+    }
+
+    constexpr Track NO_TRACK = {nullptr, 0};
+
+    // Buzzer tracks. Repeated notes need a rest between them to be heard.
+    constexpr Step marioCoinTones[] = {{2637, 100}, {3136, 150}};
+    constexpr Step singleBeepTones[] = {{1000, 100}};
+    constexpr Step doubleBeepTones[] = {{1000, 100}, {0, 20}, {1000, 100}};
+    constexpr Step tripleBeepTones[] = {{1000, 100}, {0, 20}, {1000, 100},
+                                        {0, 20},     {1000, 100}};
+    constexpr Step errorBeepTones[] = {{300, 100}};
+    constexpr Step bootTones[] = {{523, 100}, {659, 100}, {784, 100},
+                                  {1047, 150}};
+    constexpr Step shutdownTones[] = {{1047, 100}, {784, 100}, {659, 100},
+                                      {523, 150}};
+    constexpr Step connectedTones[] = {{1047, 100}, {1319, 100}, {1568, 150}};
+    constexpr Step disconnectedTones[] = {{1568, 100}, {1319, 100},
+                                          {1047, 150}};
+    constexpr Step pausedTones[] = {{800, 150}, {0, 20}, {800, 150}};
+    constexpr Step playTones[] = {{1200, 100}, {1400, 100}};
+
+    // Vibrator tracks. The ones paired with a tune tap on each note.
+    constexpr Step singlePulse[] = {{1, 50}};
+    constexpr Step doublePulse[] = {{1, 50}, {0, 200}, {1, 50}};
+    constexpr Step triplePulse[] = {{1, 10}, {0, 50}, {1, 20}, {0, 50}, {1, 30}};
+    constexpr Step errorPulse[] = {{1, 500}};
+    constexpr Step twoNotePulses[] = {{1, 60}, {0, 40}, {1, 60}};
+    constexpr Step threeNotePulses[] = {{1, 60}, {0, 40}, {1, 60}, {0, 40},
+                                        {1, 150}};
+    constexpr Step fourNotePulses[] = {{1, 60}, {0, 40}, {1, 60}, {0, 40},
+                                       {1, 60}, {0, 40}, {1, 150}};
+    constexpr Step pausedPulses[] = {{1, 150}, {0, 20}, {1, 150}};
+
+    // Indexed by FeedbackCue.
+    constexpr Pattern PATTERNS[] = {
+        {FeedbackCue::MARIO_COIN, FeedbackPriority::Normal,
+         track(marioCoinTones), NO_TRACK},
+        {FeedbackCue::SINGLE_BEEP, FeedbackPriority::Normal,
+         track(singleBeepTones), NO_TRACK},
+        {FeedbackCue::DOUBLE_BEEP, FeedbackPriority::Normal,
+         track(doubleBeepTones), NO_TRACK},
+        {FeedbackCue::TRIPLE_BEEP, FeedbackPriority::Normal,
+         track(tripleBeepTones), NO_TRACK},
+        {FeedbackCue::ERROR_BEEP, FeedbackPriority::Alert,
+         track(errorBeepTones), NO_TRACK},
+        {FeedbackCue::SINGLE_PULSE, FeedbackPriority::Normal, NO_TRACK,
+         track(singlePulse)},
+        {FeedbackCue::DOUBLE_PULSE, FeedbackPriority::Normal, NO_TRACK,
+         track(doublePulse)},
+        {FeedbackCue::TRIPLE_PULSE, FeedbackPriority::Normal, NO_TRACK,
+         track(triplePulse)},
+        {FeedbackCue::ERROR_PULSE, FeedbackPriority::Alert, NO_TRACK,
+         track(errorPulse)},
+        {FeedbackCue::BOOT, FeedbackPriority::Normal, track(bootTones),
+         track(singlePulse)},
+        {FeedbackCue::SHUTDOWN, FeedbackPriority::Critical,
+         track(shutdownTones), track(fourNotePulses)},
+        {FeedbackCue::DEVICE_CONNECTED, FeedbackPriority::Alert,
+         track(connectedTones), track(threeNotePulses)},
+        {FeedbackCue::DEVICE_DISCONNECTED, FeedbackPriority::Alert,
+         track(disconnectedTones), track(threeNotePulses)},
+        {FeedbackCue::PAUSED, FeedbackPriority::Alert, track(pausedTones),
+         track(pausedPulses)},
+        {FeedbackCue::PLAY, FeedbackPriority::Normal, track(playTones),
+         track(twoNotePulses)},
+    };
+
+    constexpr bool patternsInCueOrder(size_t i = 0) {
+        return i == sizeof(PATTERNS) / sizeof(PATTERNS[0]) ||
+               (PATTERNS[i].cue == static_cast<FeedbackCue>(i) &&
+                patternsInCueOrder(i + 1));
+    }
+    static_assert(sizeof(PATTERNS) / sizeof(PATTERNS[0]) ==
+                      static_cast<size_t>(FeedbackCue::COUNT),
+                  "Every FeedbackCue needs a pattern");
+    static_assert(patternsInCueOrder(), "PATTERNS must follow FeedbackCue");
+
+    struct Request {
+        FeedbackCue cue;
+        int64_t requestedUs;
+    };
+
+    // Playback position on one output.
+    struct Channel {
+        Track track;
+        uint8_t index;
+        int64_t stepEndUs;
+
+        bool active() const { return index < track.count; }
+    };
+}  // namespace
+
+static esp_timer_handle_t feedbackTimer = nullptr;
+
+// Shared with playFeedback() and stopFeedback(); guarded by feedbackMux.
+static portMUX_TYPE feedbackMux = portMUX_INITIALIZER_UNLOCKED;
+static Request queue[QUEUE_LENGTH];  // highest priority first, then oldest
+static uint8_t queueLength = 0;
+static bool stopRequested = false;
+
+// Only touched by the timer callback.
+static const Pattern *playing = nullptr;
+static Channel buzzer;
+static Channel vibrator;
+static int latencyCues = 0;
+static int64_t latencyTotalUs = 0;
+static int64_t latencyPeakUs = 0;
+
+static void setBuzzer(uint16_t frequency) {
+    // A frequency of 0 silences the channel.
+    ledcWriteTone(BUZZER_LEDC_CHANNEL, frequency);
+}
+
+static void setVibrator(uint16_t level) {
+    digitalWrite(pins::VIBRATOR_PIN, level != 0 ? HIGH : LOW);
+}
+
+static void silence() {
+    setBuzzer(0);
+    setVibrator(0);
+}
+
+// Moves `channel` past every step that has ended by `now`. Step ends are
+// measured from the start of the cue, so late callbacks do not add drift.
+static void advance(Channel &channel, int64_t now, void (*output)(uint16_t)) {
+    if (!channel.active() || now < channel.stepEndUs) {
+        return;
+    }
+    while (channel.active() && now >= channel.stepEndUs) {
+        channel.index++;
+        if (channel.active()) {
+            channel.stepEndUs +=
+                channel.track.steps[channel.index].durationMs * 1000LL;
+        }
+    }
+    output(channel.active() ? channel.track.steps[channel.index].level : 0);
+}
+
+static void start(Channel &channel, const Track &track, int64_t now,
+                  void (*output)(uint16_t)) {
+    channel.track = track;
+    channel.index = 0;
+    if (track.count == 0) {
+        output(0);
+        return;
+    }
+    channel.stepEndUs = now + track.steps[0].durationMs * 1000LL;
+    output(track.steps[0].level);
+}
+
+static void recordLatency(const Request &request) {
+    int64_t latencyUs = esp_timer_get_time() - request.requestedUs;
+    ESP_LOGV(TAG, "Cue %d started %lld us after request",
+             static_cast<int>(request.cue), latencyUs);
+
+    latencyTotalUs += latencyUs;
+    latencyPeakUs = max(latencyPeakUs, latencyUs);
+    if (++latencyCues >= LATENCY_STATS_CUES) {
+        ESP_LOGD(TAG, "Latency: %lld us avg, %lld us peak over %d cues",
+                 latencyTotalUs / latencyCues, latencyPeakUs, latencyCues);
+        latencyCues = 0;
+        latencyTotalUs = 0;
+        latencyPeakUs = 0;
+    }
+}
+
+// One link of the one-shot chain: brings both outputs up to date, starts the
+// next queued cue if it may play now, and arms the timer for the next step.
+static void onFeedbackTimer(void *arg) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&feedbackMux);
+    bool stop = stopRequested;
+    stopRequested = false;
+    portEXIT_CRITICAL(&feedbackMux);
+
+    if (stop) {
+        playing = nullptr;
+        buzzer.index = buzzer.track.count;
+        vibrator.index = vibrator.track.count;
+        silence();
+    } else {
+        advance(buzzer, now, setBuzzer);
+        advance(vibrator, now, setVibrator);
+        if (!buzzer.active() && !vibrator.active()) {
+            playing = nullptr;
+        }
+    }
+
+    bool hasNext = false;
+    Request next = {FeedbackCue::BOOT, 0};
+    int stale = 0;
+    portENTER_CRITICAL(&feedbackMux);
+    while (queueLength > 0) {
+        const Request &front = queue[0];
+        bool mayStart = playing == nullptr ||
+                        PATTERNS[static_cast<size_t>(front.cue)].priority >=
+                            playing->priority;
+        bool isStale = now - front.requestedUs > STALE_US;
+        if (!mayStart && !isStale) {
+            break;
+        }
+        next = front;
+        for (uint8_t i = 1; i < queueLength; i++) {
+            queue[i - 1] = queue[i];
+        }
+        queueLength--;
+        if (!isStale) {
+            hasNext = true;
+            break;
+        }
+        stale++;
+    }
+    portEXIT_CRITICAL(&feedbackMux);
+
+    if (stale > 0) {
+        ESP_LOGD(TAG, "Dropped %d stale cue(s)", stale);
+    }
+
+    if (hasNext) {
+        const Pattern &pattern = PATTERNS[static_cast<size_t>(next.cue)];
+        if (playing != nullptr) {
+            ESP_LOGV(TAG, "Cue %d interrupts cue %d",
+                     static_cast<int>(next.cue),
+                     static_cast<int>(playing->cue));
+        }
+        playing = &pattern;
+        start(buzzer, pattern.buzzer, now, setBuzzer);
+        start(vibrator, pattern.vibrator, now, setVibrator);
+        recordLatency(next);
+    }
+
+    if (playing == nullptr) {
+        return;
+    }
+
+    int64_t nextUs = INT64_MAX;
+    if (buzzer.active()) {
+        nextUs = buzzer.stepEndUs;
+    }
+    if (vibrator.active()) {
+        nextUs = min(nextUs, vibrator.stepEndUs);
+    }
+    int64_t delayUs = nextUs - esp_timer_get_time();
+    // Fails only if a request re-armed the timer meanwhile, in which case
+    // that callback catches up on this step.
+    esp_timer_start_once(feedbackTimer, delayUs > 0 ? delayUs : 0);
+}
+
+// Runs the timer callback as soon as possible.
+static void kickTimer() {
+    if (feedbackTimer == nullptr) {
+        return;
+    }
+    // The callback may re-arm the timer between the stop and the start, in
+    // which case the start fails; stop it again and retry.
+    for (int attempt = 0; attempt < 3; attempt++) {
+        esp_timer_stop(feedbackTimer);
+        if (esp_timer_start_once(feedbackTimer, 0) == ESP_OK) {
+            return;
+        }
+    }
+    ESP_LOGW(TAG, "Could not restart the feedback timer");
+}
+
+void initFeedback() {
+    ledcSetup(BUZZER_LEDC_CHANNEL, 1000, 10);
+    ledcAttachPin(pins::BUZZER_PIN, BUZZER_LEDC_CHANNEL);
+    ledcWrite(BUZZER_LEDC_CHANNEL, 0);
+
+    pinMode(pins::VIBRATOR_PIN, OUTPUT);
+    digitalWrite(pins::VIBRATOR_PIN, LOW);
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = onFeedbackTimer;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "feedback";
+    ESP_ERROR_CHECK(esp_timer_create(&timerArgs, &feedbackTimer));
+}
+
+void playFeedback(FeedbackCue cue) {
+    if (cue >= FeedbackCue::COUNT) {
+        return;
+    }
+    Request request = {cue, esp_timer_get_time()};
+    FeedbackPriority priority = PATTERNS[static_cast<size_t>(cue)].priority;
+
+    bool queued = true;
+    portENTER_CRITICAL(&feedbackMux);
+    // Behind everything of the same or higher priority.
+    uint8_t position = 0;
+    while (position < queueLength &&
+           PATTERNS[static_cast<size_t>(queue[position].cue)].priority >=
+               priority) {
+        position++;
+    }
+    if (position == QUEUE_LENGTH) {
+        queued = false;
+    } else {
+        uint8_t last = queueLength < QUEUE_LENGTH ? queueLength
+                                                  : QUEUE_LENGTH - 1;
+        for (uint8_t i = last; i > position; i--) {
+            queue[i] = queue[i - 1];
+        }
+        queue[position] = request;
+        queueLength = last + 1;
+    }
+    portEXIT_CRITICAL(&feedbackMux);
+
+    if (!queued) {
+        ESP_LOGD(TAG, "Queue full, dropped cue %d", static_cast<int>(cue));
+        return;
+    }
+    kickTimer();
+}
+
+void stopFeedback() {
+    portENTER_CRITICAL(&feedbackMux);
+    queueLength = 0;
+    stopRequested = true;
+    portEXIT_CRITICAL(&feedbackMux);
+
+    kickTimer();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "pins.h"
+
+// Buzzer and vibrator cues. A cue may drive both outputs; they start on the
+// same timer tick and stay in step.
+enum class FeedbackCue : uint8_t {
+    MARIO_COIN,
+    SINGLE_BEEP,
+    DOUBLE_BEEP,
+    TRIPLE_BEEP,
+    ERROR_BEEP,
+    SINGLE_PULSE,  // Single vibration pulse
+    DOUBLE_PULSE,  // Two vibration pulses
+    TRIPLE_PULSE,  // Three vibration pulses
+    ERROR_PULSE,   // Long error pulse
+    BOOT,
+    SHUTDOWN,
+    DEVICE_CONNECTED,
+    DEVICE_DISCONNECTED,
+    PAUSED,
+    PLAY,
+    COUNT
+};
+
+// A cue interrupts the one playing if its priority is at least as high;
+// otherwise it waits for it to finish, and is dropped if it waited too long
+// to still mean anything.
+enum class FeedbackPriority : uint8_t {
+    Normal,
+    Alert,
+    Critical,
+};
+
+// Sets up both outputs.
+void initFeedback();
+
+// Queues `cue`. Returns immediately; playback runs on the esp_timer task.
+void playFeedback(FeedbackCue cue);
+
+// Silences both outputs and drops every queued cue.
+void stopFeedback();
@@ -0,0 +1,206 @@
+#include "heap.h"
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "services/battery.h"
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "HEAP";
+
+enum class Placement : uint8_t {
+    // PSRAM, else nothing.
+    SpiramOnly,
+    // PSRAM, else internal RAM while the reserve stays free.
+    SpiramAboveReserve,
+    // PSRAM, else internal RAM.
+    SpiramFirst,
+};
+
+struct HeapUserInfo {
+    const char *name;
+    Placement placement;
+};
+
+static const HeapUserInfo USERS[] = {
+    {"json", Placement::SpiramAboveReserve},
+    {"devices", Placement::SpiramFirst},
+    {"menus", Placement::SpiramFirst},
+    {"strings", Placement::SpiramFirst},
+    {"text", Placement::SpiramOnly},
+};
+static_assert(sizeof(USERS) / sizeof(USERS[0]) ==
+                  static_cast<size_t>(HeapUser::COUNT),
+              "USERS must match HeapUser");
+
+static const uint32_t SPIRAM_CAPS = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+static const uint32_t INTERNAL_CAPS = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+
+// Put in front of every block so frees can be counted. Eight bytes keep the
+// payload as aligned as heap_caps_malloc's own result.
+struct BlockHeader {
+    uint32_t size;
+    uint8_t internal;
+    uint8_t padding[3];
+};
+static_assert(sizeof(BlockHeader) == 8, "BlockHeader must stay 8 bytes");
+
+static portMUX_TYPE heapMux = portMUX_INITIALIZER_UNLOCKED;
+static HeapUsage usage[static_cast<size_t>(HeapUser::COUNT)];
+
+static void *allocateFor(Placement placement, size_t total, bool &internal) {
+    internal = false;
+    void *block = heap_caps_malloc(total, SPIRAM_CAPS);
+    if (block != nullptr || placement == Placement::SpiramOnly) {
+        return block;
+    }
+    if (placement == Placement::SpiramAboveReserve &&
+        heap_caps_get_free_size(INTERNAL_CAPS) < total + HEAP_INTERNAL_RESERVE) {
+        return nullptr;
+    }
+    internal = true;
+    return heap_caps_malloc(total, INTERNAL_CAPS);
+}
+
+void *placedMalloc(HeapUser user, size_t size) {
+    size_t index = static_cast<size_t>(user);
+    bool internal;
+    auto *header = static_cast<BlockHeader *>(allocateFor(
+        USERS[index].placement, sizeof(BlockHeader) + size, internal));
+
+    portENTER_CRITICAL(&heapMux);
+    HeapUsage &entry = usage[index];
+    if (header == nullptr) {
+        entry.failures++;
+    } else {
+        entry.bytes += size;
+        entry.peakBytes = max(entry.peakBytes, entry.bytes);
+        entry.allocations++;
+        if (internal) {
+            entry.internalBytes += size;
+        }
+    }
+    portEXIT_CRITICAL(&heapMux);
+
+    if (header == nullptr) {
+        return nullptr;
+    }
+    header->size = size;
+    header->internal = internal;
+    return header + 1;
+}
+
+void placedFree(HeapUser user, void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    BlockHeader *header = static_cast<BlockHeader *>(ptr) - 1;
+
+    portENTER_CRITICAL(&heapMux);
+    HeapUsage &entry = usage[static_cast<size_t>(user)];
+    entry.bytes -= header->size;
+    entry.allocations--;
+    if (header->internal) {
+        entry.internalBytes -= header->size;
+    }
+    portEXIT_CRITICAL(&heapMux);
+
+    heap_caps_free(header);
+}
+
+// Always moves, so a block that had to fall back to internal RAM goes back
+// to PSRAM as soon as there is room.
+void *placedRealloc(HeapUser user, void *ptr, size_t size) {
+    if (ptr == nullptr) {
+        return placedMalloc(user, size);
+    }
+    void *moved = placedMalloc(user, size);
+    if (moved == nullptr) {
+        return nullptr;
+    }
+    const BlockHeader *header = static_cast<const BlockHeader *>(ptr) - 1;
+    memcpy(moved, ptr, min(size, (size_t)header->size));
+    placedFree(user, ptr);
+    return moved;
+}
+
+HeapUsage getHeapUsage(HeapUser user) {
+    portENTER_CRITICAL(&heapMux);
+    HeapUsage copy = usage[static_cast<size_t>(user)];
+    portEXIT_CRITICAL(&heapMux);
+    return copy;
+}
+
+static void printHeap(const char *name, uint32_t caps) {
+    ESP_LOGI(TAG, "%-8s %8u free %8u largest %8u lowest", name,
+             (unsigned)heap_caps_get_free_size(caps),
+             (unsigned)heap_caps_get_largest_free_block(caps),
+             (unsigned)heap_caps_get_minimum_free_size(caps));
+}
+
+void printHeapCensus() {
+    uint32_t totalBytes = 0;
+    ESP_LOGI(TAG, "%-8s %8s %8s %8s %8s %6s", "user", "bytes", "peak",
+             "internal", "blocks", "failed");
+    for (size_t i = 0; i < static_cast<size_t>(HeapUser::COUNT); i++) {
+        HeapUsage entry = getHeapUsage(static_cast<HeapUser>(i));
+        totalBytes += entry.bytes;
+        ESP_LOGI(TAG, "%-8s %8lu %8lu %8lu %8lu %6lu", USERS[i].name,
+                 (unsigned long)entry.bytes, (unsigned long)entry.peakBytes,
+                 (unsigned long)entry.internalBytes,
+                 (unsigned long)entry.allocations,
+                 (unsigned long)entry.failures);
+    }
+    ESP_LOGI(TAG, "%lu bytes placed", (unsigned long)totalBytes);
+    printHeap("internal", INTERNAL_CAPS);
+    printHeap("dma", MALLOC_CAP_DMA);
+    printHeap("psram", SPIRAM_CAPS);
+}
+
+class PlacedJsonAllocator : public ArduinoJson::Allocator {
+  public:
+    void *allocate(size_t size) override {
+        return placedMalloc(HeapUser::Json, size);
+    }
+    void deallocate(void *ptr) override { placedFree(HeapUser::Json, ptr); }
+    void *reallocate(void *ptr, size_t size) override {
+        return placedRealloc(HeapUser::Json, ptr, size);
+    }
+};
+
+ArduinoJson::Allocator *jsonAllocator() {
+    static PlacedJsonAllocator allocator;
+    return &allocator;
+}
+
+// Trace builds read the monitor in the trace console, which handles 'h' and
+// 'b' too.
+#if CORE_DEBUG_LEVEL >= ARDUHAL_LOG_LEVEL_INFO && !defined(ENABLE_TRACE)
+#define HEAP_CENSUS_CONSOLE 1
+static StaticTask<3 * configMINIMAL_STACK_SIZE> heapConsoleTask;
+
+static void heapConsoleLoop(void *pvParameters) {
+    while (true) {
+        while (Serial.available() > 0) {
+            switch (Serial.read()) {
+                case 'h':
+                    printHeapCensus();
+                    break;
+                case 'b':
+                    printBatteryReport();
+                    break;
+                default:
+                    break;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+#endif
+
+void initHeapCensus() {
+#ifdef HEAP_CENSUS_CONSOLE
+    heapConsoleTask.start(heapConsoleLoop, "heapConsole", NULL,
+                          tskIDLE_PRIORITY, 0);
+    ESP_LOGI(TAG, "Send 'h' for a heap census, 'b' for a battery report");
+#endif
+}
@@ -0,0 +1,110 @@
+#ifndef HEAP_SERVICE_H
+#define HEAP_SERVICE_H
+
+#include <Arduino.h>
+
+#include <ArduinoJson.h>
+
+#include <new>
+
+/**
+ * Decides which heap each subsystem's data lives in, and counts it.
+ *
+ * Internal RAM is kept for what cannot live anywhere else: DMA buffers
+ * (display, SPI), the BLE controller and host, task stacks. Bulk data goes to
+ * PSRAM through placedMalloc, tagged with the subsystem that owns it:
+ *
+ *   Json     documents parsed from BLE or LittleFS; PSRAM, or internal RAM
+ *            only while more than HEAP_INTERNAL_RESERVE stays free. A
+ *            document that gets nothing reports NoMemory, like a full one.
+ *   Devices  the session arena (sessionArena.h) and anything overflowing it.
+ *   Menus    menu lists read from the device.
+ *   Strings  device menu names and descriptions (StringPool).
+ *            These three fall back to internal RAM when PSRAM is missing or
+ *            full, as plain new would.
+ *   Text     glyph atlases and the run buffer; PSRAM only, the text code
+ *            falls back to drawing through GFX.
+ *
+ * Containers take a PlacedAllocator, JsonDocuments take jsonAllocator().
+ * printHeapCensus() logs the bytes each subsystem holds next to the free
+ * space in each heap. In development builds, send 'h' over the monitor to
+ * log it.
+ */
+
+#ifndef HEAP_INTERNAL_RESERVE
+#define HEAP_INTERNAL_RESERVE (48 * 1024)
+#endif
+
+enum class HeapUser : uint8_t {
+    Json,
+    Devices,
+    Menus,
+    Strings,
+    Text,
+    COUNT,
+};
+
+struct HeapUsage {
+    uint32_t bytes;
+    uint32_t peakBytes;
+    uint32_t allocations;
+    // Of `bytes`, those that had to go to internal RAM.
+    uint32_t internalBytes;
+    // Requests that got nothing.
+    uint32_t failures;
+};
+
+// Null when the subsystem's placement has no room left.
+void *placedMalloc(HeapUser user, size_t size);
+void *placedRealloc(HeapUser user, void *ptr, size_t size);
+void placedFree(HeapUser user, void *ptr);
+
+HeapUsage getHeapUsage(HeapUser user);
+
+// Logs bytes per subsystem and free space per heap.
+void printHeapCensus();
+
+// In development builds, starts listening for the census command.
+void initHeapCensus();
+
+// For JsonDocument; tagged HeapUser::Json.
+ArduinoJson::Allocator *jsonAllocator();
+
+// std::allocator that places its memory for `User`.
+template <class T, HeapUser User>
+struct PlacedAllocator {
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = PlacedAllocator<U, User>;
+    };
+
+    PlacedAllocator() noexcept = default;
+    template <class U>
+    PlacedAllocator(const PlacedAllocator<U, User> &) noexcept {}
+
+    T *allocate(size_t count) {
+        void *ptr = placedMalloc(User, count * sizeof(T));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(ptr);
+    }
+
+    void deallocate(T *ptr, size_t) noexcept { placedFree(User, ptr); }
+};
+
+template <class T, class U, HeapUser User>
+bool operator==(const PlacedAllocator<T, User> &,
+                const PlacedAllocator<U, User> &) {
+    return true;
+}
+
+template <class T, class U, HeapUser User>
+bool operator!=(const PlacedAllocator<T, User> &,
+                const PlacedAllocator<U, User> &) {
+    return false;
+}
+
+#endif  // HEAP_SERVICE_H
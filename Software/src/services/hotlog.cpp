@@ -0,0 +1,158 @@
+#include "hotlog.h"
+
+#include <freertos/queue.h>
+
+#include <atomic>
+
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "HOTLOG";
+
+static const size_t QUEUE_LENGTH = 32;
+static const size_t LINE_BYTES = 192;
+
+static StaticQueue<HotLogRecord, QUEUE_LENGTH> hotLogQueueMemory;
+static StaticTask<4 * configMINIMAL_STACK_SIZE> hotLogDrainTaskMemory;
+static QueueHandle_t hotLogQueue = NULL;
+static std::atomic<uint32_t> droppedRecords(0);
+
+static const char LEVEL_LETTERS[] = {'N', 'E', 'W', 'I', 'D', 'V'};
+
+// Expands one conversion, `spec` without its length modifiers, into `out`.
+static int formatArg(char *out, size_t size, const char *spec, char conversion,
+                     const HotLogRecord &record, size_t index) {
+    if (index >= record.argCount) {
+        return snprintf(out, size, "?");
+    }
+    uintptr_t raw = record.args[index];
+    HotLogArg kind = record.kinds[index];
+
+    switch (conversion) {
+        case 's':
+            if (kind == HotLogArg::String) {
+                return snprintf(out, size, spec, record.strings + raw);
+            }
+            if (kind == HotLogArg::StaticString) {
+                return snprintf(out, size, spec,
+                                reinterpret_cast<const char *>(raw));
+            }
+            return snprintf(out, size, "?");
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G': {
+            float value = 0.0f;
+            if (kind == HotLogArg::Float) {
+                uint32_t bits = (uint32_t)raw;
+                memcpy(&value, &bits, sizeof(value));
+            } else {
+                value = kind == HotLogArg::Int ? (float)(int32_t)raw
+                                               : (float)(uint32_t)raw;
+            }
+            return snprintf(out, size, spec, (double)value);
+        }
+        case 'p':
+            return snprintf(out, size, spec, reinterpret_cast<void *>(raw));
+        case 'c':
+            return snprintf(out, size, spec, (int)raw);
+        case 'd':
+        case 'i':
+            return snprintf(out, size, spec, (long)(int32_t)raw);
+        default:  // o, u, x, X
+            return snprintf(out, size, spec, (unsigned long)(uint32_t)raw);
+    }
+}
+
+// printf for a captured record. Integer conversions are widened to long so
+// one code path serves every length modifier.
+static void formatRecord(const HotLogRecord &record, char *line, size_t size) {
+    size_t length = 0;
+    size_t argIndex = 0;
+    const char *p = record.format;
+
+    while (*p != '\0' && length + 1 < size) {
+        if (*p != '%') {
+            line[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            line[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conversion
+        char spec[16];
+        size_t specLength = 0;
+        spec[specLength++] = *p++;
+        while (*p != '\0' && strchr("-+ #0123456789.", *p) != nullptr &&
+               specLength < sizeof(spec) - 3) {
+            spec[specLength++] = *p++;
+        }
+        while (*p != '\0' && strchr("hlLzjt", *p) != nullptr) {
+            p++;
+        }
+        char conversion = *p;
+        if (conversion == '\0') {
+            break;
+        }
+        p++;
+        if (strchr("diouxX", conversion) != nullptr) {
+            spec[specLength++] = 'l';
+        }
+        spec[specLength++] = conversion;
+        spec[specLength] = '\0';
+
+        int written = formatArg(line + length, size - length, spec, conversion,
+                                record, argIndex++);
+        if (written > 0) {
+            length = min(length + (size_t)written, size - 1);
+        }
+    }
+    line[length] = '\0';
+}
+
+static void writeRecord(const HotLogRecord &record) {
+    char line[LINE_BYTES];
+    formatRecord(record, line, sizeof(line));
+    char letter = record.level < sizeof(LEVEL_LETTERS)
+                      ? LEVEL_LETTERS[record.level]
+                      : '?';
+    log_printf("[%6lu][%c][%s] %s\r\n", (unsigned long)record.timestampMs,
+               letter, record.tag, line);
+}
+
+static void hotLogDrainTask(void *pvParameters) {
+    HotLogRecord record;
+    while (true) {
+        xQueueReceive(hotLogQueue, &record, portMAX_DELAY);
+        writeRecord(record);
+
+        uint32_t dropped = droppedRecords.exchange(0);
+        if (dropped > 0) {
+            ESP_LOGW(TAG, "Dropped %lu messages, queue full",
+                     (unsigned long)dropped);
+        }
+    }
+}
+
+void initHotLog() {
+#if HOTLOG_DEFERRED
+    hotLogQueue = hotLogQueueMemory.create();
+    // Idle priority: formatting only happens when nothing else wants the CPU.
+    hotLogDrainTaskMemory.start(hotLogDrainTask, "hotLogDrain", NULL,
+                                tskIDLE_PRIORITY, 0);
+#endif
+}
+
+void submitHotLog(const HotLogRecord &record) {
+    if (hotLogQueue == NULL) {
+        writeRecord(record);
+        return;
+    }
+    if (xQueueSend(hotLogQueue, &record, 0) != pdTRUE) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,177 @@
+#ifndef HOTLOG_SERVICE_H
+#define HOTLOG_SERVICE_H
+
+#include <Arduino.h>
+
+#include <string>
+#include <type_traits>
+
+#include "esp_log.h"
+
+/**
+ * Logging for hot paths (BLE writes, redraws, state machine events).
+ *
+ * HOT_LOGx(TAG, format, args...) copies the format pointer and raw arguments
+ * into a queue and returns; a drain task at idle priority does the
+ * formatting and the UART write. Strings are copied, up to
+ * HOTLOG_STRING_BYTES for all of one message's strings together. Integers
+ * are stored as 32 bits, so %ll conversions are not supported, nor are `*`
+ * widths. Call from tasks only, not ISRs.
+ *
+ * Each tag has a compile-time level, HOTLOG_LEVEL_<TAG>, defaulting to
+ * CORE_DEBUG_LEVEL. Messages above it compile to nothing, arguments
+ * included. Build with -D HOTLOG_DEFERRED=0 to format in the caller instead,
+ * e.g. to compare timings.
+ */
+
+#ifndef HOTLOG_DEFERRED
+#define HOTLOG_DEFERRED 1
+#endif
+
+#ifndef HOTLOG_DEFAULT_LEVEL
+#ifdef CORE_DEBUG_LEVEL
+#define HOTLOG_DEFAULT_LEVEL CORE_DEBUG_LEVEL
+#else
+#define HOTLOG_DEFAULT_LEVEL ESP_LOG_INFO
+#endif
+#endif
+
+#ifndef HOTLOG_LEVEL_DEVICE
+#define HOTLOG_LEVEL_DEVICE HOTLOG_DEFAULT_LEVEL
+#endif
+#ifndef HOTLOG_LEVEL_COMS
+#define HOTLOG_LEVEL_COMS HOTLOG_DEFAULT_LEVEL
+#endif
+#ifndef HOTLOG_LEVEL_STATE_MACHINE
+#define HOTLOG_LEVEL_STATE_MACHINE HOTLOG_DEFAULT_LEVEL
+#endif
+#ifndef HOTLOG_LEVEL_DYNAMIC_TEXT
+#define HOTLOG_LEVEL_DYNAMIC_TEXT HOTLOG_DEFAULT_LEVEL
+#endif
+
+static const size_t HOTLOG_MAX_ARGS = 6;
+static const size_t HOTLOG_STRING_BYTES = 64;
+
+enum class HotLogArg : uint8_t {
+    Int,
+    Uint,
+    Float,
+    String,        // offset into HotLogRecord::strings
+    StaticString,  // pointer that outlives the record
+};
+
+struct HotLogRecord {
+    uint32_t timestampMs;
+    const char *tag;
+    const char *format;
+    uint8_t level;
+    uint8_t argCount;
+    uint8_t stringBytes;
+    HotLogArg kinds[HOTLOG_MAX_ARGS];
+    uintptr_t args[HOTLOG_MAX_ARGS];
+    char strings[HOTLOG_STRING_BYTES];
+};
+
+// Wraps a string that stays valid for good (a literal, a type name) so it is
+// logged by pointer instead of being copied.
+struct HotLogStatic {
+    const char *text;
+};
+
+// Starts the drain task. Messages logged before this are formatted in place.
+void initHotLog();
+
+// Queues `record`, or formats it in place when deferring is off or the
+// drain task is not running. Drops it if the queue is full.
+void submitHotLog(const HotLogRecord &record);
+
+namespace hotlog {
+
+inline void copyString(HotLogRecord &record, const char *text) {
+    size_t offset = record.stringBytes;
+    size_t room = HOTLOG_STRING_BYTES - offset;
+    record.kinds[record.argCount] = HotLogArg::String;
+    record.args[record.argCount] = offset;
+    if (room == 0) {
+        // Out of room; point at the terminator of the previous string.
+        record.args[record.argCount] = HOTLOG_STRING_BYTES - 1;
+        return;
+    }
+    size_t length = strlcpy(record.strings + offset, text ? text : "(null)",
+                            room);
+    record.stringBytes = offset + min(length + 1, room);
+}
+
+inline void capture(HotLogRecord &record, const char *text) {
+    copyString(record, text);
+}
+inline void capture(HotLogRecord &record, const std::string &text) {
+    copyString(record, text.c_str());
+}
+inline void capture(HotLogRecord &record, const String &text) {
+    copyString(record, text.c_str());
+}
+inline void capture(HotLogRecord &record, HotLogStatic text) {
+    record.kinds[record.argCount] = HotLogArg::StaticString;
+    record.args[record.argCount] = (uintptr_t)text.text;
+}
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value ||
+                               std::is_enum<T>::value>::type
+capture(HotLogRecord &record, T value) {
+    if constexpr (std::is_floating_point<T>::value) {
+        float asFloat = static_cast<float>(value);
+        uint32_t bits;
+        memcpy(&bits, &asFloat, sizeof(bits));
+        record.kinds[record.argCount] = HotLogArg::Float;
+        record.args[record.argCount] = bits;
+    } else if constexpr (std::is_signed<T>::value) {
+        record.kinds[record.argCount] = HotLogArg::Int;
+        record.args[record.argCount] = (uint32_t)(int32_t)value;
+    } else {
+        record.kinds[record.argCount] = HotLogArg::Uint;
+        record.args[record.argCount] = (uint32_t)value;
+    }
+}
+inline void capture(HotLogRecord &record, const void *pointer) {
+    record.kinds[record.argCount] = HotLogArg::Uint;
+    record.args[record.argCount] = (uintptr_t)pointer;
+}
+
+template <typename... Args>
+void log(uint8_t level, const char *tag, const char *format,
+         const Args &...args) {
+    static_assert(sizeof...(Args) <= HOTLOG_MAX_ARGS,
+                  "Too many arguments for a hot path log");
+    HotLogRecord record;
+    record.timestampMs = millis();
+    record.tag = tag;
+    record.format = format;
+    record.level = level;
+    record.argCount = 0;
+    record.stringBytes = 0;
+    (..., (capture(record, args), record.argCount++));
+    submitHotLog(record);
+}
+
+}  // namespace hotlog
+
+#define HOT_LOG(tag, level, format, ...)                       \
+    do {                                                       \
+        if ((level) <= HOTLOG_LEVEL_##tag) {                   \
+            hotlog::log((level), #tag, format, ##__VA_ARGS__); \
+        }                                                      \
+    } while (0)
+
+#define HOT_LOGE(tag, format, ...) \
+    HOT_LOG(tag, ESP_LOG_ERROR, format, ##__VA_ARGS__)
+#define HOT_LOGW(tag, format, ...) \
+    HOT_LOG(tag, ESP_LOG_WARN, format, ##__VA_ARGS__)
+#define HOT_LOGI(tag, format, ...) \
+    HOT_LOG(tag, ESP_LOG_INFO, format, ##__VA_ARGS__)
+#define HOT_LOGD(tag, format, ...) \
+    HOT_LOG(tag, ESP_LOG_DEBUG, format, ##__VA_ARGS__)
+#define HOT_LOGV(tag, format, ...) \
+    HOT_LOG(tag, ESP_LOG_VERBOSE, format, ##__VA_ARGS__)
+
+#endif  // HOTLOG_SERVICE_H
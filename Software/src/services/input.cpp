@@ -0,0 +1,371 @@
+#include "input.h"
+
+#include <driver/gpio.h>
+#include <esp_timer.h>
+#include <hal/gpio_ll.h>
+
+#include <atomic>
+
+#include "encoder.h"
+#include "esp_log.h"
+#include "trace.h"
+#include "utils/EncoderRouter.h"
+#include "utils/SpscQueue.h"
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "INPUT";
+
+// Edges inside this window after an accepted change are treated as bounce.
+// The first edge is accepted straight away, so this adds no latency.
+static const int64_t DEBOUNCE_US = 30 * 1000;
+static const int64_t DOUBLE_CLICK_US = 400 * 1000;
+static const int64_t LONG_PRESS_US = 800 * 1000;
+static const int64_t STATS_INTERVAL_US = 10 * 1000 * 1000;
+
+static const size_t MAX_LISTENERS = 8;
+
+// Indexed by InputButton.
+static DRAM_ATTR const uint8_t BUTTON_PINS[] = {
+    pins::BTN_L_SHOULDER, pins::BTN_R_SHOULDER, pins::BTN_UNDER_L,
+    pins::BTN_UNDER_C,    pins::BTN_UNDER_R,
+};
+static const size_t BUTTON_COUNT = static_cast<size_t>(InputButton::COUNT);
+static_assert(sizeof(BUTTON_PINS) == BUTTON_COUNT,
+              "BUTTON_PINS must list every InputButton");
+
+// Raw edge captured in the interrupt.
+struct EdgeSample {
+    uint8_t button;
+    uint8_t level;
+    int64_t timestampUs;
+};
+
+// All button interrupts are attached from the same core, so the shared GPIO
+// interrupt handler serialises them and the ISR is the only producer.
+static SpscQueue<EdgeSample, 64> edgeQueue;
+static volatile uint32_t droppedEdges = 0;
+
+struct ButtonState {
+    volatile bool pressed = false;
+    int64_t changedAtUs = 0;
+    // When to re-read the pin after the debounce window, 0 if not pending.
+    int64_t verifyAtUs = 0;
+    int64_t pressedAtUs = 0;
+    int64_t lastClickAtUs = 0;
+    bool longPressSent = false;
+};
+
+static ButtonState buttons[BUTTON_COUNT];
+
+static InputListener listeners[MAX_LISTENERS];
+static std::atomic<size_t> listenerCount{0};
+static portMUX_TYPE listenerMux = portMUX_INITIALIZER_UNLOCKED;
+
+static StaticTask<6 * configMINIMAL_STACK_SIZE> inputTaskMemory;
+static TaskHandle_t inputTaskHandle = NULL;
+
+// Held while handlers run, so swapping the route waits for an in-flight
+// dispatch to finish. Created on first use, as states set routes before the
+// input task starts.
+struct RouteLock {
+    static SemaphoreHandle_t handle() {
+        static StaticMutex buffer;
+        static SemaphoreHandle_t mutex = buffer.create();
+        return mutex;
+    }
+    void lock() { xSemaphoreTake(handle(), portMAX_DELAY); }
+    void unlock() { xSemaphoreGive(handle()); }
+};
+
+static EncoderRouter<RouteLock> encoderRouter;
+
+struct InputStats {
+    uint32_t wakeups = 0;
+    uint32_t edges = 0;
+    uint32_t encoderDispatches = 0;
+    uint32_t clicks = 0;
+    uint32_t totalClickLatencyUs = 0;
+    uint32_t maxClickLatencyUs = 0;
+};
+
+static InputStats stats;
+
+// While armed, every button is a low-level wakeup source for light sleep.
+// The first interrupt puts them back to edge triggering.
+static volatile bool wakeArmed = false;
+static portMUX_TYPE wakeMux = portMUX_INITIALIZER_UNLOCKED;
+
+static inline __attribute__((always_inline)) void restoreEdgeInterrupts() {
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        gpio_ll_wakeup_disable(&GPIO, static_cast<gpio_num_t>(BUTTON_PINS[i]));
+        gpio_ll_set_intr_type(&GPIO, static_cast<gpio_num_t>(BUTTON_PINS[i]),
+                              GPIO_INTR_ANYEDGE);
+    }
+}
+
+static void IRAM_ATTR onButtonEdge(void *arg) {
+    uint8_t index = static_cast<uint8_t>(reinterpret_cast<uintptr_t>(arg));
+    if (wakeArmed) {
+        // Woken by this button; a level interrupt would keep firing.
+        portENTER_CRITICAL_ISR(&wakeMux);
+        if (wakeArmed) {
+            restoreEdgeInterrupts();
+            wakeArmed = false;
+        }
+        portEXIT_CRITICAL_ISR(&wakeMux);
+    }
+    TRACE_INSTANT(ButtonEdge, index);
+    EdgeSample sample = {
+        index,
+        static_cast<uint8_t>(
+            gpio_get_level(static_cast<gpio_num_t>(BUTTON_PINS[index]))),
+        esp_timer_get_time()};
+    if (!edgeQueue.push(sample)) {
+        droppedEdges++;
+    }
+
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(inputTaskHandle, &higherPriorityTaskWoken);
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+static void dispatch(InputButton button, InputEventType type,
+                     int64_t timestampUs) {
+    InputEvent event = {button, type, timestampUs};
+    TRACE_SCOPE(ButtonDispatch, button);
+    size_t count = listenerCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        listeners[i](event);
+    }
+}
+
+static void commit(size_t index, bool pressed, int64_t timestampUs) {
+    ButtonState &state = buttons[index];
+    InputButton button = static_cast<InputButton>(index);
+
+    state.pressed = pressed;
+    state.changedAtUs = timestampUs;
+    state.verifyAtUs = timestampUs + DEBOUNCE_US;
+
+    if (pressed) {
+        state.pressedAtUs = timestampUs;
+        state.longPressSent = false;
+        dispatch(button, InputEventType::Press, timestampUs);
+        return;
+    }
+
+    dispatch(button, InputEventType::Release, timestampUs);
+    if (state.longPressSent) {
+        return;
+    }
+
+    dispatch(button, InputEventType::Click, timestampUs);
+
+    uint32_t latencyUs = esp_timer_get_time() - timestampUs;
+    stats.clicks++;
+    stats.totalClickLatencyUs += latencyUs;
+    stats.maxClickLatencyUs = max(stats.maxClickLatencyUs, latencyUs);
+
+    if (state.lastClickAtUs != 0 &&
+        timestampUs - state.lastClickAtUs <= DOUBLE_CLICK_US) {
+        state.lastClickAtUs = 0;
+        dispatch(button, InputEventType::DoubleClick, timestampUs);
+    } else {
+        state.lastClickAtUs = timestampUs;
+    }
+}
+
+static void dispatchEncoders() {
+    // Always read, so turns are applied as they happen even when nobody is
+    // listening.
+    long left = leftEncoder.readEncoder();
+    long right = rightEncoder.readEncoder();
+    TRACE_SCOPE(EncoderDispatch, right);
+    stats.encoderDispatches += encoderRouter.offer(left, right);
+}
+
+// Earliest time the task has to wake up without an edge, or 0 for never.
+static int64_t nextDeadline() {
+    int64_t deadline = 0;
+    for (const ButtonState &state : buttons) {
+        int64_t candidate = state.verifyAtUs;
+        if (state.pressed && !state.longPressSent) {
+            int64_t longPressAt = state.pressedAtUs + LONG_PRESS_US;
+            candidate = candidate == 0 ? longPressAt : min(candidate, longPressAt);
+        }
+        if (candidate != 0 && (deadline == 0 || candidate < deadline)) {
+            deadline = candidate;
+        }
+    }
+    return deadline;
+}
+
+static void logStats(int64_t now, int64_t &windowStartUs) {
+    int64_t elapsedUs = now - windowStartUs;
+    if (elapsedUs < STATS_INTERVAL_US) {
+        return;
+    }
+
+    ESP_LOGD(TAG,
+             "%.2f wakeups/s, %lu edges (%lu dropped), %lu encoder "
+             "dispatches, %lu clicks, click latency avg %lu us max %lu us",
+             stats.wakeups * 1e6f / elapsedUs, (unsigned long)stats.edges,
+             (unsigned long)droppedEdges,
+             (unsigned long)stats.encoderDispatches,
+             (unsigned long)stats.clicks,
+             (unsigned long)(stats.clicks ? stats.totalClickLatencyUs /
+                                                stats.clicks
+                                          : 0),
+             (unsigned long)stats.maxClickLatencyUs);
+    stats = InputStats();
+    droppedEdges = 0;
+    windowStartUs = now;
+}
+
+// The one task that reads the buttons and both encoders. Sleeps until an
+// edge or encoder detent arrives or a debounce/long press deadline is due,
+// so an untouched remote costs no wakeups at all.
+static void inputTask(void *pvParameters) {
+    int64_t statsWindowStartUs = esp_timer_get_time();
+
+    while (true) {
+        TickType_t wait = portMAX_DELAY;
+        int64_t deadline = nextDeadline();
+        if (deadline != 0) {
+            int64_t remainingUs = deadline - esp_timer_get_time();
+            wait = remainingUs > 0 ? pdMS_TO_TICKS((remainingUs + 999) / 1000)
+                                   : 0;
+            if (remainingUs > 0 && wait == 0) {
+                wait = 1;
+            }
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+        stats.wakeups++;
+
+        // Encoders first: a turn that came before a click must reach its
+        // consumer before the click can change state.
+        dispatchEncoders();
+
+        EdgeSample sample;
+        while (edgeQueue.pop(sample)) {
+            stats.edges++;
+            ButtonState &state = buttons[sample.button];
+            bool pressed = sample.level == LOW;
+            if (pressed != state.pressed &&
+                sample.timestampUs - state.changedAtUs >= DEBOUNCE_US) {
+                commit(sample.button, pressed, sample.timestampUs);
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        for (size_t i = 0; i < BUTTON_COUNT; i++) {
+            ButtonState &state = buttons[i];
+
+            // Catch a change whose edge fell inside the debounce window.
+            if (state.verifyAtUs != 0 && now >= state.verifyAtUs) {
+                state.verifyAtUs = 0;
+                bool pressed = digitalRead(BUTTON_PINS[i]) == LOW;
+                if (pressed != state.pressed) {
+                    commit(i, pressed, now);
+                }
+            }
+
+            if (state.pressed && !state.longPressSent &&
+                now - state.pressedAtUs >= LONG_PRESS_US) {
+                state.longPressSent = true;
+                dispatch(static_cast<InputButton>(i),
+                         InputEventType::LongPress, now);
+            }
+        }
+
+        logStats(now, statsWindowStartUs);
+    }
+}
+
+void initInput() {
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        pinMode(BUTTON_PINS[i], INPUT_PULLUP);
+        buttons[i].pressed = digitalRead(BUTTON_PINS[i]) == LOW;
+    }
+
+    // Listeners only queue state machine events now; see the stack audit
+    // before trimming this.
+    inputTaskHandle = inputTaskMemory.start(inputTask, "inputTask", NULL, 2, 0);
+
+    leftEncoder.notifyOnChange(inputTaskHandle);
+    rightEncoder.notifyOnChange(inputTaskHandle);
+
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        attachInterruptArg(digitalPinToInterrupt(BUTTON_PINS[i]), onButtonEdge,
+                           reinterpret_cast<void *>(i), CHANGE);
+    }
+
+    // Deliver to whatever route the state machine set up during boot.
+    refreshEncoderRoute();
+}
+
+void detachInputInterrupts() {
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        detachInterrupt(digitalPinToInterrupt(BUTTON_PINS[i]));
+    }
+}
+
+void setInputLightSleepWake(bool enabled) {
+    portENTER_CRITICAL(&wakeMux);
+    if (enabled && !wakeArmed) {
+        for (size_t i = 0; i < BUTTON_COUNT; i++) {
+            // Also switches the pin to level triggering.
+            gpio_ll_wakeup_enable(&GPIO,
+                                  static_cast<gpio_num_t>(BUTTON_PINS[i]),
+                                  GPIO_INTR_LOW_LEVEL);
+        }
+        wakeArmed = true;
+    } else if (!enabled && wakeArmed) {
+        restoreEdgeInterrupts();
+        wakeArmed = false;
+    }
+    portEXIT_CRITICAL(&wakeMux);
+}
+
+void setEncoderRoute(const EncoderRoute *route) {
+    encoderRouter.set(route);
+
+    if (route != nullptr) {
+        ESP_LOGD(TAG, "Encoders routed to %s", route->name);
+        refreshEncoderRoute();
+    }
+}
+
+void clearEncoderRoute() { setEncoderRoute(nullptr); }
+
+void refreshEncoderRoute() {
+    if (inputTaskHandle != NULL) {
+        xTaskNotifyGive(inputTaskHandle);
+    }
+}
+
+bool subscribeInput(InputListener listener) {
+    bool added = false;
+    portENTER_CRITICAL(&listenerMux);
+    size_t count = listenerCount.load(std::memory_order_relaxed);
+    if (count < MAX_LISTENERS) {
+        listeners[count] = listener;
+        listenerCount.store(count + 1, std::memory_order_release);
+        added = true;
+    }
+    portEXIT_CRITICAL(&listenerMux);
+
+    if (!added) {
+        ESP_LOGE(TAG, "No free input listener slot");
+    }
+    return added;
+}
+
+bool isInputPressed(uint8_t pin) {
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        if (BUTTON_PINS[i] == pin) {
+            return buttons[i].pressed;
+        }
+    }
+    return digitalRead(pin) == LOW;
+}
@@ -0,0 +1,68 @@
+#ifndef INPUT_SERVICE_H
+#define INPUT_SERVICE_H
+
+#include <Arduino.h>
+
+#include "pins.h"
+#include "utils/EncoderRouter.h"
+
+enum class InputButton : uint8_t {
+    LeftShoulder,
+    RightShoulder,
+    UnderLeft,
+    UnderCenter,
+    UnderRight,
+    COUNT
+};
+
+enum class InputEventType : uint8_t {
+    Press,        // debounced press, as soon as it happens
+    Release,      // debounced release
+    Click,        // released before the long press threshold
+    DoubleClick,  // second click within the double click window
+    LongPress,    // held past the long press threshold
+};
+
+struct InputEvent {
+    InputButton button;
+    InputEventType type;
+    // esp_timer time of the edge that caused the event.
+    int64_t timestampUs;
+};
+
+// Called from the input task for every event, in subscription order. A slow
+// listener delays the listeners after it and the next event.
+typedef void (*InputListener)(const InputEvent &event);
+
+// Attaches edge interrupts to every button and starts the input task.
+void initInput();
+
+// Detaches the button interrupts, e.g. before configuring sleep wake-up.
+void detachInputInterrupts();
+
+// Lets the buttons wake the chip from light sleep. While enabled they are
+// level triggered; the first press switches them back to edges and is
+// still delivered as a normal press.
+void setInputLightSleepWake(bool enabled);
+
+// Registers a listener. Returns false if all listener slots are taken.
+bool subscribeInput(InputListener listener);
+
+// Sends encoder changes to `route` from now on, starting with the current
+// values. Call from the state's entry action and clear it from its exit
+// action (see releaseEncoders), so a consumer never sees input after its
+// state was left. Handlers run on the input task with the route locked, so
+// they must not process state machine events, and should only hand the
+// value over to whoever uses it.
+void setEncoderRoute(const EncoderRoute *route);
+void clearEncoderRoute();
+
+// Offers the current encoder values to the route again, e.g. once a consumer
+// that declined them is ready.
+void refreshEncoderRoute();
+
+// Debounced state of the button on `pin`. Pins the input service does not
+// manage fall back to reading the pin (active low).
+bool isInputPressed(uint8_t pin);
+
+#endif  // INPUT_SERVICE_H
@@ -2,8 +2,11 @@
 #define LOCKBOX_LASTINTERACTION_H
 
 #include <Arduino.h>
+#include <atomic>
 #include "display.h"
 #include "esp_log.h"
+#include "power.h"
+#include "utils/StaticRtos.h"
 
 #ifdef SHORT_TIMEOUTS
 static const unsigned long SLEEP_TIMEOUT = 30000;        // 30 seconds
@@ -26,8 +29,10 @@ enum class IdleState
 // Declare as extern - actual storage is in lastInteraction.cpp
 // volatile ensures compiler doesn't cache these across threads
 extern volatile unsigned long sleepDuration;
-extern volatile unsigned long lastInteraction;
-extern volatile IdleState idleState;
+// Atomic, and changed together with the backlight and power profile by
+// enterIdleState()/leaveIdleState() in the power service.
+extern std::atomic<unsigned long> lastInteraction;
+extern std::atomic<IdleState> idleState;
 
 inline void setNotIdle(String src)
 {
@@ -39,8 +44,7 @@ inline void setNotIdle(String src)
     }
     
     // We were idle/dimmed, now becoming active again
-    restoreScreenBrightness();
-    idleState = IdleState::NOT_IDLE;
+    leaveIdleState();
     ESP_LOGI("IDLE", "Restored from idle, called from %s", src.c_str());
 }
 
@@ -52,29 +56,33 @@ inline void setupIdleMonitor() {
             unsigned long elapsed = millis() - lastInteraction;
             
             // Only act on state TRANSITIONS, not every loop
-            if (elapsed > SLEEP_TIMEOUT && idleState != IdleState::SLEEP) {
-                idleState = IdleState::SLEEP;
-                turnOffScreen();
-                sleepDuration = elapsed;
-                ESP_LOGI("IDLE", "Entering SLEEP state");
+            // Each transition re-checks for input under the power
+            // governor's lock, so a button press in between wins.
+            IdleState state = idleState;
+            if (elapsed > SLEEP_TIMEOUT && state != IdleState::SLEEP) {
+                if (enterIdleState(IdleState::SLEEP, SLEEP_TIMEOUT)) {
+                    sleepDuration = elapsed;
+                    ESP_LOGI("IDLE", "Entering SLEEP state");
+                }
                 // Could trigger deep sleep here in the future
             }
-            else if (elapsed > PSEUDO_SLEEP_TIMEOUT && idleState == IdleState::IDLE) {
-                idleState = IdleState::PSEUDO_SLEEP;
-                ESP_LOGI("IDLE", "Entering PSEUDO_SLEEP state");
+            else if (elapsed > PSEUDO_SLEEP_TIMEOUT && state == IdleState::IDLE) {
+                if (enterIdleState(IdleState::PSEUDO_SLEEP, PSEUDO_SLEEP_TIMEOUT)) {
+                    ESP_LOGI("IDLE", "Entering PSEUDO_SLEEP state");
+                }
             }
-            else if (elapsed > IDLE_TIMEOUT && idleState == IdleState::NOT_IDLE) {
-                idleState = IdleState::IDLE;
-                dimScreen();
-                ESP_LOGI("IDLE", "Entering IDLE state - dimming screen");
+            else if (elapsed > IDLE_TIMEOUT && state == IdleState::NOT_IDLE) {
+                if (enterIdleState(IdleState::IDLE, IDLE_TIMEOUT)) {
+                    ESP_LOGI("IDLE", "Entering IDLE state - dimming screen");
+                }
             }
             
             vTaskDelay(1000 / portTICK_PERIOD_MS);
         }
     };
 
-    xTaskCreatePinnedToCore(task, "idle_monitor", 4 * configMINIMAL_STACK_SIZE,
-                            nullptr, tskIDLE_PRIORITY, nullptr, 0);
+    static StaticTask<4 * configMINIMAL_STACK_SIZE> idleMonitorTask;
+    idleMonitorTask.start(task, "idle_monitor", nullptr, tskIDLE_PRIORITY, 0);
 }
 
 #endif // LOCKBOX_LASTINTERACTION_H
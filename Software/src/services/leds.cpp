@@ -2,100 +2,208 @@
 #include <Arduino.h>
 
 #include <constants/Colors.h>
-#include <optional>
+#include <esp_timer.h>
+
+#include <atomic>
 
 #include "esp_log.h"
+#include "power.h"
+#include "utils/Seqlock.h"
+#include "utils/StaticRtos.h"
 
 static const char* ledsTaskName = "ledsTask";
 
 static auto TAG = "LED";
 
-// Individual LED control state
-struct IndividualLedState {
-    bool isIndividuallyControlled = false;
-    CRGB color = CRGB::Black;
-};
+static constexpr int FRAME_STATS_FRAMES = 250;
 
-IndividualLedState individualLedStates[pins::NUM_LEDS];
 CRGB leds[pins::NUM_LEDS];
-float ledPaceSpeedRpm = 60.0;  // Default value, adjust as needed
-struct LedState {
-    std::optional<double> targetColor = std::nullopt;
-    std::optional<double> currentColor = std::nullopt;
-    double targetBrightness = 0;
-    double currentBrightness = 0;
-
-    double progress = 0.0;
-    double startColor = 0;
-    double startBrightness = 0;
-    long startTime = 0;
-    uint16_t duration_ms = 250;
+
+static std::atomic<uint8_t> ledLoad(0);
+
+// Everything callers have asked the LEDs to show, from the bottom layer up.
+// Writers publish a whole copy through a seqlock, so the compositor always
+// sees a consistent set of layers without ever blocking a writer.
+struct LedLayers {
+    // Global hue/brightness fade
+    uint8_t startHue = 0;
+    uint8_t targetHue = 0;
+    uint8_t startBrightness = 0;
+    uint8_t targetBrightness = 0;
+    bool hasColor = false;
+    uint32_t startMs = 0;
+    uint16_t durationMs = 0;
+
+    // Keyframe animation
+    const LedTimeline::Timeline* animation = nullptr;
+    uint8_t animationHue = 0;
+    uint8_t animationBrightness = 0;
+    uint32_t animationStartMs = 0;
+    uint16_t pacePeriodMs = 1000;  // 60 rpm
+
+    // Per-LED overrides
+    bool overridden[pins::NUM_LEDS] = {};
+    CRGB overrideColor[pins::NUM_LEDS];
+
+    // Alert, shown on every LED until it expires
+    bool alertActive = false;
+    CRGB alertColor;
+    uint32_t alertUntilMs = 0;
 };
 
-LedState ledState;
+// Writers' copy of the layers, guarded by layersMux.
+static LedLayers pendingLayers;
+static portMUX_TYPE layersMux = portMUX_INITIALIZER_UNLOCKED;
+static Seqlock<LedLayers> publishedLayers;
+
+static StaticTask<5 * configMINIMAL_STACK_SIZE> ledsTaskMemory;
+static TaskHandle_t ledsTaskHandle = nullptr;
+
+// Ease in-out sine, 0-255 in and out.
+static const uint8_t EASE_LUT[256] = {
+    0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   2,   2,
+    2,   2,   3,   3,   3,   4,   4,   5,   5,   6,   6,   6,   7,   8,   8,
+    9,   9,   10,  10,  11,  12,  12,  13,  14,  14,  15,  16,  17,  17,  18,
+    19,  20,  21,  22,  23,  23,  24,  25,  26,  27,  28,  29,  30,  31,  32,
+    33,  34,  35,  37,  38,  39,  40,  41,  42,  43,  45,  46,  47,  48,  49,
+    51,  52,  53,  54,  56,  57,  58,  60,  61,  62,  64,  65,  66,  68,  69,
+    71,  72,  73,  75,  76,  78,  79,  81,  82,  84,  85,  87,  88,  90,  91,
+    93,  94,  96,  97,  99,  100, 102, 103, 105, 106, 108, 109, 111, 113, 114,
+    116, 117, 119, 120, 122, 124, 125, 127, 128, 130, 131, 133, 135, 136, 138,
+    139, 141, 142, 144, 146, 147, 149, 150, 152, 153, 155, 156, 158, 159, 161,
+    162, 164, 165, 167, 168, 170, 171, 173, 174, 176, 177, 179, 180, 182, 183,
+    184, 186, 187, 189, 190, 191, 193, 194, 195, 197, 198, 199, 201, 202, 203,
+    204, 206, 207, 208, 209, 210, 212, 213, 214, 215, 216, 217, 218, 220, 221,
+    222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 232, 233, 234, 235,
+    236, 237, 238, 238, 239, 240, 241, 241, 242, 243, 243, 244, 245, 245, 246,
+    246, 247, 247, 248, 249, 249, 249, 250, 250, 251, 251, 252, 252, 252, 253,
+    253, 253, 253, 254, 254, 254, 254, 254, 255, 255, 255, 255, 255, 255, 255,
+    255};
+
+struct BaseColor {
+    uint8_t hue;
+    uint8_t brightness;
+    bool animating;
+};
 
-// ease in out sine
-double ease(const double t) { return 0.5 * (1 + sin(3.1415926 * (t - 0.5))); }
+static uint8_t lerp8(uint8_t from, uint8_t to, uint8_t amount) {
+    return from + ((static_cast<int16_t>(to) - from) * amount) / 255;
+}
 
-void ledsTask(void* pvParameters) {
-    auto* state = static_cast<LedState*>(pvParameters);
-    bool shouldDraw = true;
+// Value of the global fade at `nowMs`.
+static BaseColor evaluateBase(const LedLayers& layers, uint32_t nowMs) {
+    uint32_t elapsed = nowMs - layers.startMs;
+    if (layers.durationMs == 0 || elapsed >= layers.durationMs) {
+        return {layers.targetHue, layers.targetBrightness, false};
+    }
 
-    while (true) {
-        shouldDraw = state->progress < 1.0 &&
-                     (state->currentColor != state->targetColor ||
-                      state->currentBrightness != state->targetBrightness);
+    uint8_t eased = EASE_LUT[(elapsed * 255) / layers.durationMs];
+    // Hue wraps, so take the shorter way round.
+    int8_t hueDelta = static_cast<int8_t>(layers.targetHue - layers.startHue);
+    uint8_t hue = layers.startHue + (hueDelta * eased) / 255;
+    return {hue,
+            lerp8(layers.startBrightness, layers.targetBrightness, eased),
+            true};
+}
 
-        if (!shouldDraw) {
-            vTaskDelay(250 / portTICK_PERIOD_MS);
-            continue;
-        }
+// Hands the writers' layers to the compositor. Call with layersMux held.
+static void publishLayers() {
+    publishedLayers.write(pendingLayers);
+}
 
-        if (state->duration_ms == 0) {
-            state->progress = 1.0;
-        } else {
-            state->progress =
-                constrain(static_cast<double>(millis() - state->startTime) /
-                              static_cast<double>(state->duration_ms),
-                          0.0, 1.0);
-        }
+static void wakeCompositor() {
+    if (ledsTaskHandle != nullptr) {
+        xTaskNotifyGive(ledsTaskHandle);
+    }
+}
 
-        const float dir =
-            state->startColor - state->targetColor.value_or(0) <= 128 ? 1 : -1;
+// The only task that touches the strip. Composes the layers into `leds` and
+// shows them when they change, at most once per LED period of the power
+// profile; sleeps while nothing is animating.
+void ledsTask(void* pvParameters) {
+    bool firstFrame = true;
+    int statsFrames = 0;
+    uint32_t statsUs = 0;
+    uint32_t statsPeakUs = 0;
 
-        const double easeProgress = ease(state->progress);
+    while (true) {
+        int64_t frameStart = esp_timer_get_time();
+        LedLayers layers = publishedLayers.read();
+        uint32_t now = millis();
+
+        BaseColor base = evaluateBase(layers, now);
+        CRGB baseColor = layers.hasColor || base.animating
+                             ? CRGB(CHSV(base.hue, 255, base.brightness))
+                             : CRGB::Black;
+        bool alert =
+            layers.alertActive &&
+            static_cast<int32_t>(layers.alertUntilMs - now) > 0;
+
+        uint16_t animationPeriod = 0;
+        if (layers.animation != nullptr) {
+            animationPeriod = layers.animation->periodMs != 0
+                                  ? layers.animation->periodMs
+                                  : layers.pacePeriodMs;
+        }
+        bool animating = base.animating || animationPeriod != 0;
+
+        bool changed = firstFrame;
+        for (uint8_t i = 0; i < pins::NUM_LEDS; i++) {
+            CRGB color = baseColor;
+            if (animationPeriod != 0) {
+                uint8_t level = LedTimeline::evaluate(
+                    *layers.animation, now - layers.animationStartMs,
+                    animationPeriod, i);
+                color = CHSV(layers.animationHue, 255,
+                             scale8(level, layers.animationBrightness));
+            }
+            if (alert) {
+                color = layers.alertColor;
+            } else if (layers.overridden[i]) {
+                color = layers.overrideColor[i];
+            }
+            if (leds[i] != color) {
+                leds[i] = color;
+                changed = true;
+            }
+        }
 
-        state->currentColor =
-            (state->startColor) +
-            dir * easeProgress *
-                (state->targetColor.value_or(0) - state->startColor);
+        if (changed) {
+            FastLED.show();
+            firstFrame = false;
+
+            uint32_t total = 0;
+            for (uint8_t i = 0; i < pins::NUM_LEDS; i++) {
+                total += leds[i].r + leds[i].g + leds[i].b;
+            }
+            ledLoad.store(total / (3 * pins::NUM_LEDS),
+                          std::memory_order_relaxed);
+
+            uint32_t frameUs = esp_timer_get_time() - frameStart;
+            statsUs += frameUs;
+            statsPeakUs = max(statsPeakUs, frameUs);
+            if (++statsFrames >= FRAME_STATS_FRAMES) {
+                ESP_LOGD(TAG, "Frame: %lu us avg, %lu us peak over %d frames",
+                         (unsigned long)(statsUs / statsFrames),
+                         (unsigned long)statsPeakUs, statsFrames);
+                statsFrames = 0;
+                statsUs = 0;
+                statsPeakUs = 0;
+            }
+        }
 
-        state->currentBrightness =
-            state->startBrightness +
-            (state->targetBrightness - state->startBrightness) * easeProgress;
+        // Bounds the refresh rate; requests made meanwhile stay pending in
+        // the notification and are picked up straight after.
+        powerDelay(PowerLoop::Leds);
 
-        if (state->progress >= 1.0) {
-            state->currentColor = state->targetColor;
-            state->currentBrightness = state->targetBrightness;
-            state->progress = 1.0;
-            state->startColor = state->targetColor.value_or(0);
+        TickType_t wait = portMAX_DELAY;
+        if (animating) {
+            wait = 0;
+        } else if (alert) {
+            int32_t remaining = layers.alertUntilMs - millis();
+            wait = remaining > 0 ? pdMS_TO_TICKS(remaining) : 0;
         }
-
-        leds[0] = individualLedStates[0].isIndividuallyControlled
-                      ? individualLedStates[0].color
-                      : CHSV(state->currentColor.value_or(0), 255,
-                             state->currentBrightness);
-        leds[1] = individualLedStates[1].isIndividuallyControlled
-                      ? individualLedStates[1].color
-                      : CHSV(state->currentColor.value_or(0), 255,
-                             state->currentBrightness);
-        leds[2] = individualLedStates[2].isIndividuallyControlled
-                      ? individualLedStates[2].color
-                      : CHSV(state->currentColor.value_or(0), 255,
-                             state->currentBrightness);
-        FastLED.show();
-
-        vTaskDelay(1);
+        ulTaskNotifyTake(pdTRUE, wait);
     }
 }
 
@@ -122,36 +230,48 @@ void initFastLEDs() {
 
     ESP_LOGI(TAG, "FastLEDs initialization complete.");
 
-    xTaskCreatePinnedToCore(ledsTask, ledsTaskName,
-                            5 * configMINIMAL_STACK_SIZE, &ledState,
-                            tskIDLE_PRIORITY, nullptr, 1);
-
-    vTaskDelay(100);
-    setLed(LEDColors::logoBlue, 255, 1500);
+    ledsTaskHandle = ledsTaskMemory.start(ledsTask, ledsTaskName, nullptr,
+                                          tskIDLE_PRIORITY, 1);
 }
 
 void setLed(uint8_t color_value, const uint8_t brightness,
             const uint16_t duration_ms) {
-    if (ledState.targetColor.value_or(0) == color_value &&
-        ledState.targetBrightness == brightness) {
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&layersMux);
+    LedLayers& layers = pendingLayers;
+    if (layers.hasColor && layers.targetHue == color_value &&
+        layers.targetBrightness == brightness) {
+        portEXIT_CRITICAL(&layersMux);
         return;
     }
 
-    ledState.targetColor = static_cast<double>(color_value);
-    ledState.targetBrightness = static_cast<double>(brightness);
-    ledState.duration_ms = duration_ms;
-    ledState.progress = 0.0;
-    ledState.startColor = ledState.currentColor.value_or(color_value);
-    ledState.startBrightness = ledState.currentBrightness;
-    ledState.startTime = millis();
+    // Start from wherever the current fade has got to.
+    BaseColor current = evaluateBase(layers, now);
+    layers.startHue = layers.hasColor ? current.hue : color_value;
+    layers.startBrightness = current.brightness;
+    layers.targetHue = color_value;
+    layers.targetBrightness = brightness;
+    layers.hasColor = true;
+    layers.startMs = now;
+    layers.durationMs = duration_ms;
+    publishLayers();
+    portEXIT_CRITICAL(&layersMux);
+
+    wakeCompositor();
 }
 
 void setLedOff() {
-    ledState.targetColor = std::nullopt;
-    ledState.targetBrightness = 0;
-    ledState.progress = 0.0;
-    ledState.startTime = millis();
-    ledState.duration_ms = 0;
+    portENTER_CRITICAL(&layersMux);
+    pendingLayers.animation = nullptr;
+    pendingLayers.hasColor = false;
+    pendingLayers.targetBrightness = 0;
+    pendingLayers.startBrightness = 0;
+    pendingLayers.durationMs = 0;
+    publishLayers();
+    portEXIT_CRITICAL(&layersMux);
+
+    wakeCompositor();
 }
 
 // Helper function to convert RGB565 to RGB888 with maximum color preservation
@@ -172,6 +292,14 @@ void rgb565ToRgb(uint16_t rgb565, uint8_t& r, uint8_t& g, uint8_t& b) {
     b = (b * b) >> 8;
 }
 
+static CRGB toLedColor(uint16_t rgb565Color, uint8_t brightness) {
+    uint8_t r, g, b;
+    rgb565ToRgb(rgb565Color, r, g, b);
+    CRGB color(r, g, b);
+    color.fadeLightBy(255 - brightness);
+    return color;
+}
+
 // Set individual LED color using RGB565 format
 void setIndividualLed(uint8_t ledIndex, uint16_t rgb565Color,
                       uint8_t brightness) {
@@ -180,15 +308,21 @@ void setIndividualLed(uint8_t ledIndex, uint16_t rgb565Color,
 
     if (ledIndex >= pins::NUM_LEDS) return;
 
-    uint8_t r, g, b;
-    rgb565ToRgb(rgb565Color, r, g, b);
-    individualLedStates[ledIndex].color = CRGB(r, g, b);
-    individualLedStates[ledIndex].color.fadeLightBy(255 - brightness);
-    individualLedStates[ledIndex].isIndividuallyControlled = true;
+    CRGB color = toLedColor(rgb565Color, brightness);
 
-    // Update the LED immediately
-    leds[ledIndex] = individualLedStates[ledIndex].color;
-    FastLED.show();
+    portENTER_CRITICAL(&layersMux);
+    bool unchanged = pendingLayers.overridden[ledIndex] &&
+                     pendingLayers.overrideColor[ledIndex] == color;
+    if (!unchanged) {
+        pendingLayers.overrideColor[ledIndex] = color;
+        pendingLayers.overridden[ledIndex] = true;
+        publishLayers();
+    }
+    portEXIT_CRITICAL(&layersMux);
+
+    if (!unchanged) {
+        wakeCompositor();
+    }
 }
 
 // Set left encoder LED (LED 0)
@@ -209,8 +343,14 @@ void setRightEncoderLed(uint16_t rgb565Color, uint8_t brightness) {
 // Release individual LED control back to global LED task
 void releaseIndividualLed(uint8_t ledIndex) {
     if (ledIndex >= pins::NUM_LEDS) return;
-    individualLedStates[ledIndex].isIndividuallyControlled = false;
-    individualLedStates[ledIndex].color = CRGB::Black;
+
+    portENTER_CRITICAL(&layersMux);
+    pendingLayers.overridden[ledIndex] = false;
+    pendingLayers.overrideColor[ledIndex] = CRGB::Black;
+    publishLayers();
+    portEXIT_CRITICAL(&layersMux);
+
+    wakeCompositor();
 }
 
 // Release all individual LEDs back to global control
@@ -219,3 +359,64 @@ void releaseAllIndividualLeds() {
         releaseIndividualLed(i);
     }
 }
+
+void showLedAlert(uint16_t rgb565Color, uint16_t duration_ms) {
+    CRGB color = toLedColor(rgb565Color, 255);
+
+    portENTER_CRITICAL(&layersMux);
+    pendingLayers.alertActive = true;
+    pendingLayers.alertColor = color;
+    pendingLayers.alertUntilMs = millis() + duration_ms;
+    publishLayers();
+    portEXIT_CRITICAL(&layersMux);
+
+    wakeCompositor();
+}
+
+void playLedAnimation(const LedTimeline::Timeline& timeline, uint8_t hue,
+                      uint8_t brightness) {
+    portENTER_CRITICAL(&layersMux);
+    // Keep the phase when only the colour changes.
+    if (pendingLayers.animation != &timeline) {
+        pendingLayers.animation = &timeline;
+        pendingLayers.animationStartMs = millis();
+    }
+    pendingLayers.animationHue = hue;
+    pendingLayers.animationBrightness = brightness;
+    publishLayers();
+    portEXIT_CRITICAL(&layersMux);
+
+    wakeCompositor();
+}
+
+void stopLedAnimation() {
+    portENTER_CRITICAL(&layersMux);
+    bool wasPlaying = pendingLayers.animation != nullptr;
+    pendingLayers.animation = nullptr;
+    if (wasPlaying) {
+        publishLayers();
+    }
+    portEXIT_CRITICAL(&layersMux);
+
+    if (wasPlaying) {
+        wakeCompositor();
+    }
+}
+
+void setLedPaceRpm(float rpm) {
+    uint16_t periodMs = rpm > 0 ? constrain(60000.0f / rpm, 1.0f, 60000.0f) : 0;
+
+    portENTER_CRITICAL(&layersMux);
+    bool changed = pendingLayers.pacePeriodMs != periodMs;
+    pendingLayers.pacePeriodMs = periodMs;
+    if (changed) {
+        publishLayers();
+    }
+    portEXIT_CRITICAL(&layersMux);
+
+    if (changed) {
+        wakeCompositor();
+    }
+}
+
+uint8_t getLedLoad() { return ledLoad.load(std::memory_order_relaxed); }
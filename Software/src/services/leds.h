@@ -4,12 +4,13 @@
 #include <FastLED.h>
 #include <pins.h>
 
+#include "utils/LedTimeline.h"
+
 #define BRIGHTNESS 255
 #define LED_TYPE WS2811
 #define COLOR_ORDER GRB
 
 extern CRGB leds[pins::NUM_LEDS];
-extern float ledPaceSpeedRpm;
 
 void initFastLEDs();
 
@@ -27,4 +28,20 @@ void releaseIndividualLed(
     uint8_t ledIndex);            // Release LED back to global control
 void releaseAllIndividualLeds();  // Release all LEDs back to global control
 
+// Plays `timeline` on every LED in `hue`, over the global colour and under
+// individual LEDs, until stopped. Timelines are in constants/LedTimelines.h.
+void playLedAnimation(const LedTimeline::Timeline &timeline, uint8_t hue,
+                      uint8_t brightness = 255);
+void stopLedAnimation();
+
+// Pace for timelines that follow it, e.g. strokes per minute. 0 pauses them.
+void setLedPaceRpm(float rpm);
+
+// Average drive level of the strip (0-255) as last shown, for power
+// estimates.
+uint8_t getLedLoad();
+
+// Shows `rgb565Color` on every LED for `duration_ms`, over any other layer.
+void showLedAlert(uint16_t rgb565Color, uint16_t duration_ms = 600);
+
 #endif  // LEDS_SERVICE_H
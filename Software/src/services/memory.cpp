@@ -4,6 +4,11 @@ AT24C04 memoryService(AT24C_ADDRESS_0);
 
 bool isMemoryChipFound = false;
 
+// Byte 0 is used for the presence test; keep the peer record clear of it.
+static const uint16_t PEER_RECORD_ADDRESS = 16;
+static_assert(PEER_RECORD_ADDRESS + sizeof(PeerRecord) <= 512,
+              "PeerRecord must fit in the AT24C04");
+
 bool initMemoryService() {
     ESP_LOGI("MEMORY", "Waiting 10 seconds...");
     Wire.begin();
@@ -22,4 +27,50 @@ bool initMemoryService() {
     }
 
     return true;
-}
\ No newline at end of file
+}
+
+bool loadLastPeer(PeerRecord &peer) {
+    if (!isMemoryChipFound) {
+        return false;
+    }
+
+    PeerRecord stored;
+    memoryService.readBuffer(PEER_RECORD_ADDRESS,
+                             reinterpret_cast<uint8_t *>(&stored),
+                             sizeof(stored));
+    if (!stored.isValid()) {
+        ESP_LOGD("MEMORY", "No valid peer record stored");
+        return false;
+    }
+
+    // The strings come from EEPROM; make sure they are terminated.
+    stored.serviceUUID[sizeof(stored.serviceUUID) - 1] = '\0';
+    stored.protocolFile[sizeof(stored.protocolFile) - 1] = '\0';
+    peer = stored;
+    return true;
+}
+
+bool saveLastPeer(const PeerRecord &peer) {
+    if (!isMemoryChipFound) {
+        return false;
+    }
+
+    PeerRecord record = peer;
+    record.version = PeerRecord::VERSION;
+    record.checksum = record.computeChecksum();
+
+    // Skip the write when nothing changed to spare the EEPROM.
+    PeerRecord stored;
+    memoryService.readBuffer(PEER_RECORD_ADDRESS,
+                             reinterpret_cast<uint8_t *>(&stored),
+                             sizeof(stored));
+    if (memcmp(&stored, &record, sizeof(record)) == 0) {
+        return true;
+    }
+
+    memoryService.writeBuffer(PEER_RECORD_ADDRESS,
+                              reinterpret_cast<uint8_t *>(&record),
+                              sizeof(record));
+    ESP_LOGI("MEMORY", "Saved last peer %s", record.serviceUUID);
+    return true;
+}
@@ -6,6 +6,7 @@
 #include <at24c04.h>
 
 #include "pins.h"
+#include "structs/PeerRecord.h"
 
 extern bool isMemoryChipFound;
 
@@ -13,4 +14,9 @@ extern AT24C04 memoryService;
 
 bool initMemoryService();
 
+// Last connected peer. Both return false when the memory chip is missing;
+// loadLastPeer also returns false if nothing valid is stored.
+bool loadLastPeer(PeerRecord &peer);
+bool saveLastPeer(const PeerRecord &peer);
+
 #endif  // MEMORY_SERVICE_H
\ No newline at end of file
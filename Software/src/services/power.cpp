@@ -0,0 +1,240 @@
+#include "power.h"
+
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <freertos/event_groups.h>
+
+#include <atomic>
+
+#include "esp_log.h"
+#include "input.h"
+#include "lastInteraction.h"
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "POWER";
+
+static const size_t LOOP_COUNT = static_cast<size_t>(PowerLoop::COUNT);
+
+// Indexed by IdleState.
+static const PowerProfile PROFILES[] = {
+    // SLEEP: screen off, nothing to animate
+    {{250, 5000, 200}, false, true},
+    // PSEUDO_SLEEP
+    {{100, 2000, 100}, false, false},
+    // IDLE: screen dimmed
+    {{50, 1000, 40}, false, false},
+    // NOT_IDLE
+    {{16, 250, 20}, true, false},
+};
+
+static const int FULL_SPEED_MHZ = 240;
+static const int LOW_SPEED_MHZ = 80;
+
+// Rough figures for the current draw estimate: the floor while waiting
+// between wakeups, plus the awake current for AWAKE_MS_PER_WAKEUP each time
+// a loop wakes up.
+static const float FULL_SPEED_AWAKE_MA = 45.0f;
+static const float FULL_SPEED_WAITING_MA = 30.0f;
+static const float LOW_SPEED_AWAKE_MA = 25.0f;
+static const float LOW_SPEED_WAITING_MA = 18.0f;
+static const float LIGHT_SLEEP_MA = 3.0f;
+static const float AWAKE_MS_PER_WAKEUP = 2.0f;
+
+static const EventBits_t AWAKE_BIT = BIT0;
+
+static std::atomic<uint8_t> activeState(
+    static_cast<uint8_t>(IdleState::NOT_IDLE));
+static std::atomic<uint32_t> wakeups[LOOP_COUNT];
+static int64_t stateEnteredUs = 0;
+
+static SemaphoreHandle_t governorMutex = NULL;
+static EventGroupHandle_t powerEvents = NULL;
+
+// Set when esp_pm is built in; otherwise the clock is set directly and the
+// chip never light sleeps.
+static bool pmSupported = false;
+static esp_pm_lock_handle_t fullSpeedLock = NULL;
+static esp_pm_lock_handle_t awakeLock = NULL;
+static bool fullSpeedHeld = false;
+static bool awakeHeld = false;
+
+static void setLock(esp_pm_lock_handle_t lock, bool &held, bool hold) {
+    if (hold == held) {
+        return;
+    }
+    if (hold) {
+        esp_pm_lock_acquire(lock);
+    } else {
+        esp_pm_lock_release(lock);
+    }
+    held = hold;
+}
+
+static void configureClocks(const PowerProfile &profile) {
+    if (!pmSupported) {
+        setCpuFrequencyMhz(profile.fullSpeed ? FULL_SPEED_MHZ : LOW_SPEED_MHZ);
+        return;
+    }
+
+    setLock(fullSpeedLock, fullSpeedHeld, profile.fullSpeed);
+    // The buttons can only wake the chip while their wakeup is armed. The
+    // BLE controller keeps its own lock, so the chip stays awake anyway
+    // while a radio is in use.
+    setInputLightSleepWake(profile.lightSleep);
+    setLock(awakeLock, awakeHeld, !profile.lightSleep);
+}
+
+static void reportState(uint8_t state, int64_t now) {
+    float seconds = (now - stateEnteredUs) / 1000000.0f;
+    stateEnteredUs = now;
+    if (seconds <= 0.0f) {
+        return;
+    }
+
+    const PowerProfile &profile = PROFILES[state];
+    uint32_t counts[LOOP_COUNT];
+    float perSecond = 0.0f;
+    for (size_t i = 0; i < LOOP_COUNT; i++) {
+        counts[i] = wakeups[i].exchange(0, std::memory_order_relaxed);
+        perSecond += counts[i] / seconds;
+    }
+
+    float awakeMa =
+        profile.fullSpeed ? FULL_SPEED_AWAKE_MA : LOW_SPEED_AWAKE_MA;
+    float floorMa = profile.fullSpeed ? FULL_SPEED_WAITING_MA
+                                      : LOW_SPEED_WAITING_MA;
+    if (profile.lightSleep && pmSupported) {
+        floorMa = LIGHT_SLEEP_MA;
+    }
+    float duty = min(1.0f, perSecond * AWAKE_MS_PER_WAKEUP / 1000.0f);
+    float estimateMa = floorMa + duty * (awakeMa - floorMa);
+
+    ESP_LOGD(TAG,
+             "State %u for %.1f s: %lu render, %lu status, %lu led wakeups "
+             "(%.1f/s), ~%.1f mA",
+             state, seconds, (unsigned long)counts[0],
+             (unsigned long)counts[1], (unsigned long)counts[2], perSecond,
+             estimateMa);
+}
+
+void initPowerGovernor() {
+    static StaticMutex governorMutexMemory;
+    static StaticEventGroup powerEventsMemory;
+    governorMutex = governorMutexMemory.create();
+    powerEvents = powerEventsMemory.create();
+    xEventGroupSetBits(powerEvents, AWAKE_BIT);
+    stateEnteredUs = esp_timer_get_time();
+
+    esp_pm_config_esp32s3_t config = {};
+    config.max_freq_mhz = FULL_SPEED_MHZ;
+    config.min_freq_mhz = LOW_SPEED_MHZ;
+    config.light_sleep_enable = true;
+    esp_err_t err = esp_pm_configure(&config);
+    if (err == ESP_OK) {
+        pmSupported =
+            esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "fullSpeed",
+                               &fullSpeedLock) == ESP_OK &&
+            esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "awake",
+                               &awakeLock) == ESP_OK;
+        esp_sleep_enable_gpio_wakeup();
+    }
+    if (pmSupported) {
+        ESP_LOGI(TAG, "Frequency scaling with light sleep enabled");
+    } else {
+        ESP_LOGI(TAG, "esp_pm unavailable (%s), setting the CPU clock directly",
+                 esp_err_to_name(err));
+    }
+
+    configureClocks(PROFILES[activeState.load()]);
+}
+
+// Before initPowerGovernor there is nothing to lock or reconfigure.
+static void lockGovernor() {
+    if (governorMutex != NULL) {
+        xSemaphoreTake(governorMutex, portMAX_DELAY);
+    }
+}
+
+static void unlockGovernor() {
+    if (governorMutex != NULL) {
+        xSemaphoreGive(governorMutex);
+    }
+}
+
+// Call with the governor locked.
+static void applyPowerProfile(IdleState state) {
+    uint8_t index = static_cast<uint8_t>(state);
+    uint8_t previous = activeState.exchange(index);
+    if (previous == index || governorMutex == NULL) {
+        return;
+    }
+    configureClocks(PROFILES[index]);
+    if (state == IdleState::NOT_IDLE) {
+        xEventGroupSetBits(powerEvents, AWAKE_BIT);
+    } else {
+        xEventGroupClearBits(powerEvents, AWAKE_BIT);
+    }
+    reportState(previous, esp_timer_get_time());
+}
+
+static uint8_t brightnessFor(IdleState state) {
+    switch (state) {
+        case IdleState::SLEEP:
+            return BRIGHTNESS_OFF;
+        case IdleState::NOT_IDLE:
+            return BRIGHTNESS_FULL;
+        default:
+            return BRIGHTNESS_DIM;
+    }
+}
+
+bool enterIdleState(IdleState state, unsigned long timeoutMs) {
+    lockGovernor();
+    IdleState from = idleState.load();
+    // Claim the state before looking for input. setNotIdle stamps
+    // lastInteraction before it reads idleState, so either this sees the
+    // input or setNotIdle sees the claim and wakes the remote after us.
+    idleState.store(state);
+    if (millis() - lastInteraction.load() <= timeoutMs) {
+        idleState.store(from);
+        unlockGovernor();
+        return false;
+    }
+    setScreenBrightness(brightnessFor(state));
+    applyPowerProfile(state);
+    unlockGovernor();
+    return true;
+}
+
+void leaveIdleState() {
+    lockGovernor();
+    idleState.store(IdleState::NOT_IDLE);
+    applyPowerProfile(IdleState::NOT_IDLE);
+    setScreenBrightness(brightnessFor(IdleState::NOT_IDLE));
+    unlockGovernor();
+}
+
+const PowerProfile &getPowerProfile() {
+    return PROFILES[activeState.load(std::memory_order_relaxed)];
+}
+
+TickType_t powerPeriod(PowerLoop loop) {
+    size_t index = static_cast<size_t>(loop);
+    wakeups[index].fetch_add(1, std::memory_order_relaxed);
+
+    uint8_t state = activeState.load(std::memory_order_relaxed);
+    return pdMS_TO_TICKS(PROFILES[state].loopPeriodMs[index]);
+}
+
+void powerDelay(PowerLoop loop) {
+    TickType_t period = powerPeriod(loop);
+    uint8_t state = activeState.load(std::memory_order_relaxed);
+    if (state == static_cast<uint8_t>(IdleState::NOT_IDLE) ||
+        powerEvents == NULL) {
+        vTaskDelay(period);
+        return;
+    }
+    // Slow loops return early when the remote wakes up.
+    xEventGroupWaitBits(powerEvents, AWAKE_BIT, pdFALSE, pdTRUE, period);
+}
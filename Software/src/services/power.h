@@ -0,0 +1,47 @@
+#ifndef POWER_SERVICE_H
+#define POWER_SERVICE_H
+
+#include <Arduino.h>
+
+enum class IdleState;
+
+// Periodic loops whose rate follows the idle state.
+enum class PowerLoop : uint8_t {
+    Render,  // page and control redraws
+    Status,  // status bar icons
+    Leds,    // LED compositor frames
+    COUNT
+};
+
+// How hard the remote works in one idle state.
+struct PowerProfile {
+    uint16_t loopPeriodMs[static_cast<size_t>(PowerLoop::COUNT)];
+    // Full CPU clock; otherwise the clock drops to 80 MHz.
+    bool fullSpeed;
+    // Let the chip light sleep between wakeups, where supported.
+    bool lightSleep;
+};
+
+// Sets up frequency scaling and applies the active profile.
+void initPowerGovernor();
+
+// Moves the remote into idle `state`: sets idleState, the backlight and the
+// profile as one step, unless there was input in the last `timeoutMs`.
+// Returns false, changing nothing, if input won.
+bool enterIdleState(IdleState state, unsigned long timeoutMs);
+
+// Back to NOT_IDLE at full brightness. The full profile takes effect before
+// this returns, so input is handled at full speed.
+void leaveIdleState();
+
+const PowerProfile &getPowerProfile();
+
+// Sleeps for one period of `loop` under the current profile and counts the
+// wakeup towards the current draw estimate.
+void powerDelay(PowerLoop loop);
+
+// One period of `loop` under the current profile, counted as a wakeup, for
+// loops that wait on a queue rather than sleep.
+TickType_t powerPeriod(PowerLoop loop);
+
+#endif  // POWER_SERVICE_H
@@ -0,0 +1,92 @@
+#include "resume.h"
+
+#include <driver/rtc_io.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+
+#include <atomic>
+
+#include "esp_log.h"
+
+static const char *TAG = "RESUME";
+
+static const uint32_t RESUME_MAGIC = 0x52534D31;  // "RSM1"
+
+struct SavedResume {
+    uint32_t magic;
+    ResumeState state;
+    uint32_t checksum;
+};
+
+// RTC slow memory keeps this through deep sleep; power-on clears it.
+RTC_DATA_ATTR static SavedResume saved;
+
+static bool resuming = false;
+static ResumeState restored = {};
+static std::atomic<bool> interactiveNoted(false);
+
+// FNV-1a over the saved bytes, so a partly written state is never restored.
+static uint32_t checksum(const ResumeState &state) {
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&state);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(state); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool initResume() {
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    if (cause == ESP_SLEEP_WAKEUP_EXT1) {
+        // Hand the wake pin back to the GPIO matrix for the input service.
+        rtc_gpio_deinit(static_cast<gpio_num_t>(DEEP_SLEEP_WAKE_PIN));
+    }
+
+    resuming = cause == ESP_SLEEP_WAKEUP_EXT1 && saved.magic == RESUME_MAGIC &&
+               saved.checksum == checksum(saved.state);
+    if (resuming) {
+        restored = saved.state;
+        ESP_LOGI(TAG, "Resuming from deep sleep (screen %d, option %d)",
+                 static_cast<int>(restored.screen), restored.menuOption);
+    }
+    // A state is restored at most once; a crash or reset starts afresh.
+    saved.magic = 0;
+    return resuming;
+}
+
+bool isResuming() { return resuming; }
+
+const ResumeState &getResumeState() { return restored; }
+
+void enterDeepSleepWithResume(const ResumeState &state) {
+    saved.state = state;
+    saved.checksum = checksum(saved.state);
+    saved.magic = RESUME_MAGIC;
+
+    // Still held from the menu selection would wake it straight away.
+    while (digitalRead(DEEP_SLEEP_WAKE_PIN) == LOW) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    gpio_num_t wakePin = static_cast<gpio_num_t>(DEEP_SLEEP_WAKE_PIN);
+    esp_sleep_enable_ext1_wakeup(1ULL << DEEP_SLEEP_WAKE_PIN,
+                                 ESP_EXT1_WAKEUP_ANY_LOW);
+    // The button pulls low, so keep its pull-up powered while asleep.
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
+    rtc_gpio_pullup_en(wakePin);
+    rtc_gpio_pulldown_dis(wakePin);
+
+    ESP_LOGI(TAG, "Entering deep sleep");
+    esp_deep_sleep_start();
+}
+
+void noteInteractive(const char *screen) {
+    if (interactiveNoted.exchange(true)) {
+        return;
+    }
+    // esp_timer starts with the app, so ROM and bootloader time is not
+    // included.
+    ESP_LOGI(TAG, "%s interactive %lld ms after %s", screen,
+             esp_timer_get_time() / 1000, resuming ? "wake" : "power-on");
+}
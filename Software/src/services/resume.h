@@ -0,0 +1,44 @@
+#ifndef RESUME_SERVICE_H
+#define RESUME_SERVICE_H
+
+#include <Arduino.h>
+
+#include "pins.h"
+
+// Deep sleep wakes on this button: ext1 needs an RTC GPIO, and the shoulder
+// button is the only one wired to one.
+constexpr uint8_t DEEP_SLEEP_WAKE_PIN = pins::BTN_R_SHOULDER;
+
+// Where the remote was when it went to sleep.
+enum class ResumeScreen : uint8_t {
+    MainMenu,
+    DeviceControls,  // a device was connected; reconnect to it
+};
+
+struct ResumeState {
+    ResumeScreen screen;
+    int16_t menuOption;
+    int32_t leftEncoder;
+    int32_t rightEncoder;
+};
+
+// Call first thing in setup(). Returns true if this boot is a wake from
+// deep sleep with a saved state to restore.
+bool initResume();
+
+// Same answer as initResume().
+bool isResuming();
+
+// The state saved before the last deep sleep. Only meaningful while
+// isResuming().
+const ResumeState &getResumeState();
+
+// Saves `state` to RTC memory and enters deep sleep until the wake button is
+// pressed. Does not return; the wake is a fresh boot.
+void enterDeepSleepWithResume(const ResumeState &state);
+
+// Logs, once per boot, how long after power-on or wake the remote became
+// usable on `screen`.
+void noteInteractive(const char *screen);
+
+#endif  // RESUME_SERVICE_H
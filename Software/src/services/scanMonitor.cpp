@@ -1,8 +1,24 @@
 #include "scanMonitor.h"
-#include "state/remote.h"
+#include "services/coms.h"
+#include "state/dispatcher.h"
+
+// Ends as soon as the list has been quiet for a moment, and reconnects to the
+// last device without asking when it shows up.
+static const ScanPolicy deviceSearchPolicy = {
+    .name = "search",
+    .timeoutMs = 5000,
+    .quietPeriodMs = 1500,
+    .autoConnectKnownDevice = true,
+};
 
 void onScanComplete() {
-    if (stateMachine) {
-        stateMachine->process_event(devices_found_event());
-    }
+    postEvent<devices_found_event>();
+}
+
+void onKnownDeviceFound() {
+    postEvent<device_selected_event>();
+}
+
+void startDeviceSearch() {
+    startScan(deviceSearchPolicy, onScanComplete, onKnownDeviceFound);
 }
@@ -4,4 +4,10 @@
 // Callback to trigger when scan completes
 void onScanComplete();
 
+// Callback to trigger when the last connected device is seen during a scan
+void onKnownDeviceFound();
+
+// Starts the interactive device search used by the device_search state
+void startDeviceSearch();
+
 #endif
@@ -0,0 +1,348 @@
+#include "sessionArena.h"
+
+#include "esp_log.h"
+#include "services/heap.h"
+
+static const char *TAG = "SESSION_ARENA";
+
+static const size_t GRANULE = 16;
+// Free blocks up to this size wait on a list for their size class. Larger
+// ones, such as ArduinoJson's memory pools, share one list.
+static const size_t MAX_CLASSED_BYTES = 2048;
+static const size_t SIZE_CLASSES = MAX_CLASSED_BYTES / GRANULE;
+
+// In front of every arena block. Keeps the payload 8 byte aligned. Blocks
+// lie back to back from the start of the region; the two sizes lead to
+// either neighbour.
+struct BlockHeader {
+    uint32_t blockBytes;  // header included, a multiple of GRANULE
+    uint32_t previousBytes : 31;  // of the block before, 0 for the first
+    uint32_t isFree : 1;
+};
+
+// The link goes in the payload, so a free block keeps its header.
+struct FreeBlock {
+    BlockHeader header;
+    FreeBlock *next;
+};
+static_assert(sizeof(FreeBlock) <= GRANULE, "A free block must fit a granule");
+
+static portMUX_TYPE arenaMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t *region = nullptr;
+static size_t regionBytes = 0;
+static size_t offset = 0;
+// Size of the block that ends at `offset`.
+static size_t lastBlockBytes = 0;
+static FreeBlock *freeLists[SIZE_CLASSES];
+static FreeBlock *largeBlocks = nullptr;
+static SessionArenaStats stats;
+
+void initSessionArena() {
+    // One block for good, so sessions never leave holes in the heap.
+    void *block =
+        placedMalloc(HeapUser::Devices, SESSION_ARENA_BYTES + GRANULE);
+    if (block == nullptr) {
+        ESP_LOGW(TAG, "No room for the session arena, using the heap");
+        return;
+    }
+    uintptr_t aligned = ((uintptr_t)block + GRANULE - 1) & ~(GRANULE - 1);
+    portENTER_CRITICAL(&arenaMux);
+    region = reinterpret_cast<uint8_t *>(aligned);
+    regionBytes = SESSION_ARENA_BYTES;
+    stats.capacity = SESSION_ARENA_BYTES;
+    portEXIT_CRITICAL(&arenaMux);
+    ESP_LOGI(TAG, "%u bytes reserved", (unsigned)SESSION_ARENA_BYTES);
+}
+
+static bool inArena(const void *ptr) {
+    auto *bytes = static_cast<const uint8_t *>(ptr);
+    return region != nullptr && bytes >= region && bytes < region + regionBytes;
+}
+
+static size_t blockBytesFor(size_t size) {
+    return (sizeof(BlockHeader) + size + GRANULE - 1) & ~(GRANULE - 1);
+}
+
+// The rest run with arenaMux held.
+
+static void rewind() {
+    offset = 0;
+    lastBlockBytes = 0;
+    memset(freeLists, 0, sizeof(freeLists));
+    largeBlocks = nullptr;
+    stats.usedBytes = 0;
+    stats.recycled = 0;
+    stats.overflowBlocks = 0;
+    stats.overflowBytes = 0;
+    stats.rewinds++;
+}
+
+static uint8_t *startOf(BlockHeader *header) {
+    return reinterpret_cast<uint8_t *>(header);
+}
+
+static bool endsRegion(BlockHeader *header) {
+    return startOf(header) + header->blockBytes == region + offset;
+}
+
+// Null for the last block.
+static BlockHeader *nextBlock(BlockHeader *header) {
+    return endsRegion(header) ? nullptr
+                              : reinterpret_cast<BlockHeader *>(
+                                    startOf(header) + header->blockBytes);
+}
+
+// Null for the first block.
+static BlockHeader *previousBlock(BlockHeader *header) {
+    return header->previousBytes == 0
+               ? nullptr
+               : reinterpret_cast<BlockHeader *>(startOf(header) -
+                                                 header->previousBytes);
+}
+
+// Makes `header` span `blockBytes` and tells the block after it.
+static void resize(BlockHeader *header, size_t blockBytes) {
+    header->blockBytes = blockBytes;
+    BlockHeader *next = nextBlock(header);
+    if (next != nullptr) {
+        next->previousBytes = blockBytes;
+    } else {
+        lastBlockBytes = blockBytes;
+    }
+}
+
+static FreeBlock **listFor(size_t blockBytes) {
+    size_t sizeClass = blockBytes / GRANULE - 1;
+    return sizeClass < SIZE_CLASSES ? &freeLists[sizeClass] : &largeBlocks;
+}
+
+static void pushFree(BlockHeader *header) {
+    FreeBlock **list = listFor(header->blockBytes);
+    auto *block = reinterpret_cast<FreeBlock *>(header);
+    header->isFree = true;
+    block->next = *list;
+    *list = block;
+}
+
+static void unlinkFree(BlockHeader *header) {
+    FreeBlock **link = listFor(header->blockBytes);
+    while (*link != reinterpret_cast<FreeBlock *>(header)) {
+        link = &(*link)->next;
+    }
+    *link = (*link)->next;
+    header->isFree = false;
+}
+
+// Hands a block back, joined with any free neighbour: to the untouched
+// tail if it ends there, otherwise to the list for its size.
+static void putFree(BlockHeader *header) {
+    BlockHeader *next = nextBlock(header);
+    if (next != nullptr && next->isFree) {
+        unlinkFree(next);
+        header->blockBytes += next->blockBytes;
+    }
+    BlockHeader *previous = previousBlock(header);
+    if (previous != nullptr && previous->isFree) {
+        unlinkFree(previous);
+        previous->blockBytes += header->blockBytes;
+        header = previous;
+    }
+    if (endsRegion(header)) {
+        offset = startOf(header) - region;
+        lastBlockBytes = header->previousBytes;
+        stats.usedBytes = offset;
+        return;
+    }
+    resize(header, header->blockBytes);
+    pushFree(header);
+}
+
+// Trims a block taken off a list to `blockBytes`, freeing the rest.
+static BlockHeader *takeFree(FreeBlock **link, size_t blockBytes) {
+    FreeBlock *block = *link;
+    *link = block->next;
+    BlockHeader *header = &block->header;
+    header->isFree = false;
+    size_t spare = header->blockBytes - blockBytes;
+    if (spare > 0) {
+        auto *rest =
+            reinterpret_cast<BlockHeader *>(startOf(header) + blockBytes);
+        // Free blocks never border the tail or each other, so the rest
+        // has a live block after it.
+        rest->previousBytes = blockBytes;
+        header->blockBytes = blockBytes;
+        resize(rest, spare);
+        pushFree(rest);
+    }
+    stats.recycled++;
+    return header;
+}
+
+static BlockHeader *takeFromTail(size_t blockBytes) {
+    if (regionBytes - offset < blockBytes) {
+        return nullptr;
+    }
+    auto *header = reinterpret_cast<BlockHeader *>(region + offset);
+    header->blockBytes = blockBytes;
+    header->previousBytes = lastBlockBytes;
+    header->isFree = false;
+    offset += blockBytes;
+    lastBlockBytes = blockBytes;
+    stats.usedBytes = offset;
+    stats.peakBytes = max(stats.peakBytes, stats.usedBytes);
+    return header;
+}
+
+// The smallest free block that fits: its own size class, the next larger
+// class that has one, then the closest large block. The untouched tail is
+// kept for last, so blocks that stay put gather at the start.
+static BlockHeader *takeBlock(size_t blockBytes) {
+    for (size_t sizeClass = blockBytes / GRANULE - 1;
+         sizeClass < SIZE_CLASSES; sizeClass++) {
+        if (freeLists[sizeClass] != nullptr) {
+            return takeFree(&freeLists[sizeClass], blockBytes);
+        }
+    }
+    FreeBlock **best = nullptr;
+    for (FreeBlock **link = &largeBlocks; *link != nullptr;
+         link = &(*link)->next) {
+        uint32_t bytes = (*link)->header.blockBytes;
+        if (bytes >= blockBytes &&
+            (best == nullptr || bytes < (*best)->header.blockBytes)) {
+            best = link;
+        }
+    }
+    if (best != nullptr) {
+        return takeFree(best, blockBytes);
+    }
+    return takeFromTail(blockBytes);
+}
+
+void *sessionAlloc(size_t size) {
+    size_t blockBytes = blockBytesFor(size);
+    BlockHeader *header = nullptr;
+
+    portENTER_CRITICAL(&arenaMux);
+    if (region != nullptr) {
+        header = takeBlock(blockBytes);
+    }
+    if (header != nullptr) {
+        stats.liveBlocks++;
+    } else {
+        stats.overflowBlocks++;
+        stats.overflowBytes += size;
+    }
+    portEXIT_CRITICAL(&arenaMux);
+
+    if (header == nullptr) {
+        return placedMalloc(HeapUser::Devices, size);
+    }
+    return header + 1;
+}
+
+void sessionFree(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (!inArena(ptr)) {
+        placedFree(HeapUser::Devices, ptr);
+        return;
+    }
+
+    BlockHeader *header = static_cast<BlockHeader *>(ptr) - 1;
+    bool ended = false;
+    SessionArenaStats ending;
+
+    portENTER_CRITICAL(&arenaMux);
+    putFree(header);
+    stats.liveBlocks--;
+    if (stats.liveBlocks == 0) {
+        ending = stats;
+        rewind();
+        ended = true;
+    }
+    portEXIT_CRITICAL(&arenaMux);
+
+    if (ended) {
+        ESP_LOGI(TAG,
+                 "Session ended: %lu of %lu bytes used, %lu blocks reused, "
+                 "%lu overflowed to the heap",
+                 (unsigned long)ending.usedBytes,
+                 (unsigned long)ending.capacity,
+                 (unsigned long)ending.recycled,
+                 (unsigned long)ending.overflowBlocks);
+    }
+}
+
+SessionArenaStats getSessionArenaStats() {
+    portENTER_CRITICAL(&arenaMux);
+    SessionArenaStats copy = stats;
+    size_t largest = regionBytes - offset;
+    for (size_t sizeClass = SIZE_CLASSES; sizeClass-- > 0;) {
+        if (freeLists[sizeClass] != nullptr) {
+            largest = max(largest, (sizeClass + 1) * GRANULE);
+            break;
+        }
+    }
+    for (FreeBlock *block = largeBlocks; block != nullptr;
+         block = block->next) {
+        largest = max(largest, (size_t)block->header.blockBytes);
+    }
+    portEXIT_CRITICAL(&arenaMux);
+    copy.largestFreeBytes =
+        largest > sizeof(BlockHeader) ? largest - sizeof(BlockHeader) : 0;
+    return copy;
+}
+
+// Grows or shrinks an arena block without moving it: within the block, or
+// into the tail when the block ends there.
+static bool resizeInPlace(void *ptr, size_t size) {
+    BlockHeader *header = static_cast<BlockHeader *>(ptr) - 1;
+    size_t blockBytes = blockBytesFor(size);
+    bool resized = false;
+    portENTER_CRITICAL(&arenaMux);
+    if (blockBytes <= header->blockBytes) {
+        resized = true;
+    } else if (endsRegion(header) &&
+               startOf(header) + blockBytes <= region + regionBytes) {
+        offset += blockBytes - header->blockBytes;
+        header->blockBytes = blockBytes;
+        lastBlockBytes = blockBytes;
+        stats.usedBytes = offset;
+        stats.peakBytes = max(stats.peakBytes, stats.usedBytes);
+        resized = true;
+    }
+    portEXIT_CRITICAL(&arenaMux);
+    return resized;
+}
+
+class SessionJsonAllocator : public ArduinoJson::Allocator {
+  public:
+    void *allocate(size_t size) override { return sessionAlloc(size); }
+    void deallocate(void *ptr) override { sessionFree(ptr); }
+    void *reallocate(void *ptr, size_t size) override {
+        if (ptr == nullptr) {
+            return sessionAlloc(size);
+        }
+        if (!inArena(ptr)) {
+            return placedRealloc(HeapUser::Devices, ptr, size);
+        }
+        if (resizeInPlace(ptr, size)) {
+            return ptr;
+        }
+        void *moved = sessionAlloc(size);
+        if (moved == nullptr) {
+            return nullptr;
+        }
+        const BlockHeader *header = static_cast<const BlockHeader *>(ptr) - 1;
+        memcpy(moved, ptr,
+               min(size, (size_t)header->blockBytes - sizeof(BlockHeader)));
+        sessionFree(ptr);
+        return moved;
+    }
+};
+
+ArduinoJson::Allocator *sessionJsonAllocator() {
+    static SessionJsonAllocator allocator;
+    return &allocator;
+}
@@ -0,0 +1,110 @@
+#ifndef SESSION_ARENA_SERVICE_H
+#define SESSION_ARENA_SERVICE_H
+
+#include <Arduino.h>
+
+#include <ArduinoJson.h>
+
+#include <new>
+
+/**
+ * Memory for one device session: the Device, its widgets, its
+ * characteristic table and its protocol documents.
+ *
+ * Blocks come off one region reserved up front, by bumping a pointer.
+ * A freed block is joined with free neighbours and goes on a list for its
+ * size (in 16 byte steps up to 2 KiB, one list above that, where the
+ * memory pools of a session's JsonDocuments land). Requests take the
+ * smallest free block that fits, split to size, before touching the rest of
+ * the region, so pages that rebuild their widgets reuse the same memory. A
+ * block freed at the end of the region goes back to it. Once the last block
+ * is freed, normally when the old Device is deleted after a disconnect, the
+ * whole region is rewound in one go. A new session that starts while the
+ * old one is still being torn down just continues after it.
+ *
+ * Requests that do not fit go to the heap as HeapUser::Devices and are
+ * counted as overflow; raise SESSION_ARENA_BYTES if a session reports any.
+ * Data that comes and goes within a session (a JSON read, a temporary
+ * string) should stay on the heap, where it does not take room from the
+ * session's own data between blocks that stay put.
+ */
+
+#ifndef SESSION_ARENA_BYTES
+#define SESSION_ARENA_BYTES (24 * 1024)
+#endif
+
+// All counts are for the current session, except peakBytes and rewinds.
+struct SessionArenaStats {
+    uint32_t capacity;
+    uint32_t usedBytes;
+    uint32_t peakBytes;
+    uint32_t liveBlocks;
+    // Allocations served from a freed block.
+    uint32_t recycled;
+    // Sessions ended, i.e. times the arena was rewound.
+    uint32_t rewinds;
+    uint32_t overflowBlocks;
+    uint32_t overflowBytes;
+    // The largest request the arena could serve right now.
+    uint32_t largestFreeBytes;
+};
+
+// Reserves the arena. Until then, and if there is no room for it, session
+// data goes to the heap.
+void initSessionArena();
+
+// Null only if the arena is full and the heap is too.
+void *sessionAlloc(size_t size);
+void sessionFree(void *ptr);
+
+SessionArenaStats getSessionArenaStats();
+
+// For JsonDocuments that live as long as their Device. A reallocation
+// stays in place when the block has room or ends the region; otherwise it
+// copies, and the old block is left for the next request that fits.
+ArduinoJson::Allocator *sessionJsonAllocator();
+
+// std::allocator over the session arena.
+template <class T>
+struct SessionAllocator {
+    using value_type = T;
+
+    SessionAllocator() noexcept = default;
+    template <class U>
+    SessionAllocator(const SessionAllocator<U> &) noexcept {}
+
+    T *allocate(size_t count) {
+        void *ptr = sessionAlloc(count * sizeof(T));
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(ptr);
+    }
+
+    void deallocate(T *ptr, size_t) noexcept { sessionFree(ptr); }
+};
+
+template <class T, class U>
+bool operator==(const SessionAllocator<T> &, const SessionAllocator<U> &) {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const SessionAllocator<T> &, const SessionAllocator<U> &) {
+    return false;
+}
+
+// Base for classes whose instances belong to the session: routes their
+// new and delete to the arena.
+struct SessionAllocated {
+    static void *operator new(size_t size) {
+        void *ptr = sessionAlloc(size);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+    static void operator delete(void *ptr) { sessionFree(ptr); }
+};
+
+#endif  // SESSION_ARENA_SERVICE_H
@@ -1,9 +1,7 @@
 #include "sleepWakeup.h"
 
-#include "state/remote.h"
+#include "state/dispatcher.h"
 
 void sendWakeUpEvent() {
-    if (stateMachine != nullptr) {
-        stateMachine->process_event(wake_up_event());
-    }
+    postEvent<wake_up_event>();
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "stackAudit.h"
+
+#include "esp_log.h"
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "STACK_AUDIT";
+
+static const size_t MAX_TASKS = 32;
+static const uint32_t MIN_HEADROOM = 512;
+static const uint32_t BUDGET_ROUNDING = 256;
+
+struct AuditedTask {
+    char name[configMAX_TASK_NAME_LEN];
+    // NULL once the task has deleted itself.
+    TaskHandle_t task;
+    uint32_t stackBytes;
+    // Least free stack seen on earlier runs, for tasks that come and go.
+    uint32_t minFreeBytes;
+};
+
+static portMUX_TYPE auditMux = portMUX_INITIALIZER_UNLOCKED;
+static AuditedTask tasks[MAX_TASKS];
+static size_t taskCount = 0;
+
+// Tasks that start again under the same name share an entry.
+static AuditedTask *findTask(const char *name) {
+    for (size_t i = 0; i < taskCount; i++) {
+        if (strncmp(tasks[i].name, name, sizeof(tasks[i].name)) == 0) {
+            return &tasks[i];
+        }
+    }
+    return nullptr;
+}
+
+void auditStack(TaskHandle_t task, const char *name, uint32_t stackBytes) {
+    if (task == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&auditMux);
+    AuditedTask *entry = findTask(name);
+    if (entry == nullptr && taskCount < MAX_TASKS) {
+        entry = &tasks[taskCount++];
+        strlcpy(entry->name, name, sizeof(entry->name));
+        entry->minFreeBytes = UINT32_MAX;
+    }
+    if (entry != nullptr) {
+        entry->task = task;
+        entry->stackBytes = stackBytes;
+    }
+    portEXIT_CRITICAL(&auditMux);
+}
+
+void auditStackBeforeExit() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    uint32_t freeBytes = uxTaskGetStackHighWaterMark(NULL);
+    portENTER_CRITICAL(&auditMux);
+    for (size_t i = 0; i < taskCount; i++) {
+        if (tasks[i].task == self) {
+            tasks[i].minFreeBytes = min(tasks[i].minFreeBytes, freeBytes);
+            tasks[i].task = NULL;
+        }
+    }
+    portEXIT_CRITICAL(&auditMux);
+}
+
+static uint32_t budgetFor(uint32_t usedBytes) {
+    uint32_t budget = usedBytes + max(usedBytes / 4, MIN_HEADROOM);
+    return (budget + BUDGET_ROUNDING - 1) / BUDGET_ROUNDING * BUDGET_ROUNDING;
+}
+
+void printStackReport() {
+    AuditedTask snapshot[MAX_TASKS];
+    portENTER_CRITICAL(&auditMux);
+    size_t count = taskCount;
+    memcpy(snapshot, tasks, sizeof(AuditedTask) * count);
+    portEXIT_CRITICAL(&auditMux);
+
+    uint32_t totalStack = 0;
+    uint32_t totalBudget = 0;
+    ESP_LOGI(TAG, "%-16s %6s %6s %6s", "task", "stack", "peak", "budget");
+    for (size_t i = 0; i < count; i++) {
+        const AuditedTask &entry = snapshot[i];
+        uint32_t freeBytes = entry.minFreeBytes;
+        if (entry.task != NULL) {
+            uint32_t current = uxTaskGetStackHighWaterMark(entry.task);
+            freeBytes = min(freeBytes, current);
+        }
+        uint32_t usedBytes =
+            freeBytes < entry.stackBytes ? entry.stackBytes - freeBytes : 0;
+        uint32_t budget = budgetFor(usedBytes);
+        totalStack += entry.stackBytes;
+        totalBudget += budget;
+        ESP_LOGI(TAG, "%-16s %6lu %6lu %6lu%s", entry.name,
+                 (unsigned long)entry.stackBytes, (unsigned long)usedBytes,
+                 (unsigned long)budget,
+                 budget > entry.stackBytes ? "  (over budget)" : "");
+    }
+    ESP_LOGI(TAG, "%u tasks: %lu bytes of stack, %lu budgeted",
+             (unsigned)count, (unsigned long)totalStack,
+             (unsigned long)totalBudget);
+}
+
+#ifdef ENABLE_STACK_AUDIT
+static StaticTask<3 * configMINIMAL_STACK_SIZE> stackAuditTask;
+
+static void stackAuditLoop(void *pvParameters) {
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(STACK_AUDIT_REPORT_MS));
+        printStackReport();
+    }
+}
+#endif
+
+void initStackAudit() {
+#ifdef ENABLE_STACK_AUDIT
+    stackAuditTask.start(stackAuditLoop, "stackAudit", NULL, tskIDLE_PRIORITY,
+                         0);
+#endif
+}
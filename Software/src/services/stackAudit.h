@@ -0,0 +1,36 @@
+#ifndef STACK_AUDIT_SERVICE_H
+#define STACK_AUDIT_SERVICE_H
+
+#include <Arduino.h>
+
+/**
+ * Tracks how much of its stack each task has needed, to size the stacks.
+ *
+ * Tasks are registered as they start (StaticTask does this). The report
+ * lists each task's stack, the most it has used so far (from
+ * uxTaskGetStackHighWaterMark) and a budget: peak use plus a quarter, at
+ * least 512 bytes more, rounded up to 256.
+ *
+ * Build the `stack_audit` environment to have the report logged every
+ * STACK_AUDIT_REPORT_MS. Go through a session that reaches every screen
+ * (boot, scan, connect, controls, device menu, settings, WiFi setup, sleep
+ * and wake) and take the last report; the peaks only ever grow.
+ */
+
+#ifndef STACK_AUDIT_REPORT_MS
+#define STACK_AUDIT_REPORT_MS 30000
+#endif
+
+// Adds a task to the report.
+void auditStack(TaskHandle_t task, const char *name, uint32_t stackBytes);
+
+// For a task that is about to delete itself: keeps its peak for the report.
+void auditStackBeforeExit();
+
+// Logs the report.
+void printStackReport();
+
+// In `stack_audit` builds, starts logging the report periodically.
+void initStackAudit();
+
+#endif  // STACK_AUDIT_SERVICE_H
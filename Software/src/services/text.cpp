@@ -0,0 +1,360 @@
+#include "text.h"
+
+#include <Fonts/FreeSans9pt7b.h>
+#include <Fonts/FreeSansBold12pt7b.h>
+#include <Fonts/FreeSansBold9pt7b.h>
+#include <esp_timer.h>
+
+#include "esp_log.h"
+#include "services/heap.h"
+
+static const char *TAG = "TEXT";
+
+// One byte of coverage per pixel, glyph after glyph, so a run can be composed
+// a row at a time without unpacking the 1-bit font bitmaps.
+struct GlyphAtlas {
+    uint8_t *coverage = nullptr;
+    uint32_t *offsets = nullptr;
+};
+
+static const GFXfont *const FONTS[] = {&FreeSans9pt7b, &FreeSansBold9pt7b,
+                                       &FreeSansBold12pt7b};
+static_assert(sizeof(FONTS) / sizeof(FONTS[0]) ==
+                  static_cast<size_t>(TextFont::COUNT),
+              "FONTS must list every TextFont");
+
+static GlyphAtlas atlases[static_cast<size_t>(TextFont::COUNT)];
+
+// Off-screen RGB565 buffer for composing a text run before pushing it.
+// Large enough for a full-width line of the biggest font.
+static constexpr int RUN_BUFFER_WIDTH = 320;
+static constexpr int RUN_BUFFER_HEIGHT = 32;
+static uint16_t *runBuffer = nullptr;
+
+// Longer strings are measured every time rather than cached.
+static constexpr size_t RUN_CACHE_TEXT = 32;
+
+struct CachedRun {
+    uint32_t hash = 0;
+    uint16_t length = 0;
+    TextFont font = TextFont::COUNT;
+    uint32_t lastUsed = 0;
+    TextMetrics metrics;
+    // The hash only narrows the search; the text decides.
+    char text[RUN_CACHE_TEXT];
+};
+
+static constexpr size_t RUN_CACHE_SIZE = 48;
+static CachedRun runCache[RUN_CACHE_SIZE];
+static uint32_t runCacheClock = 0;
+
+// Stats are kept per task, so a page's frame numbers only count its own
+// text. Tasks beyond the slots go uncounted.
+static constexpr size_t STATS_TASKS = 4;
+struct TaskTextStats {
+    TaskHandle_t task = nullptr;
+    TextStats stats;
+};
+static TaskTextStats taskStats[STATS_TASKS];
+static portMUX_TYPE textMux = portMUX_INITIALIZER_UNLOCKED;
+
+// The calling task's slot, claiming a free one if needed. Call under textMux.
+static TextStats *statsForCurrentTask() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    TaskTextStats *free = nullptr;
+    for (auto &slot : taskStats) {
+        if (slot.task == self) {
+            return &slot.stats;
+        }
+        if (slot.task == nullptr && free == nullptr) {
+            free = &slot;
+        }
+    }
+    if (free == nullptr) {
+        return nullptr;
+    }
+    free->task = self;
+    return &free->stats;
+}
+
+static bool buildAtlas(const GFXfont *font, GlyphAtlas &atlas) {
+    const uint16_t glyphCount = font->last - font->first + 1;
+
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < glyphCount; i++) {
+        const GFXglyph &glyph = font->glyph[i];
+        total += glyph.width * glyph.height;
+    }
+
+    atlas.offsets = static_cast<uint32_t *>(
+        placedMalloc(HeapUser::Text, glyphCount * sizeof(uint32_t)));
+    atlas.coverage =
+        static_cast<uint8_t *>(placedMalloc(HeapUser::Text, total));
+    if (atlas.offsets == nullptr || atlas.coverage == nullptr) {
+        placedFree(HeapUser::Text, atlas.offsets);
+        placedFree(HeapUser::Text, atlas.coverage);
+        atlas = GlyphAtlas();
+        return false;
+    }
+
+    uint32_t offset = 0;
+    for (uint16_t i = 0; i < glyphCount; i++) {
+        const GFXglyph &glyph = font->glyph[i];
+        atlas.offsets[i] = offset;
+
+        // Same bit order as Adafruit_GFX::drawChar.
+        const uint8_t *bitmap = font->bitmap + glyph.bitmapOffset;
+        uint8_t bits = 0;
+        uint8_t bit = 0;
+        for (uint16_t p = 0; p < glyph.width * glyph.height; p++) {
+            if (!(bit++ & 7)) {
+                bits = *bitmap++;
+            }
+            atlas.coverage[offset++] = (bits & 0x80) ? 0xFF : 0x00;
+            bits <<= 1;
+        }
+    }
+
+    return true;
+}
+
+void initText() {
+    size_t atlasBytes = 0;
+    for (size_t i = 0; i < static_cast<size_t>(TextFont::COUNT); i++) {
+        if (!buildAtlas(FONTS[i], atlases[i])) {
+            ESP_LOGW(TAG, "No PSRAM for glyph atlas %d, decoding from flash",
+                     (int)i);
+            continue;
+        }
+        const GFXfont *font = FONTS[i];
+        const GFXglyph &lastGlyph = font->glyph[font->last - font->first];
+        atlasBytes += atlases[i].offsets[font->last - font->first] +
+                      lastGlyph.width * lastGlyph.height;
+    }
+
+    runBuffer = static_cast<uint16_t *>(
+        placedMalloc(HeapUser::Text,
+                     RUN_BUFFER_WIDTH * RUN_BUFFER_HEIGHT * sizeof(uint16_t)));
+    if (runBuffer == nullptr) {
+        ESP_LOGW(TAG, "No PSRAM for text run buffer, using GFX text path");
+    }
+
+    ESP_LOGI(TAG, "Glyph atlases ready: %u bytes", (unsigned)atlasBytes);
+}
+
+const GFXfont *getFont(TextFont font) {
+    return FONTS[static_cast<size_t>(font)];
+}
+
+// FNV-1a
+static uint32_t hashText(const char *text, uint16_t &length) {
+    uint32_t hash = 2166136261u;
+    length = 0;
+    while (text[length] != '\0') {
+        hash ^= static_cast<uint8_t>(text[length]);
+        hash *= 16777619u;
+        length++;
+    }
+    return hash;
+}
+
+// Mirrors Adafruit_GFX::getTextBounds/charBounds for custom fonts on a single
+// line with text size 1.
+static TextMetrics computeMetrics(const GFXfont *font, const char *text) {
+    int16_t cursorX = 0;
+    int16_t minX = INT16_MAX, minY = INT16_MAX;
+    int16_t maxX = -1, maxY = -1;
+
+    for (const char *c = text; *c != '\0'; c++) {
+        uint8_t ch = static_cast<uint8_t>(*c);
+        if (ch < font->first || ch > font->last) {
+            continue;
+        }
+        const GFXglyph &glyph = font->glyph[ch - font->first];
+        if (glyph.width > 0 && glyph.height > 0) {
+            int16_t x1 = cursorX + glyph.xOffset;
+            int16_t y1 = glyph.yOffset;
+            int16_t x2 = x1 + glyph.width - 1;
+            int16_t y2 = y1 + glyph.height - 1;
+            minX = min(minX, x1);
+            minY = min(minY, y1);
+            maxX = max(maxX, x2);
+            maxY = max(maxY, y2);
+        }
+        cursorX += glyph.xAdvance;
+    }
+
+    TextMetrics metrics;
+    if (maxX >= minX) {
+        metrics.x1 = minX;
+        metrics.width = maxX - minX + 1;
+    }
+    if (maxY >= minY) {
+        metrics.y1 = minY;
+        metrics.height = maxY - minY + 1;
+    }
+    return metrics;
+}
+
+// Call under textMux.
+static CachedRun *findRun(TextFont font, const char *text, uint32_t hash,
+                          uint16_t length) {
+    for (auto &entry : runCache) {
+        if (entry.font == font && entry.hash == hash &&
+            entry.length == length && memcmp(entry.text, text, length) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+TextMetrics measureText(TextFont font, const char *text) {
+    int64_t start = esp_timer_get_time();
+
+    uint16_t length;
+    uint32_t hash = hashText(text, length);
+
+    const bool cacheable = length < RUN_CACHE_TEXT;
+
+    TextMetrics metrics;
+    bool hit = false;
+
+    if (cacheable) {
+        portENTER_CRITICAL(&textMux);
+        CachedRun *entry = findRun(font, text, hash, length);
+        if (entry != nullptr) {
+            entry->lastUsed = ++runCacheClock;
+            metrics = entry->metrics;
+            hit = true;
+        }
+        portEXIT_CRITICAL(&textMux);
+    }
+
+    if (!hit) {
+        // Measured outside the lock; another task may cache the same run
+        // meanwhile, so look again before evicting anything.
+        metrics = computeMetrics(getFont(font), text);
+    }
+
+    if (!hit && cacheable) {
+        portENTER_CRITICAL(&textMux);
+        CachedRun *entry = findRun(font, text, hash, length);
+        if (entry == nullptr) {
+            entry = &runCache[0];
+            for (auto &candidate : runCache) {
+                if (candidate.lastUsed < entry->lastUsed) {
+                    entry = &candidate;
+                }
+            }
+            entry->hash = hash;
+            entry->length = length;
+            entry->font = font;
+            entry->metrics = metrics;
+            memcpy(entry->text, text, length + 1);
+        }
+        entry->lastUsed = ++runCacheClock;
+        portEXIT_CRITICAL(&textMux);
+    }
+
+    uint32_t elapsed = esp_timer_get_time() - start;
+    portENTER_CRITICAL(&textMux);
+    TextStats *stats = statsForCurrentTask();
+    if (stats != nullptr) {
+        stats->measureUs += elapsed;
+        hit ? stats->cacheHits++ : stats->cacheMisses++;
+    }
+    portEXIT_CRITICAL(&textMux);
+
+    return metrics;
+}
+
+void drawText(TextFont font, const char *text, int16_t x, int16_t y,
+              uint16_t color, uint16_t background, Adafruit_GFX &target) {
+    TextMetrics metrics = measureText(font, text);
+    if (metrics.width == 0 || metrics.height == 0) {
+        return;
+    }
+
+    int64_t start = esp_timer_get_time();
+    const GFXfont *gfxFont = getFont(font);
+    const GlyphAtlas &atlas = atlases[static_cast<size_t>(font)];
+
+    if (runBuffer == nullptr || metrics.width > RUN_BUFFER_WIDTH ||
+        metrics.height > RUN_BUFFER_HEIGHT || strchr(text, '\n') != nullptr) {
+        // Fall back to the regular GFX glyph path.
+        target.setFont(gfxFont);
+        target.setTextColor(color);
+        target.setCursor(x, y);
+        target.print(text);
+    } else {
+        const int16_t runWidth = metrics.width;
+        const int16_t runHeight = metrics.height;
+        for (int32_t i = 0; i < runWidth * runHeight; i++) {
+            runBuffer[i] = background;
+        }
+
+        int16_t cursorX = -metrics.x1;
+        for (const char *c = text; *c != '\0'; c++) {
+            uint8_t ch = static_cast<uint8_t>(*c);
+            if (ch < gfxFont->first || ch > gfxFont->last) {
+                continue;
+            }
+            const uint16_t index = ch - gfxFont->first;
+            const GFXglyph &glyph = gfxFont->glyph[index];
+            const int16_t left = cursorX + glyph.xOffset;
+            const int16_t top = glyph.yOffset - metrics.y1;
+
+            if (atlas.coverage != nullptr) {
+                const uint8_t *src = atlas.coverage + atlas.offsets[index];
+                for (uint8_t row = 0; row < glyph.height; row++) {
+                    uint16_t *dst = runBuffer + (top + row) * runWidth + left;
+                    for (uint8_t col = 0; col < glyph.width; col++) {
+                        if (*src++) {
+                            dst[col] = color;
+                        }
+                    }
+                }
+            } else {
+                const uint8_t *bitmap = gfxFont->bitmap + glyph.bitmapOffset;
+                uint8_t bits = 0;
+                uint8_t bit = 0;
+                for (uint8_t row = 0; row < glyph.height; row++) {
+                    uint16_t *dst = runBuffer + (top + row) * runWidth + left;
+                    for (uint8_t col = 0; col < glyph.width; col++) {
+                        if (!(bit++ & 7)) {
+                            bits = *bitmap++;
+                        }
+                        if (bits & 0x80) {
+                            dst[col] = color;
+                        }
+                        bits <<= 1;
+                    }
+                }
+            }
+            cursorX += glyph.xAdvance;
+        }
+
+        target.drawRGBBitmap(x + metrics.x1, y + metrics.y1, runBuffer,
+                             runWidth, runHeight);
+    }
+
+    uint32_t elapsed = esp_timer_get_time() - start;
+    portENTER_CRITICAL(&textMux);
+    TextStats *stats = statsForCurrentTask();
+    if (stats != nullptr) {
+        stats->drawUs += elapsed;
+    }
+    portEXIT_CRITICAL(&textMux);
+}
+
+TextStats takeTextStats() {
+    TextStats snapshot;
+    portENTER_CRITICAL(&textMux);
+    TextStats *stats = statsForCurrentTask();
+    if (stats != nullptr) {
+        snapshot = *stats;
+        *stats = TextStats();
+    }
+    portEXIT_CRITICAL(&textMux);
+    return snapshot;
+}
@@ -0,0 +1,55 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include <Adafruit_GFX.h>
+#include <Arduino.h>
+
+#include "display.h"
+
+// Fonts managed by the text service. Font headers define their data per
+// translation unit, so callers refer to fonts by id rather than by pointer.
+enum class TextFont : uint8_t {
+    Sans9,       // FreeSans9pt7b
+    SansBold9,   // FreeSansBold9pt7b
+    SansBold12,  // FreeSansBold12pt7b
+    COUNT
+};
+
+// Same semantics as Adafruit_GFX::getTextBounds with the cursor at (0, 0).
+struct TextMetrics {
+    int16_t x1 = 0;
+    int16_t y1 = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+};
+
+// Time the calling task spent in the text service since it last called
+// takeTextStats().
+struct TextStats {
+    uint32_t measureUs = 0;
+    uint32_t drawUs = 0;
+    uint32_t cacheHits = 0;
+    uint32_t cacheMisses = 0;
+};
+
+// Pre-rasterises every font into a PSRAM glyph atlas. Without PSRAM the
+// service still works, decoding glyphs straight from the font bitmaps.
+void initText();
+
+const GFXfont *getFont(TextFont font);
+
+// Measures a single line of text. Results are cached per (font, string) for
+// strings under 32 characters.
+TextMetrics measureText(TextFont font, const char *text);
+
+// Draws a single line of text with its baseline origin at (x, y), matching
+// tft.setCursor(x, y) + tft.print(text). The run is composed off-screen and
+// pushed in one blit, so the background under the text box is overwritten
+// with `background`. `target` may be an off-screen canvas. Must be called
+// while holding displayMutex, which also guards the shared run buffer.
+void drawText(TextFont font, const char *text, int16_t x, int16_t y,
+              uint16_t color, uint16_t background, Adafruit_GFX &target = tft);
+
+TextStats takeTextStats();
+
+#endif  // TEXT_H
@@ -0,0 +1,209 @@
+#include "trace.h"
+
+#ifdef ENABLE_TRACE
+
+#include <esp_timer.h>
+
+#include <atomic>
+
+#include "esp_log.h"
+#include "services/battery.h"
+#include "services/heap.h"
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "TRACE";
+
+static_assert((TRACE_RECORDS & (TRACE_RECORDS - 1)) == 0,
+              "TRACE_RECORDS must be a power of two");
+
+static const char *const EVENT_NAMES[] = {
+    "setup",           "bootStep",        "encoderDetent",
+    "buttonEdge",      "encoderDispatch", "buttonDispatch",
+    "connectionTask",  "bleConnect",      "serviceDiscovery",
+    "deviceOnConnect", "pageDraw",        "menuDraw",
+    "controlsDraw",    "bleWrite",
+};
+static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) ==
+                  static_cast<size_t>(TraceEvent::COUNT),
+              "EVENT_NAMES must match TraceEvent");
+
+static const char PHASES[] = {'B', 'E', 'i'};
+
+struct TraceRecord {
+    // Index + 1 of the write that filled the slot, stored last, so the dump
+    // can tell a finished slot from one being overwritten.
+    std::atomic<uint32_t> sequence;
+    uint32_t timestampUs;
+    // Task handle, or 0 from an ISR.
+    uint32_t task;
+    uint32_t arg;
+    uint8_t event;
+    uint8_t phase;
+    uint8_t core;
+};
+
+static TraceRecord ring[TRACE_RECORDS];
+static std::atomic<uint32_t> head(0);
+static std::atomic<bool> paused(false);
+static std::atomic<uint32_t> droppedWhilePaused(0);
+
+// Names are copied the first time a task records, as the task may be gone
+// by the time the ring is dumped.
+static const size_t MAX_TASK_NAMES = 24;
+struct TaskName {
+    std::atomic<uint32_t> task;
+    char name[configMAX_TASK_NAME_LEN];
+};
+static TaskName taskNames[MAX_TASK_NAMES];
+static std::atomic<uint32_t> taskNameCount(0);
+
+// A task only ever races with its own ISRs here, and those never name
+// themselves, so the same task cannot claim two slots.
+static void rememberTaskName(uint32_t task) {
+    uint32_t count = min(taskNameCount.load(std::memory_order_acquire),
+                         (uint32_t)MAX_TASK_NAMES);
+    for (uint32_t i = 0; i < count; i++) {
+        if (taskNames[i].task.load(std::memory_order_acquire) == task) {
+            return;
+        }
+    }
+    uint32_t slot = taskNameCount.fetch_add(1, std::memory_order_acq_rel);
+    if (slot >= MAX_TASK_NAMES) {
+        return;
+    }
+    strlcpy(taskNames[slot].name, pcTaskGetName(NULL),
+            sizeof(taskNames[slot].name));
+    taskNames[slot].task.store(task, std::memory_order_release);
+}
+
+void IRAM_ATTR traceRecord(TraceEvent event, TracePhase phase, uint32_t arg) {
+    uint32_t timestampUs = (uint32_t)esp_timer_get_time();
+    if (paused.load(std::memory_order_relaxed)) {
+        droppedWhilePaused.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint32_t task = 0;
+    if (!xPortInIsrContext()) {
+        task = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+        rememberTaskName(task);
+    }
+
+    uint32_t index = head.fetch_add(1, std::memory_order_relaxed);
+    TraceRecord &record = ring[index & (TRACE_RECORDS - 1)];
+    record.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.timestampUs = timestampUs;
+    record.task = task;
+    record.arg = arg;
+    record.event = static_cast<uint8_t>(event);
+    record.phase = static_cast<uint8_t>(phase);
+    record.core = (uint8_t)xPortGetCoreID();
+    record.sequence.store(index + 1, std::memory_order_release);
+}
+
+// ISR records get one pseudo thread per core.
+static uint32_t threadId(uint32_t task, uint8_t core) {
+    return task != 0 ? task : core + 1;
+}
+
+void dumpTrace() {
+    paused.store(true);
+    // Let a write that started before the pause finish.
+    vTaskDelay(1);
+
+    uint32_t end = head.load(std::memory_order_acquire);
+    uint32_t start = end > TRACE_RECORDS ? end - TRACE_RECORDS : 0;
+
+    Serial.println("TRACE BEGIN");
+    size_t written = 0;
+    for (uint32_t index = start; index < end; index++) {
+        TraceRecord &slot = ring[index & (TRACE_RECORDS - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue;
+        }
+        Serial.printf(
+            "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lu,\"pid\":1,\"tid\":%lu,"
+            "%s\"args\":{\"arg\":%lu,\"core\":%u}}\n",
+            EVENT_NAMES[slot.event], PHASES[slot.phase],
+            (unsigned long)slot.timestampUs,
+            (unsigned long)threadId(slot.task, slot.core),
+            slot.phase == static_cast<uint8_t>(TracePhase::Instant)
+                ? "\"s\":\"t\","
+                : "",
+            (unsigned long)slot.arg, slot.core);
+        written++;
+    }
+
+    for (uint8_t core = 0; core < portNUM_PROCESSORS; core++) {
+        Serial.printf(
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,"
+            "\"args\":{\"name\":\"ISR core %u\"}}\n",
+            (unsigned long)threadId(0, core), core);
+    }
+    uint32_t names = min(taskNameCount.load(std::memory_order_acquire),
+                         (uint32_t)MAX_TASK_NAMES);
+    for (uint32_t i = 0; i < names; i++) {
+        uint32_t task = taskNames[i].task.load(std::memory_order_acquire);
+        if (task == 0) {
+            continue;
+        }
+        Serial.printf(
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,"
+            "\"args\":{\"name\":\"%s\"}}\n",
+            (unsigned long)task, taskNames[i].name);
+    }
+    Serial.println("TRACE END");
+
+    ESP_LOGI(TAG,
+             "Dumped %u records (%lu overwritten, %lu dropped while dumping)",
+             (unsigned)written, (unsigned long)start,
+             (unsigned long)droppedWhilePaused.exchange(0));
+    paused.store(false);
+}
+
+static void clearTrace() {
+    paused.store(true);
+    vTaskDelay(1);
+    for (TraceRecord &record : ring) {
+        record.sequence.store(0, std::memory_order_relaxed);
+    }
+    head.store(0);
+    paused.store(false);
+}
+
+static void traceConsoleTask(void *pvParameters) {
+    while (true) {
+        while (Serial.available() > 0) {
+            switch (Serial.read()) {
+                case 't':
+                    dumpTrace();
+                    break;
+                case 'c':
+                    clearTrace();
+                    ESP_LOGI(TAG, "Cleared");
+                    break;
+                case 'h':
+                    printHeapCensus();
+                    break;
+                case 'b':
+                    printBatteryReport();
+                    break;
+                default:
+                    break;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+}
+
+void initTrace() {
+    static StaticTask<4 * configMINIMAL_STACK_SIZE> traceConsoleTaskMemory;
+    traceConsoleTaskMemory.start(traceConsoleTask, "traceConsole", NULL, 1, 0);
+    ESP_LOGI(TAG,
+             "Tracing %u records; send 't' to dump, 'c' to clear, 'h' for a "
+             "heap census, 'b' for a battery report",
+             (unsigned)TRACE_RECORDS);
+}
+
+#endif  // ENABLE_TRACE
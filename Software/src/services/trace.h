@@ -0,0 +1,97 @@
+#ifndef TRACE_SERVICE_H
+#define TRACE_SERVICE_H
+
+#include <Arduino.h>
+
+// What a trace record marks. Names for the dump are in trace.cpp, in this
+// order.
+enum class TraceEvent : uint8_t {
+    Setup,
+    BootStep,          // arg: BootService
+    EncoderDetent,     // arg: encoder pin A
+    ButtonEdge,        // arg: InputButton
+    EncoderDispatch,   // arg: routed value
+    ButtonDispatch,    // arg: InputButton
+    ConnectionTask,
+    BleConnect,        // arg: 0 reusing a client, 1 new client
+    ServiceDiscovery,
+    DeviceOnConnect,
+    PageDraw,
+    MenuDraw,
+    ControlsDraw,
+    BleWrite,          // arg: encoded value length
+    COUNT
+};
+
+enum class TracePhase : uint8_t {
+    Begin,
+    End,
+    Instant,
+};
+
+// Tracing costs nothing unless the build defines ENABLE_TRACE (see the
+// `trace` environment in platformio.ini). Records go into a fixed ring that
+// keeps the most recent TRACE_RECORDS entries; any task or ISR may write.
+#ifdef ENABLE_TRACE
+
+#ifndef TRACE_RECORDS
+#define TRACE_RECORDS 1024
+#endif
+
+void traceRecord(TraceEvent event, TracePhase phase, uint32_t arg);
+
+// Starts the serial console: send 't' to dump the ring as Chrome trace
+// events (scripts/trace_to_json.py turns a monitor log into a trace file),
+// 'c' to clear it, 'h' to log a heap census.
+void initTrace();
+
+// Writes the ring over serial, oldest record first.
+void dumpTrace();
+
+class TraceScope {
+  public:
+    TraceScope(TraceEvent event, uint32_t arg) : event(event), arg(arg) {
+        traceRecord(event, TracePhase::Begin, arg);
+    }
+    ~TraceScope() { traceRecord(event, TracePhase::End, arg); }
+
+  private:
+    TraceEvent event;
+    uint32_t arg;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#define TRACE_BEGIN(event, arg) \
+    traceRecord(TraceEvent::event, TracePhase::Begin, (uint32_t)(arg))
+#define TRACE_END(event, arg) \
+    traceRecord(TraceEvent::event, TracePhase::End, (uint32_t)(arg))
+#define TRACE_INSTANT(event, arg) \
+    traceRecord(TraceEvent::event, TracePhase::Instant, (uint32_t)(arg))
+// Begin now, end when the enclosing block exits.
+#define TRACE_SCOPE(event, arg)                    \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__)( \
+        TraceEvent::event, (uint32_t)(arg))
+
+#else
+
+inline void initTrace() {}
+inline void dumpTrace() {}
+
+#define TRACE_BEGIN(event, arg) \
+    do {                        \
+    } while (0)
+#define TRACE_END(event, arg) \
+    do {                      \
+    } while (0)
+#define TRACE_INSTANT(event, arg) \
+    do {                          \
+    } while (0)
+#define TRACE_SCOPE(event, arg) \
+    do {                        \
+    } while (0)
+
+#endif  // ENABLE_TRACE
+
+#endif  // TRACE_SERVICE_H
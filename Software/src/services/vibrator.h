@@ -1,32 +0,0 @@
-#pragma once
-
-#include <Arduino.h>
-
-#include <freertos/FreeRTOS.h>
-#include <freertos/task.h>
-
-#include "pins.h"
-
-// Pattern types
-enum class VibratorPattern {
-    NONE,
-    SINGLE_PULSE,  // Single vibration pulse
-    DOUBLE_PULSE,  // Two vibration pulses
-    TRIPLE_PULSE,  // Three vibration pulses
-    ERROR_PULSE,   // Long error pulse
-    BOOT,
-    SHUTDOWN,
-    DEVICE_CONNECTED,
-    DEVICE_DISCONNECTED,
-    PAUSED,
-    PLAY
-};
-
-// Initialize the vibrator system
-void initVibrator();
-
-// Play a specific pattern
-void playVibratorPattern(VibratorPattern pattern);
-
-// Stop any currently playing pattern
-void stopVibrator();
\ No newline at end of file
@@ -1,14 +1,64 @@
 #include "wm.h"
 
 #include "WiFi.h"
-#include "state/remote.h"
+#include "state/dispatcher.h"
+#include "utils/StaticRtos.h"
 
 WiFiManager wm;
 
+static const char *WM_TAG = "WM";
+
+// The process task only runs while the WiFi setup portal is open, which is
+// rare, so its stack comes from the heap and goes back when the portal
+// closes.
+static const uint32_t WM_PROCESS_STACK = 6 * configMINIMAL_STACK_SIZE;
+
+static StaticSemaphore wmProcessStoppedMemory;
+// Given by the task as it leaves the process loop, just before it ends.
+static SemaphoreHandle_t wmProcessStopped = NULL;
+static volatile bool wmProcessing = false;
+
+static void wmProcessTask(void *pvParameters) {
+    auditStack(xTaskGetCurrentTaskHandle(), "wmProcessTask", WM_PROCESS_STACK);
+    while (wmProcessing) {
+        wm.process();
+        vTaskDelay(10 / portTICK_PERIOD_MS);
+    }
+    auditStackBeforeExit();
+    xSemaphoreGive(wmProcessStopped);
+    vTaskDelete(NULL);
+}
+
 void initWM() {
     WiFi.useStaticBuffers(true);
     WiFi.begin();
 
     wm.setSaveConfigCallback(
-        []() { stateMachine->process_event(wifi_connected()); });
-}
\ No newline at end of file
+        []() { postEvent<wifi_connected>(); });
+}
+
+void startWMProcessing() {
+    if (wmProcessing) {
+        return;
+    }
+    if (wmProcessStopped == NULL) {
+        wmProcessStopped = wmProcessStoppedMemory.create();
+    }
+    wmProcessing = true;
+    if (xTaskCreatePinnedToCore(wmProcessTask, "wmProcessTask",
+                                WM_PROCESS_STACK, NULL, 1, NULL,
+                                0) != pdPASS) {
+        ESP_LOGE(WM_TAG, "No memory for the process task");
+        wmProcessing = false;
+    }
+}
+
+void stopWMProcessing() {
+    if (!wmProcessing) {
+        return;
+    }
+    wmProcessing = false;
+    // Let a wm.process() call in progress finish before the caller stops
+    // the portal under it.
+    xSemaphoreTake(wmProcessStopped, portMAX_DELAY);
+}
@@ -7,4 +7,9 @@ extern WiFiManager wm;
 
 void initWM();
 
+// Runs wm.process() in its own task while the config portal is open.
+void startWMProcessing();
+// Returns once the task has left wm.process(), so the portal can be stopped.
+void stopWMProcessing();
+
 #endif // LOCKBOX_WM_H
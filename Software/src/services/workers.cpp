@@ -0,0 +1,50 @@
+#include "workers.h"
+
+#include <freertos/queue.h>
+
+#include "esp_log.h"
+#include "utils/StaticRtos.h"
+
+static const char *TAG = "WORKERS";
+
+static const size_t WORKER_COUNT = 2;
+static const size_t QUEUE_LENGTH = 8;
+
+struct WorkerItem {
+    const char *name;
+    WorkerJob job;
+    void *arg;
+};
+
+static StaticQueue<WorkerItem, QUEUE_LENGTH> workerQueueMemory;
+static StaticTask<6 * configMINIMAL_STACK_SIZE> workerTasks[WORKER_COUNT];
+static QueueHandle_t workerQueue = NULL;
+
+static void workerTask(void *pvParameters) {
+    WorkerItem item;
+    while (true) {
+        xQueueReceive(workerQueue, &item, portMAX_DELAY);
+        uint32_t startMs = millis();
+        item.job(item.arg);
+        ESP_LOGD(TAG, "%s took %lu ms on %s", item.name,
+                 (unsigned long)(millis() - startMs), pcTaskGetName(NULL));
+    }
+}
+
+void initWorkers() {
+    workerQueue = workerQueueMemory.create();
+    // Below the UI tasks (5) and alongside the connection task (1).
+    for (size_t i = 0; i < WORKER_COUNT; i++) {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "worker%u", (unsigned)i);
+        workerTasks[i].start(workerTask, name, NULL, 2, tskNO_AFFINITY);
+    }
+}
+
+void runInBackground(const char *name, WorkerJob job, void *arg) {
+    WorkerItem item = {name, job, arg};
+    if (workerQueue == NULL || xQueueSend(workerQueue, &item, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "No worker free, running %s in place", name);
+        job(arg);
+    }
+}
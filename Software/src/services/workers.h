@@ -0,0 +1,19 @@
+#ifndef WORKERS_SERVICE_H
+#define WORKERS_SERVICE_H
+
+#include <Arduino.h>
+
+// Slow work handed off by state machine actions, so the event dispatcher
+// is not held up by it. Jobs run in the order queued, but with more than
+// one worker two jobs can overlap; queue work that does not depend on
+// ordering.
+typedef void (*WorkerJob)(void *arg);
+
+// Starts the worker tasks.
+void initWorkers();
+
+// Queues `job`. Runs it in the caller when the pool is not running or its
+// queue is full, so the job is never lost.
+void runInBackground(const char *name, WorkerJob job, void *arg);
+
+#endif  // WORKERS_SERVICE_H
@@ -7,53 +7,61 @@
 #include <Fonts/FreeSansBold12pt7b.h>
 #include <constants/Sizes.h>
 #include <devices/device.h>
-#include <driver/gpio.h>
-#include <esp_sleep.h>
 #include <pages/displayUtils.h>
 #include <pages/genericPages.h>
 #include <pins.h>
 #include <qrcode.h>
-#include <services/buzzer.h>
 #include <services/display.h>
 #include <services/encoder.h>
+#include <services/feedback.h>
+#include <services/input.h>
 #include <services/leds.h>
+#include <services/resume.h>
 #include <services/sleepWakeup.h>
 #include <services/wm.h>
+#include <services/workers.h>
 
 #include "components/TextButton.h"
+#include "constants/LedTimelines.h"
 #include "events.hpp"
 #include "pages/TextPages.h"
 #include "pages/controller.h"
 #include "pages/menus.h"
-#include "services/leftEncoderMonitor.h"
+#include "pages/pageHost.h"
 
 // Forward declarations to avoid circular dependencies
-struct DiscoveredDevice;
-std::vector<DiscoveredDevice>& getDiscoveredDevices();
 void clearDiscoveredDevices();
 void connectToDiscoveredDevice(int index);
-void startScanWithTimeout(int timeoutMs, void (*onComplete)());
-void onScanComplete();
+void startDeviceSearch();
+int findKnownDevice();
 
 namespace actions {
 
+    // Between frames, so the page being replaced can't draw over it.
     auto clearPage = [](bool clearStatusbar = false) {
-        // small delay to ensure tasks are finished
-        vTaskDelay(50 / portTICK_PERIOD_MS);
-        if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
-            if (clearStatusbar) {
-                tft.fillRect(0, 0, Display::WIDTH, Display::HEIGHT,
-                             Colors::black);
-            } else {
-                tft.fillRect(0, Display::StatusbarHeight, Display::WIDTH,
-                             Display::PageHeight + 32, Colors::black);
-                // Also clear top left and top right corners to remove buttons
-                tft.fillRect(0, 0, 75, Display::StatusbarHeight, Colors::black);
-                tft.fillRect(Display::WIDTH - 75, 0, 75,
-                             Display::StatusbarHeight, Colors::black);
-            }
-            xSemaphoreGive(displayMutex);
-        }
+        runBetweenFrames(
+            [](void *arg) {
+                bool clearStatusbar = (uintptr_t)arg != 0;
+                if (xSemaphoreTake(displayMutex, pdMS_TO_TICKS(50)) !=
+                    pdTRUE) {
+                    return;
+                }
+                if (clearStatusbar) {
+                    tft.fillRect(0, 0, Display::WIDTH, Display::HEIGHT,
+                                 Colors::black);
+                } else {
+                    tft.fillRect(0, Display::StatusbarHeight, Display::WIDTH,
+                                 Display::PageHeight + 32, Colors::black);
+                    // Also clear top left and top right corners to remove
+                    // buttons
+                    tft.fillRect(0, 0, 75, Display::StatusbarHeight,
+                                 Colors::black);
+                    tft.fillRect(Display::WIDTH - 75, 0, 75,
+                                 Display::StatusbarHeight, Colors::black);
+                }
+                xSemaphoreGive(displayMutex);
+            },
+            (void *)(uintptr_t)clearStatusbar);
     };
 
     auto clearScreen = []() {
@@ -65,62 +73,66 @@ namespace actions {
     };
 
     auto disconnect = []() {
-        // Safety-critical: Ensure left encoder monitoring is stopped if the
-        // device needs it
-        if (device != nullptr &&
-            device->needsPersistentLeftEncoderMonitoring()) {
-            stopLeftEncoderMonitoring();
-        }
-
         if (device != nullptr) {
-            delete device;  // Properly calls destructor AND frees memory
+            // Unhooked here so nothing reaches it from now on; the teardown
+            // (BLE disconnect, freeing its menus and display objects) runs
+            // on a worker, between frames as pages may be drawing it. One
+            // still connecting is deleted by the connection task instead.
+            Device *old = device;
             device = nullptr;
+            runInBackground(
+                "deleteDevice",
+                [](void *arg) { Device::destroy(static_cast<Device *>(arg)); },
+                old);
         }
 
         // and then stop scanning.
         NimBLEScan *pScan = NimBLEDevice::getScan();
         pScan->stop();
-        playBuzzerPattern(BuzzerPattern::DEVICE_DISCONNECTED);
+        playFeedback(FeedbackCue::DEVICE_DISCONNECTED);
+        stopLedAnimation();
+        setLed(LEDColors::logoBlue, 255, 1500);
+    };
+
+    auto playConnectingAnimation = []() {
+        playLedAnimation(LedTimelines::pulse, LEDColors::logoBlue);
+    };
+
+    // Back to the steady colour when a connection fails without a disconnect.
+    auto stopConnectingAnimation = []() {
+        stopLedAnimation();
         setLed(LEDColors::logoBlue, 255, 1500);
     };
 
+    auto playSearchAnimation = []() {
+        playLedAnimation(LedTimelines::chase, LEDColors::logoBlue);
+    };
+
     auto drawPage = [](const TextPage &page) {
         // Capture reference to static const object - safe since it lives in
         // flash memory
+        // The page clears the page area itself.
         return [&page]() {
-            clearPage();
-            xTaskCreatePinnedToCore(drawPageTask, "drawPageTask",
-                                    5 * configMINIMAL_STACK_SIZE,
-                                    const_cast<TextPage *>(&page), 5, NULL, 1);
+            showPage(textPageController, const_cast<TextPage *>(&page));
         };
     };
 
     auto drawControl = []() {
-        // Safety-critical: Ensure left encoder monitoring is active if the
-        // device needs it
-        if (device != nullptr &&
-            device->needsPersistentLeftEncoderMonitoring()) {
-            startLeftEncoderMonitoring();
-        }
+        routeEncodersToController();
 
-        // Single task creation with immediate UI rendering
-        xTaskCreatePinnedToCore(drawControllerTask, "drawControllerTask",
-                                16 * configMINIMAL_STACK_SIZE, device, 5, NULL,
-                                1);
+        showPage(controllerPage);
     };
 
+    // Exit action of every state that routes the encoders, so the next
+    // state only gets input once its entry action has set a route.
+    auto releaseEncoders = []() { clearEncoderRoute(); };
+
     auto search = []() {
-        startScanWithTimeout(5000, onScanComplete);
+        startDeviceSearch();
     };
 
     auto drawDeviceList = []() {
-        // Stop scanning when we enter the device list
-        NimBLEScan *pScan = NimBLEDevice::getScan();
-        if (pScan->isScanning()) {
-            pScan->stop();
-        }
-        
-        // This will be implemented in menus.cpp
+        // The scan keeps running so the list fills in while it is shown.
         drawDeviceListMenu();
     };
 
@@ -128,7 +140,15 @@ namespace actions {
         connectToDiscoveredDevice(currentOption);
     };
 
+    auto selectKnownDevice = []() {
+        connectToDiscoveredDevice(findKnownDevice());
+    };
+
     auto clearDeviceList = []() {
+        NimBLEScan *pScan = NimBLEDevice::getScan();
+        if (pScan->isScanning()) {
+            pScan->stop();
+        }
         clearDiscoveredDevices();
     };
 
@@ -164,27 +184,27 @@ namespace actions {
         releaseAllIndividualLeds();
         setLed(LEDColors::idle, 50,
                1500);  // Soft white idle (Blends with backlight bleed)
-        activeMenu = &mainMenu;
+        playLedAnimation(LedTimelines::breathe, LEDColors::idle, 50);
+        activeMenu = mainMenu;
         activeMenuCount = numMainMenu;
         clearPage();
         drawMenu();
+        noteInteractive("Main menu");
     };
 
     auto drawSettingsMenu = []() {
-        activeMenu = &settingsMenu;
+        activeMenu = settingsMenu;
         activeMenuCount = numSettingsMenu;
         clearPage();
         drawMenu();
     };
 
     auto espRestart = []() {
-        playBuzzerPattern(BuzzerPattern::SHUTDOWN);
+        playFeedback(FeedbackCue::SHUTDOWN);
         vTaskDelay(1000 / portTICK_PERIOD_MS);
         esp_restart();
     };
 
-    auto espSilentRestart = []() { esp_restart(); };
-
     auto startWiFiPortal = []() {
         // Give a second for any pending MQTT messages to be sent before
         // disconnecting WiFi Otherwise we lose this state_change message until
@@ -200,22 +220,36 @@ namespace actions {
         wm.setEnableConfigPortal(true);
         wm.setCleanConnect(true);
         wm.startConfigPortal("OSSM Remote Setup");
+        startWMProcessing();
 
         // if the wifi is not currently connected then make a small task the
         // looks for the wifi connection and sends an event.
     };
 
     auto stopWiFiPortal = []() {
+        stopWMProcessing();
         wm.setConfigPortalBlocking(true);
         wm.stopConfigPortal();
     };
 
     auto enterDeepSleep = []() {
+        ResumeState resume;
+        resume.screen = device != nullptr ? ResumeScreen::DeviceControls
+                                          : ResumeScreen::MainMenu;
+        // Picking Sleep from the main menu should not wake up on Sleep.
+        int option = currentOption;
+        bool onSleepItem = activeMenu == mainMenu && option >= 0 &&
+                           option < numMainMenu &&
+                           mainMenu[option].id == MenuItemE::DEEP_SLEEP;
+        resume.menuOption = onSleepItem ? previousOption.load() : option;
+        resume.leftEncoder = leftEncoder.readEncoder();
+        resume.rightEncoder = rightEncoder.readEncoder();
+
         // Disconnect from any connected devices first
         disconnect();
 
         // Turn off display backlight and other peripherals
-        playBuzzerPattern(BuzzerPattern::SHUTDOWN);
+        playFeedback(FeedbackCue::SHUTDOWN);
         setScreenBrightness(BRIGHTNESS_OFF);
         clearScreen();
         setLedOff();
@@ -224,28 +258,12 @@ namespace actions {
         vTaskDelay(1000 / portTICK_PERIOD_MS);
 
         // Disable encoder interrupts before sleep to prevent conflicts
-        detachInterrupt(digitalPinToInterrupt(pins::LEFT_ENCODER_A));
-        detachInterrupt(digitalPinToInterrupt(pins::LEFT_ENCODER_B));
-        detachInterrupt(digitalPinToInterrupt(pins::RIGHT_ENCODER_A));
-        detachInterrupt(digitalPinToInterrupt(pins::RIGHT_ENCODER_B));
-
-        // Configure GPIO wake-up sources for light sleep
-        gpio_wakeup_enable(static_cast<gpio_num_t>(pins::BTN_UNDER_C),
-                           GPIO_INTR_LOW_LEVEL);
-        gpio_wakeup_enable(static_cast<gpio_num_t>(pins::BTN_UNDER_L),
-                           GPIO_INTR_LOW_LEVEL);
-        gpio_wakeup_enable(static_cast<gpio_num_t>(pins::BTN_UNDER_R),
-                           GPIO_INTR_LOW_LEVEL);
-
-        // Enable GPIO wake-up
-        esp_sleep_enable_gpio_wakeup();
-
-        // Use light sleep - more reliable wake-up
-        esp_light_sleep_start();
-
-        // Skip GPIO wake-up cleanup - just restart immediately to avoid conflicts
-        // The restart will clean up everything properly
-        espSilentRestart();
+        leftEncoder.end();
+        rightEncoder.end();
+        detachInputInterrupts();
+
+        // Waking boots afresh and picks the saved state back up.
+        enterDeepSleepWithResume(resume);
     };
 
 }  // namespace actions
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "dispatcher.h"
+
+#include <esp_timer.h>
+#include <freertos/queue.h>
+
+#include "devices/device.h"
+#include "services/hotlog.h"
+#include "utils/StaticRtos.h"
+
+static const char *DISPATCHER_TAG = "DISPATCHER";
+
+// Statistics are logged after this many events.
+static const uint32_t STATS_EVERY = 64;
+
+// The name is how queued events are told apart, so check that it is cut out
+// of __PRETTY_FUNCTION__ as expected by the compiler that builds the firmware.
+static_assert(TypeInfo<right_button_pressed>::name == "right_button_pressed",
+              "TypeInfo can't parse this compiler's __PRETTY_FUNCTION__");
+
+static StaticQueue<event_queue::QueuedEvent, EVENT_QUEUE_LENGTH>
+    eventQueueMemory;
+static StaticTask<8 * configMINIMAL_STACK_SIZE> dispatcherTaskMemory;
+static QueueHandle_t eventQueue = NULL;
+static TaskHandle_t dispatcherTaskHandle = NULL;
+
+static portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;
+static DispatchStats stats = {};
+
+static uint32_t nowUs() { return (uint32_t)esp_timer_get_time(); }
+
+bool event_queue::post(const QueuedEvent &event) {
+    if (eventQueue == NULL) {
+        ESP_LOGW(DISPATCHER_TAG, "%s posted before the dispatcher started",
+                 event.name);
+        return false;
+    }
+
+    QueuedEvent queued = event;
+    queued.postedUs = nowUs();
+    bool sent = xQueueSend(eventQueue, &queued, 0) == pdTRUE;
+    bool waited = false;
+    if (!sent && xTaskGetCurrentTaskHandle() != dispatcherTaskHandle) {
+        waited = true;
+        sent = xQueueSend(eventQueue, &queued,
+                          pdMS_TO_TICKS(EVENT_POST_WAIT_MS)) == pdTRUE;
+    }
+    uint32_t depth = uxQueueMessagesWaiting(eventQueue);
+
+    portENTER_CRITICAL(&statsLock);
+    stats.posted++;
+    stats.blocked += waited ? 1 : 0;
+    stats.dropped += sent ? 0 : 1;
+    stats.maxDepth = max(stats.maxDepth, depth);
+    portEXIT_CRITICAL(&statsLock);
+
+    if (!sent) {
+        HOT_LOGW(STATE_MACHINE, "Event queue full, dropped %s",
+                 HotLogStatic{event.name});
+    }
+    return sent;
+}
+
+static void recordDispatch(const event_queue::QueuedEvent &event,
+                           uint32_t startUs, uint32_t endUs,
+                           bool connecting) {
+    uint32_t queueUs = startUs - event.postedUs;
+    uint32_t handleUs = endUs - startUs;
+    uint32_t totalUs = endUs - event.postedUs;
+    bool worstInput = false;
+    // Names are unique per type, so the pointer identifies the event.
+    bool rightButton =
+        event.name == TypeInfo<right_button_pressed>::name.data();
+
+    portENTER_CRITICAL(&statsLock);
+    stats.dispatched++;
+    stats.maxQueueUs = max(stats.maxQueueUs, queueUs);
+    if (handleUs > stats.maxHandleUs) {
+        stats.maxHandleUs = handleUs;
+        stats.slowestEvent = event.name;
+    }
+    if (event.source == EventSource::Input) {
+        worstInput = totalUs > stats.worstInputUs;
+        stats.worstInputUs = max(stats.worstInputUs, totalUs);
+        if (connecting) {
+            stats.worstInputConnectingUs =
+                max(stats.worstInputConnectingUs, totalUs);
+        }
+    }
+    if (rightButton) {
+        stats.lastRightButtonUs = totalUs;
+        stats.worstRightButtonUs = max(stats.worstRightButtonUs, totalUs);
+    }
+    bool report = stats.dispatched % STATS_EVERY == 0;
+    portEXIT_CRITICAL(&statsLock);
+
+    if (rightButton) {
+        HOT_LOGD(STATE_MACHINE, "right_button_pressed took %lu us (%lu us "
+                 "queued)", totalUs, queueUs);
+    }
+    if (worstInput) {
+        HOT_LOGI(STATE_MACHINE,
+                 "Slowest button event so far: %s, %lu us queued + %lu us "
+                 "handled%s",
+                 HotLogStatic{event.name}, queueUs, handleUs,
+                 HotLogStatic{connecting ? " while connecting" : ""});
+    }
+    if (report) {
+        printDispatchStats();
+    }
+}
+
+static void dispatcherTask(void *pvParameters) {
+    event_queue::QueuedEvent event;
+    while (true) {
+        xQueueReceive(eventQueue, &event, portMAX_DELAY);
+        // The pointer is only replaced by actions, which run on this task
+        // (and by the reconnect boot step, before the task starts), and they
+        // unhook it before a worker frees it. isConnected is atomic, as the
+        // BLE host task sets it.
+        Device *current = device;
+        bool connecting = current != nullptr && !current->isConnected;
+        uint32_t startUs = nowUs();
+        event.dispatch();
+        recordDispatch(event, startUs, nowUs(), connecting);
+    }
+}
+
+void initEventQueue() {
+    if (eventQueue == NULL) {
+        eventQueue = eventQueueMemory.create();
+    }
+}
+
+void initDispatcher() {
+    if (dispatcherTaskHandle != NULL) {
+        return;
+    }
+    initEventQueue();
+    // Above the connection and worker tasks, below the UI tasks the actions
+    // start, which draw as soon as they are created.
+    dispatcherTaskHandle =
+        dispatcherTaskMemory.start(dispatcherTask, "smDispatcher", NULL, 4, 1);
+}
+
+DispatchStats getDispatchStats() {
+    portENTER_CRITICAL(&statsLock);
+    DispatchStats copy = stats;
+    portEXIT_CRITICAL(&statsLock);
+    return copy;
+}
+
+void printDispatchStats() {
+    DispatchStats copy = getDispatchStats();
+    ESP_LOGI(DISPATCHER_TAG,
+             "%lu posted, %lu dispatched, %lu blocked, %lu dropped, max "
+             "depth %lu/%lu",
+             (unsigned long)copy.posted, (unsigned long)copy.dispatched,
+             (unsigned long)copy.blocked, (unsigned long)copy.dropped,
+             (unsigned long)copy.maxDepth, (unsigned long)EVENT_QUEUE_LENGTH);
+    ESP_LOGI(DISPATCHER_TAG,
+             "Max queued %lu us, max handled %lu us (%s); worst button %lu us, "
+             "%lu us while connecting",
+             (unsigned long)copy.maxQueueUs, (unsigned long)copy.maxHandleUs,
+             copy.slowestEvent ? copy.slowestEvent : "-",
+             (unsigned long)copy.worstInputUs,
+             (unsigned long)copy.worstInputConnectingUs);
+    ESP_LOGI(DISPATCHER_TAG, "right_button_pressed last %lu us, worst %lu us",
+             (unsigned long)copy.lastRightButtonUs,
+             (unsigned long)copy.worstRightButtonUs);
+}
@@ -0,0 +1,98 @@
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+
+#include <stdint.h>
+
+#include "remote.h"
+#include "utils/TypeName.h"
+
+/**
+ * Every state machine event goes through one queue and is processed by a
+ * single dispatcher task, so the task that raises an event (button, BLE,
+ * scan, WiFi) never waits on the state machine lock or on the actions the
+ * event runs.
+ *
+ * postEvent<TEvent>() returns once the event is queued. When the queue is
+ * full it waits up to EVENT_POST_WAIT_MS for room, then drops the event;
+ * both are counted in DispatchStats. The dispatcher itself never waits, as
+ * it is the one emptying the queue.
+ */
+
+static const uint32_t EVENT_QUEUE_LENGTH = 16;
+static const uint32_t EVENT_POST_WAIT_MS = 50;
+
+// Who raised an event, for the latency figures.
+enum class EventSource : uint8_t {
+    System,
+    Input,
+};
+
+struct DispatchStats {
+    uint32_t posted;
+    uint32_t dispatched;
+    // Posts that found the queue full and had to wait, and those that gave
+    // up and were dropped.
+    uint32_t blocked;
+    uint32_t dropped;
+    uint32_t maxDepth;
+    // From post to the dispatcher picking the event up.
+    uint32_t maxQueueUs;
+    // Inside process_event: guards, actions and entry of the next state.
+    uint32_t maxHandleUs;
+    const char *slowestEvent;
+    // Post to handled, for button events.
+    uint32_t worstInputUs;
+    // The same, counting only events that arrived while a device was
+    // connecting.
+    uint32_t worstInputConnectingUs;
+    // Post to handled for right_button_pressed, which opens the selected
+    // item: the last press and the slowest.
+    uint32_t lastRightButtonUs;
+    uint32_t worstRightButtonUs;
+};
+
+// Creates the queue. Called first thing in setup(), so tasks started during
+// boot can post before the state machine exists; their events wait in the
+// queue.
+void initEventQueue();
+
+// Starts the dispatcher task. Called by initStateMachine() once the machine
+// exists.
+void initDispatcher();
+
+// Copies the statistics so far.
+DispatchStats getDispatchStats();
+
+// Logs the statistics at info level. The dispatcher does so every 64 events.
+void printDispatchStats();
+
+namespace event_queue {
+
+typedef void (*Dispatch)();
+
+struct QueuedEvent {
+    Dispatch dispatch;
+    const char *name;
+    uint32_t postedUs;
+    EventSource source;
+};
+
+template <class TEvent>
+void process() {
+    stateMachine->process_event(TEvent{});
+}
+
+bool post(const QueuedEvent &event);
+
+}  // namespace event_queue
+
+// Events go through the queue by type only, so they can't carry data.
+template <class TEvent>
+bool postEvent(EventSource source = EventSource::System) {
+    static_assert(sizeof(TEvent) == sizeof(base_event),
+                  "Queued events can't carry data");
+    return event_queue::post({&event_queue::process<TEvent>,
+                              TypeInfo<TEvent>::name.data(), 0, source});
+}
+
+#endif  // DISPATCHER_H
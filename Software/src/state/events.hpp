@@ -31,6 +31,9 @@ struct middle_button_pressed : public base_event {};
 
 struct middle_button_second_press : public base_event {};
 
+// The middle button held down.
+struct sleep_button_pressed : public base_event {};
+
 struct done : public base_event {};
 
 struct connected_event : public base_event {};
@@ -1,5 +1,6 @@
 #include "events.hpp"
 #include "services/encoder.h"
+#include "services/resume.h"
 
 // template <typename Event>
 // constexpr bool is_valid(const Event &event)
@@ -21,19 +22,18 @@ auto isOption = [](MenuItemE value)
 {
     return [value](const Event &event) -> bool
     {
-        auto currentOption = rightEncoder.readEncoder();
         auto indexOfValue = -1;
 
         for (int i = 0; i < activeMenuCount; i++)
         {
-            if (activeMenu->at(i).id == value)
+            if (activeMenu[i].id == value)
             {
                 indexOfValue = i;
                 break;
             }
         }
 
-        bool result = currentOption == indexOfValue;
+        bool result = currentOption.load() == indexOfValue;
         return result;
     };
 };
@@ -47,4 +47,18 @@ template <typename Event = left_button_pressed>
 auto hasDeviceSettingsMenu = [](const Event &event) -> bool
 {
     return device != nullptr && device->settingsMenu.size() > 0;
-};
\ No newline at end of file
+};
+
+// A direct connection to the remembered peer was started at boot.
+template <typename Event = done>
+auto isReconnecting = [](const Event &event) -> bool
+{
+    return device != nullptr;
+};
+// Woke from deep sleep taken without a device connected.
+template <typename Event = done>
+auto isResumingToMenu = [](const Event &event) -> bool
+{
+    return isResuming() &&
+           getResumeState().screen == ResumeScreen::MainMenu;
+};
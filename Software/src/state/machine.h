@@ -13,20 +13,31 @@ struct ossm_remote_state {
 
         return make_transition_table(
             // clang-format off
-            *"init"_s + event<done> = "device_search"_s,
+            *"init"_s + event<done>[isReconnecting<>] = "device_reconnecting"_s,
+            "init"_s + event<done>[isResumingToMenu<>] = "main_menu"_s,
+            "init"_s + event<done> = "device_search"_s,
 
-            "device_search"_s + on_entry<_> / (drawPage(deviceSearchPage),search, []() { setLed(LEDColors::logoBlue, 255, 1500); }),
+            "device_reconnecting"_s + on_entry<_> / (drawPage(deviceReconnectingPage), playConnectingAnimation),
+            "device_reconnecting"_s + event<connected_event> = "device_draw_control"_s,
+            "device_reconnecting"_s + event<connected_error_event> / disconnect = "device_search"_s,
+            "device_reconnecting"_s + event<left_button_pressed> / disconnect = "device_search"_s,
+
+            "device_search"_s + on_entry<_> / (drawPage(deviceSearchPage), search, playSearchAnimation),
             "device_search"_s + event<devices_found_event> = "device_list"_s,
+            "device_search"_s + event<device_selected_event> / selectKnownDevice = "device_connecting"_s,
             "device_search"_s + event<connected_event> = "device_draw_control"_s,
             "device_search"_s + event<left_button_pressed> / disconnect = "main_menu"_s,
 
             "device_list"_s + on_entry<_> / drawDeviceList,
             "device_list"_s + event<right_button_pressed> / selectDevice = "device_connecting"_s,
+            // The scan keeps running behind the list, so the last device can still turn up.
+            "device_list"_s + event<device_selected_event> / selectKnownDevice = "device_connecting"_s,
             "device_list"_s + event<left_button_pressed> / (disconnect, clearDeviceList) = "main_menu"_s,
+            "device_list"_s + boost::sml::on_exit<_> / releaseEncoders,
 
-            "device_connecting"_s + on_entry<_> / drawPage(deviceConnectingPage),
+            "device_connecting"_s + on_entry<_> / (drawPage(deviceConnectingPage), playConnectingAnimation),
             "device_connecting"_s + event<connected_event> = "device_draw_control"_s,
-            "device_connecting"_s + event<connected_error_event> = "device_list"_s,
+            "device_connecting"_s + event<connected_error_event> / stopConnectingAnimation = "device_list"_s,
             "device_connecting"_s + event<left_button_pressed> / disconnect = "device_list"_s,
 
             "main_menu"_s + on_entry<_> / drawMainMenu,
@@ -35,12 +46,15 @@ struct ossm_remote_state {
             "main_menu"_s + event<right_button_pressed>[isOption<>(MenuItemE::DEEP_SLEEP)] = "deep_sleep"_s,
             "main_menu"_s + event<right_button_pressed>[isOption<>(MenuItemE::RESTART)] = "restart"_s,
             "main_menu"_s + event<connected_event> / start = "device_draw_control"_s,
+            "main_menu"_s + event<sleep_button_pressed> = "deep_sleep"_s,
+            "main_menu"_s + boost::sml::on_exit<_> / releaseEncoders,
 
             "settings_menu"_s + on_entry<_> / drawSettingsMenu,
             "settings_menu"_s + event<left_button_pressed> = "main_menu"_s,
             "settings_menu"_s + event<right_button_pressed>[isOption<>(MenuItemE::BACK)] = "main_menu"_s,
             "settings_menu"_s + event<right_button_pressed>[isOption<>(MenuItemE::WIFI_SETTINGS)] = "wmConfig"_s,
             "settings_menu"_s + event<right_button_pressed>[isOption<>(MenuItemE::RESTART)] = "restart"_s,
+            "settings_menu"_s + boost::sml::on_exit<_> / releaseEncoders,
 
             "wmConfig"_s + on_entry<_> / (drawPage(wifiSettingsPage), startWiFiPortal),
             "wmConfig"_s + event<left_button_pressed> = "settings_menu"_s,
@@ -54,6 +68,9 @@ struct ossm_remote_state {
             "device_draw_control"_s + event<middle_button_pressed> / softPause,
             "device_draw_control"_s + event<middle_button_second_press> / stop = "device_stop"_s,
             "device_draw_control"_s + event<disconnected_event> / disconnect = "main_menu"_s,
+            // Sleeping keeps the session: waking reconnects and comes back here.
+            "device_draw_control"_s + event<sleep_button_pressed> / stop = "deep_sleep"_s,
+            "device_draw_control"_s + boost::sml::on_exit<_> / releaseEncoders,
 
             "device_menu"_s + on_entry<_> / drawDeviceMenu,
             "device_menu"_s + event<left_button_pressed> = "device_draw_control"_s,
@@ -61,12 +78,15 @@ struct ossm_remote_state {
             "device_menu"_s + event<middle_button_second_press> / softPause = "device_draw_control"_s,
             "device_menu"_s + event<middle_button_pressed> / softPause = "device_draw_control"_s,
             "device_menu"_s + event<disconnected_event> / disconnect = "main_menu"_s,
+            "device_menu"_s + event<sleep_button_pressed> / stop = "deep_sleep"_s,
+            "device_menu"_s + boost::sml::on_exit<_> / releaseEncoders,
 
             "device_stop"_s + on_entry<_> / (drawPage(deviceStopPage), stop),
             "device_stop"_s + event<right_button_pressed> / disconnect = "main_menu"_s,
             "device_stop"_s + event<left_button_pressed> / start = "device_draw_control"_s,
             "device_stop"_s + event<middle_button_pressed> / start = "device_draw_control"_s,
             "device_stop"_s + event<disconnected_event> / disconnect = "main_menu"_s,
+            "device_stop"_s + event<sleep_button_pressed> = "deep_sleep"_s,
 
             "restart"_s + on_entry<_> / espRestart,
             "restart"_s = X,
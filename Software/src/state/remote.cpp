@@ -1,5 +1,81 @@
 #include "remote.h"
 
+#include "dispatcher.h"
+
+#include <esp_attr.h>
+#include <esp_ota_ops.h>
+#include <esp_system.h>
+
+static const size_t TRANSITION_RECORDS = 32;
+
+struct TransitionLog {
+    // Identifies the firmware that wrote the ring; the names are pointers
+    // into its flash, so another build's ring cannot be printed.
+    uint32_t firmware;
+    uint32_t head;
+    TransitionRecord records[TRANSITION_RECORDS];
+};
+
+// Left alone by a reset, so a crash can be looked into on the next boot.
+RTC_NOINIT_ATTR static TransitionLog transitionLog;
+
+static const char *const TRANSITION_KIND_NAMES[] = {"event", "guard",
+                                                    "state"};
+
+static uint32_t firmwareStamp() {
+    const esp_app_desc_t *app = esp_ota_get_app_description();
+    uint32_t stamp;
+    memcpy(&stamp, app->app_elf_sha256, sizeof(stamp));
+    return stamp;
+}
+
+void StateLogger::begin() {
+    esp_reset_reason_t reason = esp_reset_reason();
+    bool crashed = reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT ||
+                   reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT;
+    if (crashed && transitionLog.firmware == firmwareStamp()) {
+        ESP_LOGW(STATE_MACHINE_TAG,
+                 "Reset by a crash (reason %d), last transitions:",
+                 (int)reason);
+        dumpTransitions();
+    }
+
+    memset(&transitionLog, 0, sizeof(transitionLog));
+    transitionLog.firmware = firmwareStamp();
+}
+
+void StateLogger::dumpTransitions() {
+    uint32_t head = transitionLog.head;
+    uint32_t start = head > TRANSITION_RECORDS ? head - TRANSITION_RECORDS : 0;
+    for (uint32_t i = start; i < head; i++) {
+        const TransitionRecord &entry =
+            transitionLog.records[i % TRANSITION_RECORDS];
+        size_t kind = static_cast<size_t>(entry.kind);
+        if (kind >= sizeof(TRANSITION_KIND_NAMES) / sizeof(char *) ||
+            entry.name == nullptr) {
+            continue;
+        }
+        if (entry.kind == TransitionKind::StateChange) {
+            ESP_LOGW(STATE_MACHINE_TAG, "%8lu ms  state  %s -> %s",
+                     (unsigned long)entry.timestampMs, entry.source,
+                     entry.name);
+        } else {
+            ESP_LOGW(STATE_MACHINE_TAG, "%8lu ms  %-5s  %s%s",
+                     (unsigned long)entry.timestampMs,
+                     TRANSITION_KIND_NAMES[kind], entry.name,
+                     entry.passed ? "" : " [DO NOT PASS]");
+        }
+    }
+}
+
+void StateLogger::record(TransitionKind kind, uint32_t id, const char *name,
+                         const char *source, bool passed) {
+    TransitionRecord &entry =
+        transitionLog.records[transitionLog.head % TRANSITION_RECORDS];
+    entry = {static_cast<uint32_t>(millis()), id, name, source, kind, passed};
+    transitionLog.head++;
+}
+
 StateLogger stateLogger;
 // Static pointer to hold the state machine instance
 sml::sm<ossm_remote_state, sml::thread_safe<ESP32RecursiveMutex>, sml::logger<StateLogger>> *stateMachine = nullptr;
@@ -8,8 +84,12 @@ void initStateMachine()
 {
     if (stateMachine == nullptr)
     {
+        stateLogger.begin();
         stateMachine = new sml::sm<ossm_remote_state, sml::thread_safe<ESP32RecursiveMutex>, sml::logger<StateLogger>>(stateLogger);
 
+        // Straight in rather than queued, so the first page is up when
+        // this returns. Events posted during boot follow it.
         stateMachine->process_event(done{});
+        initDispatcher();
     }
 }
\ No newline at end of file
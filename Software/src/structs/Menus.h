@@ -7,6 +7,7 @@
 
 #include "components/Icons.h"
 #include "constants/Strings.h"
+#include "services/heap.h"
 // numeric enum for every menu item ever.
 enum MenuItemE {
     DEVICE_SEARCH,
@@ -21,11 +22,13 @@ enum MenuItemE {
     DEEP_SLEEP
 };
 
+// Plain pointers, so menus can be constant tables in flash. Device menus
+// point their strings into the device's menuStrings pool.
 struct MenuItem {
-    const MenuItemE id;
-    const std::string name;
+    MenuItemE id;
+    const char *name;
     const uint8_t *bitmap;
-    const std::optional<std::string> description = std::nullopt;
+    const char *description = nullptr;
 
     // optional color defaults to -1;
     int color = -1;
@@ -36,18 +39,21 @@ struct MenuItem {
     int metaIndex = -1;
 };
 
+using MenuList =
+    std::vector<MenuItem, PlacedAllocator<MenuItem, HeapUser::Menus>>;
+
 // MainMenu
 
-static std::vector<MenuItem> mainMenu = {
+inline constexpr MenuItem mainMenu[] = {
     {MenuItemE::DEVICE_SEARCH, OSSM_CONTROLLER_NAME, researchAndDesireWaves},
     {MenuItemE::SETTINGS, SETTINGS_NAME, bitmap_settings},
     {MenuItemE::DEEP_SLEEP, DEEP_SLEEP_NAME, bitmap_sleep}};
 
-static const int numMainMenu = mainMenu.size();
+inline constexpr int numMainMenu = sizeof(mainMenu) / sizeof(mainMenu[0]);
 
 // SettingsMenu
 
-static std::vector<MenuItem> settingsMenu = {
+inline constexpr MenuItem settingsMenu[] = {
     {MenuItemE::BACK, GO_BACK_NAME, bitmap_back},
     {MenuItemE::WIFI_SETTINGS, WIFI_SETTINGS_NAME, bitmap_wifi},
     // {MenuItemE::PAIRING, PAIRING_NAME, bitmap_link},
@@ -55,6 +61,7 @@ static std::vector<MenuItem> settingsMenu = {
     {MenuItemE::RESTART, RESTART_NAME, bitmap_restart},
 };
 
-static const int numSettingsMenu = settingsMenu.size();
+inline constexpr int numSettingsMenu =
+    sizeof(settingsMenu) / sizeof(settingsMenu[0]);
 
 #endif
\ No newline at end of file
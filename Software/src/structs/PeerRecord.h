@@ -0,0 +1,37 @@
+#ifndef SOFTWARE_PEERRECORD_H
+#define SOFTWARE_PEERRECORD_H
+
+#include <stdint.h>
+
+// The last device the remote connected to, persisted in the AT24C04 so the
+// next boot can connect straight to it without scanning.
+struct PeerRecord {
+    static constexpr uint8_t VERSION = 1;
+
+    uint8_t version = VERSION;
+    uint8_t address[6] = {};
+    uint8_t addressType = 0;
+    // Service UUID, used to pick the device factory from the registry.
+    char serviceUUID[37] = {};
+    // Resolved ButtplugIO protocol file, empty for built-in devices.
+    char protocolFile[48] = {};
+    uint8_t checksum = 0;
+
+    // Sum of every byte before `checksum`, inverted so an erased (0xFF) or
+    // zeroed chip never validates.
+    uint8_t computeChecksum() const {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(this);
+        uint8_t sum = 0;
+        for (const uint8_t *b = bytes; b < &checksum; b++) {
+            sum += *b;
+        }
+        return ~sum;
+    }
+
+    bool isValid() const {
+        return version == VERSION && checksum == computeChecksum() &&
+               serviceUUID[0] != '\0';
+    }
+};
+
+#endif  // SOFTWARE_PEERRECORD_H
@@ -0,0 +1,59 @@
+#ifndef SOFTWARE_RECT_H
+#define SOFTWARE_RECT_H
+
+#include <stdint.h>
+
+// Axis-aligned screen rectangle used for widget bounds, clipping and damage.
+struct Rect {
+    int16_t x = 0;
+    int16_t y = 0;
+    int16_t width = 0;
+    int16_t height = 0;
+
+    constexpr bool isEmpty() const { return width <= 0 || height <= 0; }
+
+    constexpr int16_t right() const { return x + width; }
+    constexpr int16_t bottom() const { return y + height; }
+
+    constexpr bool intersects(const Rect &other) const {
+        return !isEmpty() && !other.isEmpty() && x < other.right() &&
+               other.x < right() && y < other.bottom() && other.y < bottom();
+    }
+
+    constexpr bool contains(const Rect &other) const {
+        return other.isEmpty() ||
+               (x <= other.x && y <= other.y && other.right() <= right() &&
+                other.bottom() <= bottom());
+    }
+
+    // Overlapping area of both rects, empty if they do not intersect.
+    constexpr Rect intersect(const Rect &other) const {
+        if (!intersects(other)) {
+            return Rect{};
+        }
+        int16_t left = x > other.x ? x : other.x;
+        int16_t top = y > other.y ? y : other.y;
+        int16_t r = right() < other.right() ? right() : other.right();
+        int16_t b = bottom() < other.bottom() ? bottom() : other.bottom();
+        return Rect{left, top, static_cast<int16_t>(r - left),
+                    static_cast<int16_t>(b - top)};
+    }
+
+    // Smallest rect containing both, ignoring empty rects.
+    constexpr Rect unite(const Rect &other) const {
+        if (isEmpty()) {
+            return other;
+        }
+        if (other.isEmpty()) {
+            return *this;
+        }
+        int16_t left = x < other.x ? x : other.x;
+        int16_t top = y < other.y ? y : other.y;
+        int16_t r = right() > other.right() ? right() : other.right();
+        int16_t b = bottom() > other.bottom() ? bottom() : other.bottom();
+        return Rect{left, top, static_cast<int16_t>(r - left),
+                    static_cast<int16_t>(b - top)};
+    }
+};
+
+#endif  // SOFTWARE_RECT_H
@@ -0,0 +1,234 @@
+#ifndef SOFTWARE_BATTERYESTIMATOR_H
+#define SOFTWARE_BATTERYESTIMATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "RunningRegression.h"
+
+// Battery state-of-charge estimation, kept free of Arduino and driver
+// includes so recorded fuel gauge traces can be replayed through it on a
+// host.
+
+struct BatterySample {
+    uint32_t timeMs;
+    float percent;
+    float voltage;
+    // The gauge's own rate estimate (CRATE register), in %/hour.
+    float chipRatePercentPerHour;
+};
+
+/**
+ * @brief Smooths the state-of-charge trend and turns it into time to empty.
+ *
+ * The gauge's CRATE register reacts quickly but is noisy at light loads; a
+ * regression over the last half hour of readings is steady but slow to
+ * start. Once the regression covers enough time the two are averaged.
+ */
+class BatteryEstimator {
+  public:
+    // Below this the trend is treated as flat.
+    static constexpr float FLAT_RATE_PERCENT_PER_HOUR = 0.2f;
+    // Time the regression must cover before it is trusted.
+    static constexpr float MIN_SPAN_HOURS = 5.0f / 60.0f;
+    // Caps estimates from a nearly flat trend.
+    static constexpr float MAX_MINUTES_TO_EMPTY = 48.0f * 60.0f;
+
+    BatteryEstimator() : trend(0.5f) {}
+
+    void add(const BatterySample &sample) {
+        if (hasSample && sample.timeMs < lastTimeMs) {
+            // Clock went backwards, e.g. after a restart; start over.
+            trend.reset();
+            elapsedHours = 0.0f;
+        } else if (hasSample) {
+            elapsedHours += (sample.timeMs - lastTimeMs) / 3600000.0f;
+        }
+        trend.add(elapsedHours, sample.percent);
+        lastTimeMs = sample.timeMs;
+        percent = sample.percent;
+        chipRate = sample.chipRatePercentPerHour;
+        hasSample = true;
+    }
+
+    bool valid() const { return hasSample; }
+
+    float currentPercent() const { return percent; }
+
+    // Change in state of charge, in %/hour; negative while discharging.
+    float ratePercentPerHour() const {
+        if (trend.hasSlope() && trend.coveredSpan() >= MIN_SPAN_HOURS) {
+            return (trend.slope() + chipRate) / 2.0f;
+        }
+        return chipRate;
+    }
+
+    bool isCharging() const {
+        return hasSample && ratePercentPerHour() > FLAT_RATE_PERCENT_PER_HOUR;
+    }
+
+    // Minutes until 0% at the current rate, or -1 while charging or flat.
+    float minutesToEmpty() const {
+        float rate = ratePercentPerHour();
+        if (!hasSample || rate > -FLAT_RATE_PERCENT_PER_HOUR) {
+            return -1.0f;
+        }
+        float minutes = percent / -rate * 60.0f;
+        return minutes < MAX_MINUTES_TO_EMPTY ? minutes : MAX_MINUTES_TO_EMPTY;
+    }
+
+  private:
+    RunningRegression trend;  // % against hours since the first sample
+    float elapsedHours = 0.0f;
+    uint32_t lastTimeMs = 0;
+    float percent = 0.0f;
+    float chipRate = 0.0f;
+    bool hasSample = false;
+};
+
+// Consumers that drain is attributed to.
+enum class PowerConsumer : uint8_t { Base, Screen, Ble, Leds, COUNT };
+
+/**
+ * @brief Splits the charge used since the session started between consumers.
+ *
+ * There is no per-rail current sense, so each consumer's estimated current
+ * is integrated over time and the measured drop in state of charge is
+ * shared out in proportion.
+ */
+class DrainAttribution {
+  public:
+    void start(float percent, uint32_t timeMs) {
+        startPercent = percent;
+        startMs = timeMs;
+        lastMs = timeMs;
+        for (size_t i = 0; i < COUNT; i++) {
+            charge[i] = 0.0f;
+        }
+    }
+
+    // Charges each consumer for the time since the last call at the given
+    // estimated currents, indexed by PowerConsumer.
+    void accumulate(const float (&milliamps)[static_cast<size_t>(
+                        PowerConsumer::COUNT)],
+                    uint32_t timeMs) {
+        float hours = (timeMs - lastMs) / 3600000.0f;
+        lastMs = timeMs;
+        for (size_t i = 0; i < COUNT; i++) {
+            charge[i] += milliamps[i] * hours;
+        }
+    }
+
+    uint32_t sessionMs() const { return lastMs - startMs; }
+
+    // Percentage points drained since start() by all consumers.
+    float drainedPercent(float currentPercent) const {
+        float drained = startPercent - currentPercent;
+        return drained > 0.0f ? drained : 0.0f;
+    }
+
+    // Percentage points of the drain attributed to `consumer`.
+    float drainedPercent(PowerConsumer consumer, float currentPercent) const {
+        float total = 0.0f;
+        for (size_t i = 0; i < COUNT; i++) {
+            total += charge[i];
+        }
+        if (total <= 0.0f) {
+            return 0.0f;
+        }
+        return drainedPercent(currentPercent) *
+               charge[static_cast<size_t>(consumer)] / total;
+    }
+
+  private:
+    static constexpr size_t COUNT = static_cast<size_t>(PowerConsumer::COUNT);
+
+    float startPercent = 0.0f;
+    uint32_t startMs = 0;
+    uint32_t lastMs = 0;
+    float charge[COUNT] = {};  // estimated mAh per consumer
+};
+
+/**
+ * @brief State-of-charge history at several resolutions in a fixed block.
+ *
+ * Every sample goes into the finest ring; each coarser ring stores the
+ * average of `DECIMATION` entries of the one below it. Plain data with no
+ * constructor, so it can live in RTC memory across deep sleep: zeroed
+ * memory reads as an empty history.
+ */
+struct BatteryHistory {
+    static constexpr size_t LEVELS = 3;
+    static constexpr size_t CAPACITY = 48;
+    static constexpr uint8_t DECIMATION[LEVELS] = {1, 6, 10};
+
+    struct Entry {
+        uint16_t percentCenti;  // 0.01 %
+        uint16_t millivolts;
+    };
+
+    struct Level {
+        Entry entries[CAPACITY];
+        uint8_t head;  // next slot to write
+        uint8_t count;
+        // Running sums of the entries below still to be averaged in.
+        uint32_t pendingPercent;
+        uint32_t pendingMillivolts;
+        uint8_t pendingCount;
+    };
+
+    Level levels[LEVELS];
+
+    void add(float percent, float voltage) {
+        Entry entry;
+        entry.percentCenti = static_cast<uint16_t>(
+            percent <= 0.0f ? 0 : (percent >= 100.0f ? 10000 : percent * 100));
+        entry.millivolts = static_cast<uint16_t>(voltage * 1000);
+        push(0, entry);
+    }
+
+    // Entries of `level`, oldest first. Returns how many were copied.
+    size_t read(size_t level, Entry *out, size_t max) const {
+        if (level >= LEVELS) {
+            return 0;
+        }
+        const Level &l = levels[level];
+        size_t n = l.count < max ? l.count : max;
+        size_t first = (l.head + CAPACITY - n) % CAPACITY;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = l.entries[(first + i) % CAPACITY];
+        }
+        return n;
+    }
+
+  private:
+    void push(size_t level, const Entry &entry) {
+        Level &l = levels[level];
+        l.entries[l.head] = entry;
+        l.head = (l.head + 1) % CAPACITY;
+        if (l.count < CAPACITY) {
+            l.count++;
+        }
+
+        if (level + 1 >= LEVELS) {
+            return;
+        }
+        Level &next = levels[level + 1];
+        next.pendingPercent += entry.percentCenti;
+        next.pendingMillivolts += entry.millivolts;
+        if (++next.pendingCount < DECIMATION[level + 1]) {
+            return;
+        }
+        Entry average;
+        average.percentCenti =
+            static_cast<uint16_t>(next.pendingPercent / next.pendingCount);
+        average.millivolts =
+            static_cast<uint16_t>(next.pendingMillivolts / next.pendingCount);
+        next.pendingPercent = 0;
+        next.pendingMillivolts = 0;
+        next.pendingCount = 0;
+        push(level + 1, average);
+    }
+};
+
+#endif  // SOFTWARE_BATTERYESTIMATOR_H
@@ -0,0 +1,129 @@
+#ifndef SOFTWARE_ENCODERMATH_H
+#define SOFTWARE_ENCODERMATH_H
+
+#include <stdint.h>
+
+// Everything here runs inside the encoder interrupt, so it has to live in
+// IRAM on the target. The header has no other Arduino dependencies, which
+// keeps the maths usable off-target.
+#if defined(ARDUINO)
+#include <esp_attr.h>
+#define ENCODER_MATH_IRAM IRAM_ATTR
+#else
+#define ENCODER_MATH_IRAM
+#endif
+
+namespace EncoderMath {
+
+    // Quarter steps per detent on the remote's encoders.
+    constexpr int8_t STEPS_PER_DETENT = 4;
+
+    // Velocity decays to zero when the knob has not moved for this long.
+    constexpr uint32_t VELOCITY_TIMEOUT_US = 250 * 1000;
+
+    // Detents closer together than this are treated as bounce for the
+    // velocity estimate, capping it at 2000 detents/s.
+    constexpr uint32_t MIN_DETENT_INTERVAL_US = 500;
+
+    // Step for a transition from `previous` to `current`, where each state is
+    // (B << 1) | A. Invalid transitions (both pins changed) count as 0.
+    // The table is packed two bits per entry so it stays in a register rather
+    // than in flash.
+    inline ENCODER_MATH_IRAM int8_t quadratureStep(uint8_t previous,
+                                                   uint8_t current) {
+        // {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0}
+        // with -1 stored as 0b11.
+        constexpr uint32_t TABLE = 0x3443C11Cu;
+        uint8_t index = ((previous & 0x03) << 2) | (current & 0x03);
+        uint8_t bits = (TABLE >> (index * 2)) & 0x03;
+        return bits == 0x03 ? -1 : static_cast<int8_t>(bits);
+    }
+
+    // Exponential moving average of the detent rate, in detents/s << 8.
+    // Updated once per detent; alpha is 1/4.
+    struct VelocityFilter {
+        uint32_t speedQ8 = 0;
+        uint32_t lastDetentUs = 0;
+        int8_t lastDirection = 0;
+
+        inline ENCODER_MATH_IRAM void addDetent(uint32_t nowUs,
+                                                int8_t direction) {
+            uint32_t intervalUs = nowUs - lastDetentUs;
+            lastDetentUs = nowUs;
+
+            if (direction != lastDirection ||
+                intervalUs >= VELOCITY_TIMEOUT_US) {
+                // Starting again from rest: one detent is not a speed yet.
+                lastDirection = direction;
+                speedQ8 = 0;
+                return;
+            }
+
+            if (intervalUs < MIN_DETENT_INTERVAL_US) {
+                intervalUs = MIN_DETENT_INTERVAL_US;
+            }
+            uint32_t instantQ8 = (1000000u << 8) / intervalUs;
+            if (speedQ8 == 0) {
+                speedQ8 = instantQ8;
+            } else {
+                int32_t error = static_cast<int32_t>(instantQ8) -
+                                static_cast<int32_t>(speedQ8);
+                speedQ8 += error / 4;
+            }
+        }
+    };
+
+    // Speed as seen at `nowUs`, zero once the knob has been still for
+    // VELOCITY_TIMEOUT_US.
+    inline uint32_t speedAt(uint32_t speedQ8, uint32_t lastDetentUs,
+                            uint32_t nowUs) {
+        return nowUs - lastDetentUs >= VELOCITY_TIMEOUT_US ? 0 : speedQ8;
+    }
+
+    // Maps detents to value steps. Below `thresholdDetentsPerSec` the knob is
+    // 1:1; above it each extra detent/s adds `gainQ8 / 256` to the multiplier,
+    // up to `maxMultiplier`.
+    struct AccelerationCurve {
+        uint16_t thresholdDetentsPerSec = 0;
+        uint16_t gainQ8 = 0;
+        uint8_t maxMultiplier = 1;
+
+        static constexpr AccelerationCurve linear() {
+            return AccelerationCurve();
+        }
+
+        // Multiplier in 8.8 fixed point for the given speed.
+        uint32_t multiplierQ8(uint32_t speedQ8) const {
+            uint32_t speed = speedQ8 >> 8;
+            if (gainQ8 == 0 || speed <= thresholdDetentsPerSec) {
+                return 256;
+            }
+            uint32_t multiplier =
+                256 + gainQ8 * (speed - thresholdDetentsPerSec);
+            uint32_t limit = static_cast<uint32_t>(maxMultiplier) << 8;
+            return multiplier < limit ? multiplier : limit;
+        }
+
+        // Scales `detents` and carries the fractional part in `residueQ8`,
+        // so slow turns never lose steps to rounding.
+        int32_t apply(int32_t detents, uint32_t speedQ8,
+                      int32_t &residueQ8) const {
+            if (detents == 0) {
+                return 0;
+            }
+            // Drop the carry when the direction changes.
+            if ((residueQ8 < 0) != (detents < 0)) {
+                residueQ8 = 0;
+            }
+            int32_t scaledQ8 =
+                detents * static_cast<int32_t>(multiplierQ8(speedQ8)) +
+                residueQ8;
+            int32_t steps = scaledQ8 / 256;
+            residueQ8 = scaledQ8 - steps * 256;
+            return steps;
+        }
+    };
+
+}  // namespace EncoderMath
+
+#endif  // SOFTWARE_ENCODERMATH_H
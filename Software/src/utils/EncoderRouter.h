@@ -0,0 +1,66 @@
+#ifndef SOFTWARE_ENCODERROUTER_H
+#define SOFTWARE_ENCODERROUTER_H
+
+#include <limits.h>
+
+#include <mutex>
+
+// Receives the latest value of one encoder. Return false if the consumer is
+// not ready yet; the value is offered again on the next dispatch.
+typedef bool (*EncoderHandler)(long value);
+
+// Where encoder changes go while a state is active. Either handler may be
+// nullptr to ignore that encoder.
+struct EncoderRoute {
+    const char *name;
+    EncoderHandler onLeft;
+    EncoderHandler onRight;
+};
+
+/**
+ * @brief Hands encoder values to the active route.
+ *
+ * offer() runs the handlers with `Lock` held, and set() takes it too, so once
+ * set() returns the old route's handlers are neither running nor called
+ * again. A value is offered to a handler until it accepts it, and a new
+ * route gets the current values even if they have not changed.
+ *
+ * `Lock` is anything with lock() and unlock().
+ */
+template <class Lock>
+class EncoderRouter {
+  public:
+    void set(const EncoderRoute *route) {
+        std::lock_guard<Lock> guard(lock);
+        active = route;
+        lastLeft = LONG_MIN;
+        lastRight = LONG_MIN;
+    }
+
+    // Returns the number of values handed over.
+    int offer(long left, long right) {
+        std::lock_guard<Lock> guard(lock);
+        int accepted = 0;
+        if (active != nullptr) {
+            accepted += offerOne(active->onLeft, left, lastLeft);
+            accepted += offerOne(active->onRight, right, lastRight);
+        }
+        return accepted;
+    }
+
+  private:
+    static int offerOne(EncoderHandler handler, long value, long &last) {
+        if (handler == nullptr || value == last || !handler(value)) {
+            return 0;
+        }
+        last = value;
+        return 1;
+    }
+
+    Lock lock;
+    const EncoderRoute *active = nullptr;
+    long lastLeft = LONG_MIN;
+    long lastRight = LONG_MIN;
+};
+
+#endif  // SOFTWARE_ENCODERROUTER_H
@@ -0,0 +1,75 @@
+#ifndef SOFTWARE_LEDTIMELINE_H
+#define SOFTWARE_LEDTIMELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Keyframe timelines for the LED service. Timelines are constant tables and
+// evaluation is a pure function of time, so the same inputs always produce
+// the same frame and nothing is allocated during playback.
+namespace LedTimeline {
+
+    // Level (0-255) at a point in the cycle. `phase` is in 1/65536ths of
+    // the period; levels are interpolated linearly up to the next keyframe.
+    struct Keyframe {
+        uint16_t phase;
+        uint8_t level;
+    };
+
+    struct Timeline {
+        const Keyframe *frames;  // sorted by phase, first one at phase 0
+        uint8_t frameCount;
+        // Length of one cycle. 0 follows the LED pace instead.
+        uint16_t periodMs;
+        // Phase each LED runs behind the one before it, e.g. to run a chase
+        // along the strip.
+        uint16_t ledPhaseStep;
+    };
+
+    template <size_t N>
+    constexpr Timeline make(const Keyframe (&frames)[N], uint16_t periodMs,
+                            uint16_t ledPhaseStep = 0) {
+        return Timeline{frames, static_cast<uint8_t>(N), periodMs,
+                        ledPhaseStep};
+    }
+
+    // Level of LED `led` at `elapsedMs` into playback, for a cycle of
+    // `periodMs` (the timeline's own period, or the pace for paced ones).
+    inline uint8_t evaluate(const Timeline &timeline, uint32_t elapsedMs,
+                            uint16_t periodMs, uint8_t led) {
+        if (timeline.frameCount == 0 || periodMs == 0) {
+            return 0;
+        }
+
+        uint32_t phase = (static_cast<uint32_t>(elapsedMs % periodMs) << 16) /
+                         periodMs;
+        phase = (phase - static_cast<uint32_t>(led) * timeline.ledPhaseStep) &
+                0xFFFF;
+
+        // Timelines are a handful of keyframes; a linear search is cheapest.
+        uint8_t i = 0;
+        while (i + 1 < timeline.frameCount &&
+               timeline.frames[i + 1].phase <= phase) {
+            i++;
+        }
+
+        const Keyframe &from = timeline.frames[i];
+        // The last keyframe interpolates back to the first one, one cycle on.
+        const bool wraps = i + 1 == timeline.frameCount;
+        const Keyframe &to = wraps ? timeline.frames[0] : timeline.frames[i + 1];
+        uint32_t toPhase = wraps ? 0x10000u + to.phase : to.phase;
+
+        uint32_t span = toPhase - from.phase;
+        if (span == 0) {
+            return from.level;
+        }
+        int32_t delta = static_cast<int32_t>(to.level) - from.level;
+        return from.level +
+               static_cast<int32_t>((delta * static_cast<int32_t>(
+                                                 phase - from.phase)) /
+                                    static_cast<int32_t>(span));
+    }
+
+}  // namespace LedTimeline
+
+#endif  // SOFTWARE_LEDTIMELINE_H
@@ -6,6 +6,8 @@
 #include <freertos/semphr.h>
 #include <boost/sml.hpp>
 
+#include "esp_log.h"
+
 /**
  * @brief ESP32RecursiveMutex class provides a recursive mutex functionality
  * using FreeRTOS primitives. It mimics the behavior of std::recursive_mutex.
@@ -16,14 +18,26 @@ class ESP32RecursiveMutex
 {
 public:
   // Constructor: Creates a new recursive mutex
-  ESP32RecursiveMutex() { mutex = xSemaphoreCreateRecursiveMutex(); }
+  ESP32RecursiveMutex()
+  {
+    mutex = xSemaphoreCreateRecursiveMutexStatic(&buffer);
+  }
 
   // Destructor: Deletes the recursive mutex
   ~ESP32RecursiveMutex() { vSemaphoreDelete(mutex); }
 
   // Locks the mutex. If the mutex is already locked by the same task,
-  // the function will return immediately instead of blocking.
-  void lock() { xSemaphoreTakeRecursive(mutex, portTICK_PERIOD_MS * 1000); }
+  // the function will return immediately instead of blocking. Waits for as
+  // long as it takes, warning every second with the name of the holder.
+  void lock()
+  {
+    while (xSemaphoreTakeRecursive(mutex, pdMS_TO_TICKS(1000)) != pdTRUE)
+    {
+      TaskHandle_t holder = xSemaphoreGetMutexHolder(mutex);
+      ESP_LOGW("MUTEX", "Still waiting on a lock held by %s",
+               holder != NULL ? pcTaskGetName(holder) : "nobody");
+    }
+  }
 
   // Unlocks the mutex.
   void unlock() { xSemaphoreGiveRecursive(mutex); }
@@ -39,7 +53,8 @@ public:
   ESP32RecursiveMutex &operator=(const ESP32RecursiveMutex &) = delete;
 
 private:
-  // Handle for the recursive mutex
+  // Handle for the recursive mutex, kept in `buffer` rather than the heap
   SemaphoreHandle_t mutex;
+  StaticSemaphore_t buffer;
 };
 #endif // SOFTWARE_RECUSIVEMUTEX_H
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef SOFTWARE_RUNNINGREGRESSION_H
+#define SOFTWARE_RUNNINGREGRESSION_H
+
+#include <math.h>
+
+/**
+ * @brief Least-squares line through a stream of (x, y) points, updated in
+ * O(1) per point.
+ *
+ * Older points fade out exponentially with a time constant of `tau` (in x
+ * units), so the fit follows the recent trend without storing any points.
+ * The sums are kept relative to the newest x, which keeps them small enough
+ * for float precision however long the stream runs. x must not decrease.
+ */
+class RunningRegression {
+  public:
+    explicit RunningRegression(float tau) : tau(tau) {}
+
+    void add(float x, float y) {
+        if (weight > 0.0f) {
+            float dx = x - lastX;
+            // Re-centre the sums on the new point, then fade them.
+            sumXX += dx * (weight * dx - 2.0f * sumX);
+            sumXY -= dx * sumY;
+            sumX -= weight * dx;
+
+            float decay = expf(-dx / tau);
+            weight *= decay;
+            sumX *= decay;
+            sumY *= decay;
+            sumXX *= decay;
+            sumXY *= decay;
+            span = span * decay + dx;
+        }
+        lastX = x;
+        weight += 1.0f;
+        sumY += y;
+    }
+
+    void reset() {
+        weight = sumX = sumY = sumXX = sumXY = span = lastX = 0.0f;
+    }
+
+    // Effective number of points still in the fit.
+    float count() const { return weight; }
+
+    // Weighted x distance the fit covers; a short span gives a noisy slope.
+    float coveredSpan() const { return span; }
+
+    bool hasSlope() const { return weight >= 2.0f && denominator() > 0.0f; }
+
+    // dy/dx of the fitted line; 0 until hasSlope().
+    float slope() const {
+        float d = denominator();
+        return weight >= 2.0f && d > 0.0f ? (weight * sumXY - sumX * sumY) / d
+                                          : 0.0f;
+    }
+
+    // Fitted y at the newest x.
+    float value() const {
+        if (weight <= 0.0f) {
+            return 0.0f;
+        }
+        return (sumY - slope() * sumX) / weight;
+    }
+
+  private:
+    float denominator() const { return weight * sumXX - sumX * sumX; }
+
+    float tau;
+    float weight = 0.0f;
+    float sumX = 0.0f;  // x relative to lastX, so never positive
+    float sumY = 0.0f;
+    float sumXX = 0.0f;
+    float sumXY = 0.0f;
+    float span = 0.0f;
+    float lastX = 0.0f;
+};
+
+#endif  // SOFTWARE_RUNNINGREGRESSION_H
@@ -0,0 +1,66 @@
+#ifndef SOFTWARE_SEQLOCK_H
+#define SOFTWARE_SEQLOCK_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Publishes a small trivially copyable value from one writer to any
+ * number of readers without locks.
+ *
+ * The writer bumps the sequence to odd, writes, and bumps it back to even.
+ * Readers retry if they saw an odd sequence or it changed under them, so the
+ * writer (e.g. an ISR) never waits. Keep T small; readers copy it whole.
+ * The writer side is forced inline so it can be used from IRAM_ATTR code.
+ */
+template <typename T>
+class Seqlock {
+  public:
+    // Writer side. Only one writer at a time.
+    inline __attribute__((always_inline)) void write(const T &value) {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        copy(value, data);
+        std::atomic_thread_fence(std::memory_order_release);
+        sequence.store(seq + 2, std::memory_order_relaxed);
+    }
+
+    // Reader side. Safe from any task.
+    T read() const {
+        T value;
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            copy(data, value);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+        return value;
+    }
+
+  private:
+    static void copy(const volatile T &from, T &to) {
+        const volatile uint8_t *src =
+            reinterpret_cast<const volatile uint8_t *>(&from);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(&to);
+        for (size_t i = 0; i < sizeof(T); i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    static inline __attribute__((always_inline)) void copy(const T &from,
+                                                          volatile T &to) {
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(&from);
+        volatile uint8_t *dst = reinterpret_cast<volatile uint8_t *>(&to);
+        for (size_t i = 0; i < sizeof(T); i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    volatile T data{};
+    std::atomic<uint32_t> sequence{0};
+};
+
+#endif  // SOFTWARE_SEQLOCK_H
@@ -0,0 +1,66 @@
+#ifndef SOFTWARE_SPSCQUEUE_H
+#define SOFTWARE_SPSCQUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+
+/**
+ * @brief Fixed-capacity, lock-free queue for exactly one producer and one
+ * consumer.
+ *
+ * The producer only writes `head` and the consumer only writes `tail`, so
+ * neither side ever blocks or disables interrupts. Useful for handing data out
+ * of callbacks that run on another task (e.g. the NimBLE host) or from an ISR.
+ *
+ * Capacity must be a power of two; one slot is always left empty. push() is
+ * forced inline so that, called from an IRAM_ATTR interrupt handler, it ends
+ * up in IRAM with its caller.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+  public:
+    // Producer side. Returns false, dropping the item, if the queue is full.
+    inline __attribute__((always_inline)) bool push(const T &item) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        size_t next = (head + 1) & (Capacity - 1);
+        if (next == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        items[head] = item;
+        this->head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool pop(T &item) {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[tail];
+        this->tail.store((tail + 1) & (Capacity - 1),
+                         std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Discards everything currently queued.
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire),
+                   std::memory_order_release);
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) ==
+               head.load(std::memory_order_acquire);
+    }
+
+  private:
+    T items[Capacity];
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+};
+
+#endif  // SOFTWARE_SPSCQUEUE_H
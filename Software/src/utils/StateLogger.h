@@ -5,58 +5,126 @@
 
 #include <boost/sml.hpp>
 #include <cassert>
+#include <string_view>
 
 #include "esp_log.h"
-#include "services/lastInteraction.h"
+#include "services/hotlog.h"
+#include "utils/TypeName.h"
 
 namespace sml = boost::sml;
 using namespace sml;
 
 #define STATE_MACHINE_TAG "STATE_MACHINE"
 
+// What a transition record describes.
+enum class TransitionKind : uint8_t {
+    Event,
+    Guard,
+    StateChange,
+};
+
+struct TransitionRecord {
+    uint32_t timestampMs;
+    // Event or guard type id, or the destination state's id.
+    uint32_t id;
+    // Event, guard or destination state name, in flash.
+    const char *name;
+    // Source state name for state changes, otherwise nullptr.
+    const char *source;
+    TransitionKind kind;
+    // Guard result; always true for the other kinds.
+    bool passed;
+};
+
+// Name and id for an SML type. States come through as aux::string, whose
+// characters are the name given with _s.
+template <class T>
+struct SmlName {
+    static constexpr std::string_view name = TypeInfo<T>::name;
+    static constexpr uint32_t id = TypeInfo<T>::id;
+};
+template <char... Chrs>
+struct SmlName<sml::aux::string<char, Chrs...>> {
+  private:
+    static constexpr char chars[] = {Chrs..., '\0'};
+
+  public:
+    static constexpr std::string_view name{chars, sizeof...(Chrs)};
+    static constexpr uint32_t id = type_name::fnv1a(name);
+};
+template <class T>
+struct SmlName<sml::aux::string<T>> : SmlName<T> {};
+
 /**
  * @brief Logs state machine events for the OSSM class.
  *
- * The StateLogger class is responsible for logging the events of the state
- * machine used in the OSSM class. The logging level can be adjusted according
- * to the project's needs. By default, only messages with a level of "LOG_DEBUG"
- * or above are shown. This can be modified in the platformio.ini file or by
- * adding one of the following build flags:
+ * Event, guard and state names are resolved at compile time, so logging
+ * allocates nothing. Events, guard results and state changes also go into a
+ * fixed ring in RTC memory that survives a crash reset; begin() prints it
+ * on the next boot. SML calls every hook under the state machine lock, which
+ * also serialises the ring.
+ *
+ * The logging level can be adjusted according to the project's needs. By
+ * default, only messages with a level of "LOG_DEBUG" or above are shown.
+ * This can be modified in the platformio.ini file (HOTLOG_LEVEL_STATE_MACHINE).
  */
 struct StateLogger {
+    // Prints the ring left by a crash, if the last reset was one, then
+    // starts a new ring.
+    void begin();
+
+    // Prints the ring, oldest first.
+    void dumpTransitions();
+
     template <class SM, class TEvent>
     [[gnu::used]] void log_process_event(const TEvent &) {
-        ESP_LOGV(STATE_MACHINE_TAG, "%s", sml::aux::get_type_name<SM>());
-        String eventName = String(sml::aux::get_type_name<TEvent>());
-        // if the event name starts with " boost::ext::sml" then only TRACE it
-        // to reduce verbosity
-        if (eventName.startsWith("boost::ext::sml")) {
-            ESP_LOGV(STATE_MACHINE_TAG, "%s", eventName.c_str());
-        } else {
-            ESP_LOGD(STATE_MACHINE_TAG, "%s", eventName.c_str());
+        using Event = SmlName<TEvent>;
+        HOT_LOGV(STATE_MACHINE, "%s", HotLogStatic{SmlName<SM>::name.data()});
+        // SML's own events (entry, exit, ...) are only traced, and not
+        // recorded, to reduce verbosity
+        constexpr bool internal = Event::name.substr(0, 15) == "boost::ext::sml";
+        if (internal) {
+            HOT_LOGV(STATE_MACHINE, "%s", HotLogStatic{Event::name.data()});
+            return;
         }
+        HOT_LOGD(STATE_MACHINE, "%s", HotLogStatic{Event::name.data()});
+        record(TransitionKind::Event, Event::id, Event::name.data(), nullptr,
+               true);
     }
 
     template <class SM, class TGuard, class TEvent>
     [[gnu::used]] void log_guard(const TGuard &, const TEvent &, bool result) {
-        String resultString = result ? "[PASS]" : "[DO NOT PASS]";
-        ESP_LOGV(STATE_MACHINE_TAG, "%s: %s", resultString,
-                 sml::aux::get_type_name<SM>());
-        ESP_LOGD(STATE_MACHINE_TAG, "%s: %s, %s", resultString,
-                 sml::aux::get_type_name<TGuard>(),
-                 sml::aux::get_type_name<TEvent>());
+        using Guard = SmlName<TGuard>;
+        HotLogStatic resultString{result ? "[PASS]" : "[DO NOT PASS]"};
+        HOT_LOGV(STATE_MACHINE, "%s: %s", resultString,
+                 HotLogStatic{SmlName<SM>::name.data()});
+        HOT_LOGD(STATE_MACHINE, "%s: %s, %s", resultString,
+                 HotLogStatic{Guard::name.data()},
+                 HotLogStatic{SmlName<TEvent>::name.data()});
+        record(TransitionKind::Guard, Guard::id, Guard::name.data(), nullptr,
+               result);
     }
 
     template <class SM, class TAction, class TEvent>
     [[gnu::used]] void log_action(const TAction &, const TEvent &) {
-        ESP_LOGV(STATE_MACHINE_TAG, "%s", sml::aux::get_type_name<SM>());
+        HOT_LOGV(STATE_MACHINE, "%s", HotLogStatic{SmlName<SM>::name.data()});
     }
 
     template <class SM, class TSrcState, class TDstState>
-    [[gnu::used]] void log_state_change(const TSrcState &src,
-                                        const TDstState &dst) {
-        ESP_LOGD(STATE_MACHINE_TAG, "%s: %s -> %s",
-                 sml::aux::get_type_name<SM>(), src.c_str(), dst.c_str());
+    [[gnu::used]] void log_state_change(const TSrcState &,
+                                        const TDstState &) {
+        using Src = SmlName<TSrcState>;
+        using Dst = SmlName<TDstState>;
+        HOT_LOGD(STATE_MACHINE, "%s: %s -> %s",
+                 HotLogStatic{SmlName<SM>::name.data()},
+                 HotLogStatic{Src::name.data()},
+                 HotLogStatic{Dst::name.data()});
+        record(TransitionKind::StateChange, Dst::id, Dst::name.data(),
+               Src::name.data(), true);
     }
+
+  private:
+    void record(TransitionKind kind, uint32_t id, const char *name,
+                const char *source, bool passed);
 };
 #endif  // LOCKBOX_STATELOGGER_H
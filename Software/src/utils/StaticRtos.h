@@ -0,0 +1,87 @@
+#ifndef SOFTWARE_STATICRTOS_H
+#define SOFTWARE_STATICRTOS_H
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <stddef.h>
+
+#include "services/stackAudit.h"
+
+/**
+ * FreeRTOS objects whose memory is reserved at link time rather than taken
+ * from the heap, so long-lived tasks, queues and locks never fragment it and
+ * the space they need shows up in the build's memory report.
+ *
+ * Declare them at namespace scope (or as members of something that is) and
+ * call create()/start() once. On the ESP32, stack sizes are in bytes.
+ */
+
+template <size_t StackBytes>
+class StaticTask {
+  public:
+    // Starts the task. A task never ends; one that only has work now and
+    // then should wait for it rather than delete itself, as its memory
+    // can't be handed to a new task until FreeRTOS has cleaned it up.
+    TaskHandle_t start(TaskFunction_t function, const char *name, void *arg,
+                       UBaseType_t priority, BaseType_t core) {
+        handle_ = xTaskCreateStaticPinnedToCore(function, name, StackBytes,
+                                                arg, priority, stack_, &tcb_,
+                                                core);
+        auditStack(handle_, name, StackBytes);
+        return handle_;
+    }
+
+    TaskHandle_t handle() const { return handle_; }
+
+  private:
+    StackType_t stack_[StackBytes];
+    StaticTask_t tcb_;
+    TaskHandle_t handle_ = NULL;
+};
+
+template <class T, size_t Length>
+class StaticQueue {
+  public:
+    QueueHandle_t create() {
+        return xQueueCreateStatic(Length, sizeof(T), storage_, &queue_);
+    }
+
+  private:
+    uint8_t storage_[Length * sizeof(T)];
+    StaticQueue_t queue_;
+};
+
+class StaticMutex {
+  public:
+    SemaphoreHandle_t create() { return xSemaphoreCreateMutexStatic(&buffer_); }
+    SemaphoreHandle_t createRecursive() {
+        return xSemaphoreCreateRecursiveMutexStatic(&buffer_);
+    }
+
+  private:
+    StaticSemaphore_t buffer_;
+};
+
+// A binary semaphore, created empty: one task signals, another waits.
+class StaticSemaphore {
+  public:
+    SemaphoreHandle_t create() {
+        return xSemaphoreCreateBinaryStatic(&buffer_);
+    }
+
+  private:
+    StaticSemaphore_t buffer_;
+};
+
+class StaticEventGroup {
+  public:
+    EventGroupHandle_t create() { return xEventGroupCreateStatic(&buffer_); }
+
+  private:
+    StaticEventGroup_t buffer_;
+};
+
+#endif  // SOFTWARE_STATICRTOS_H
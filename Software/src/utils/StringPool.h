@@ -0,0 +1,98 @@
+#ifndef SOFTWARE_STRINGPOOL_H
+#define SOFTWARE_STRINGPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Interned strings for menus built at runtime.
+ *
+ * intern() copies a string once, null terminated, and returns its ID; the
+ * same text interned again gets the same ID. Strings are packed into chunks
+ * of CHUNK_BYTES that never move, so get() pointers stay valid until
+ * clear(). Lookups compare against every string, which is fine for the
+ * few dozen a device menu holds.
+ */
+template <class Allocator = std::allocator<char>>
+class StringPool {
+  public:
+    using Id = uint16_t;
+    static constexpr Id NONE = UINT16_MAX;
+    static constexpr size_t CHUNK_BYTES = 512;
+
+    StringPool() = default;
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+    ~StringPool() { clear(); }
+
+    Id intern(std::string_view text) {
+        for (size_t id = 0; id < strings.size(); id++) {
+            if (text == strings[id]) {
+                return static_cast<Id>(id);
+            }
+        }
+        if (strings.size() >= NONE) {
+            return NONE;
+        }
+
+        size_t bytes = text.size() + 1;
+        if (chunks.empty() || chunkUsed + bytes > CHUNK_BYTES) {
+            // Long strings get a chunk of their own.
+            size_t chunkBytes = std::max(bytes, CHUNK_BYTES);
+            chunks.push_back(Chunk{allocator.allocate(chunkBytes), chunkBytes});
+            chunkUsed = 0;
+        }
+        char *copy = chunks.back().data + chunkUsed;
+        memcpy(copy, text.data(), text.size());
+        copy[text.size()] = '\0';
+        chunkUsed += bytes;
+        textBytes += bytes;
+
+        strings.push_back(copy);
+        return static_cast<Id>(strings.size() - 1);
+    }
+
+    // Null for NONE.
+    const char *get(Id id) const {
+        return id < strings.size() ? strings[id] : nullptr;
+    }
+
+    void clear() {
+        for (const Chunk &chunk : chunks) {
+            allocator.deallocate(chunk.data, chunk.bytes);
+        }
+        chunks.clear();
+        strings.clear();
+        chunkUsed = 0;
+        textBytes = 0;
+    }
+
+    size_t size() const { return strings.size(); }
+
+    // Bytes of text held, terminators included.
+    size_t bytes() const { return textBytes; }
+
+  private:
+    struct Chunk {
+        char *data;
+        size_t bytes;
+    };
+
+    template <class T>
+    using Rebound =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+    Allocator allocator;
+    std::vector<Chunk, Rebound<Chunk>> chunks;
+    std::vector<const char *, Rebound<const char *>> strings;
+    size_t chunkUsed = 0;
+    size_t textBytes = 0;
+};
+
+#endif  // SOFTWARE_STRINGPOOL_H
@@ -0,0 +1,64 @@
+#ifndef SOFTWARE_TYPENAME_H
+#define SOFTWARE_TYPENAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+/**
+ * @brief Compile-time type names and IDs.
+ *
+ * TypeInfo<T>::name is the compiler's spelling of T, null terminated, and
+ * TypeInfo<T>::id an FNV-1a hash of it. Both are constant expressions: the
+ * name is cut out of __PRETTY_FUNCTION__ and copied into a constexpr array,
+ * so it lives in flash and nothing is built at runtime.
+ */
+namespace type_name {
+
+constexpr uint32_t fnv1a(std::string_view text) {
+    uint32_t hash = 2166136261u;
+    for (char c : text) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+template <class T>
+constexpr std::string_view pretty() {
+    return __PRETTY_FUNCTION__;
+}
+
+// GCC: "... pretty() [with T = foo; std::string_view = ...]"
+// Clang: "... pretty() [T = foo]"
+template <class T>
+constexpr std::string_view extract() {
+    constexpr std::string_view text = pretty<T>();
+    constexpr size_t start = text.find("T = ") + 4;
+    constexpr size_t end = text.find_first_of(";]", start);
+    return text.substr(start, end - start);
+}
+
+template <size_t... I>
+constexpr std::array<char, sizeof...(I) + 1> terminate(
+    std::string_view text, std::index_sequence<I...>) {
+    return {text[I]..., '\0'};
+}
+
+}  // namespace type_name
+
+template <class T>
+struct TypeInfo {
+  private:
+    static constexpr std::string_view raw = type_name::extract<T>();
+    static constexpr auto storage =
+        type_name::terminate(raw, std::make_index_sequence<raw.size()>{});
+
+  public:
+    static constexpr std::string_view name{storage.data(), raw.size()};
+    static constexpr uint32_t id = type_name::fnv1a(name);
+};
+
+#endif  // SOFTWARE_TYPENAME_H
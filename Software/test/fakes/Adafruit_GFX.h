@@ -0,0 +1,83 @@
+#ifndef TEST_FAKES_ADAFRUIT_GFX_H
+#define TEST_FAKES_ADAFRUIT_GFX_H
+
+// The virtual drawing primitives of Adafruit_GFX, with the library's
+// signatures, so wrappers like ClippedGFX build against them. Shapes are
+// drawn through the primitives the same way the library does; text is not.
+#include <Arduino.h>
+
+struct GFXfont;
+
+class Adafruit_GFX {
+  public:
+    Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    virtual void startWrite(void) {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color) {
+        drawPixel(x, y, color);
+    }
+    virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                               uint16_t color) {
+        fillRect(x, y, w, h, color);
+    }
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                uint16_t color) {
+        drawFastVLine(x, y, h, color);
+    }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                uint16_t color) {
+        drawFastHLine(x, y, w, color);
+    }
+    virtual void endWrite(void) {}
+
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h,
+                               uint16_t color) {
+        startWrite();
+        for (int16_t i = 0; i < h; i++) {
+            writePixel(x, y + i, color);
+        }
+        endWrite();
+    }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w,
+                               uint16_t color) {
+        startWrite();
+        for (int16_t i = 0; i < w; i++) {
+            writePixel(x + i, y, color);
+        }
+        endWrite();
+    }
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                          uint16_t color) {
+        startWrite();
+        for (int16_t i = x; i < x + w; i++) {
+            writeFastVLine(i, y, h, color);
+        }
+        endWrite();
+    }
+    virtual void fillScreen(uint16_t color) {
+        fillRect(0, 0, _width, _height, color);
+    }
+
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[],
+                       int16_t w, int16_t h) {
+        startWrite();
+        for (int16_t j = 0; j < h; j++) {
+            for (int16_t i = 0; i < w; i++) {
+                writePixel(x + i, y + j, bitmap[j * w + i]);
+            }
+        }
+        endWrite();
+    }
+
+    int16_t width(void) const { return _width; }
+    int16_t height(void) const { return _height; }
+
+  protected:
+    int16_t _width;
+    int16_t _height;
+};
+
+#endif  // TEST_FAKES_ADAFRUIT_GFX_H
@@ -0,0 +1,14 @@
+#ifndef TEST_FAKES_ADAFRUIT_ST7789_H
+#define TEST_FAKES_ADAFRUIT_ST7789_H
+
+// Only the type, for headers that declare the global tft. Tests draw into
+// their own Adafruit_GFX.
+#include <Adafruit_ST77xx.h>
+
+class Adafruit_ST7789 : public Adafruit_GFX {
+  public:
+    Adafruit_ST7789() : Adafruit_GFX(320, 240) {}
+    void drawPixel(int16_t, int16_t, uint16_t) override {}
+};
+
+#endif  // TEST_FAKES_ADAFRUIT_ST7789_H
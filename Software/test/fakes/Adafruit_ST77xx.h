@@ -0,0 +1,16 @@
+#ifndef TEST_FAKES_ADAFRUIT_ST77XX_H
+#define TEST_FAKES_ADAFRUIT_ST77XX_H
+
+#include <Adafruit_GFX.h>
+
+#define ST77XX_BLACK 0x0000
+#define ST77XX_WHITE 0xFFFF
+#define ST77XX_RED 0xF800
+#define ST77XX_GREEN 0x07E0
+#define ST77XX_BLUE 0x001F
+#define ST77XX_CYAN 0x07FF
+#define ST77XX_MAGENTA 0xF81F
+#define ST77XX_YELLOW 0xFFE0
+#define ST77XX_ORANGE 0xFC00
+
+#endif  // TEST_FAKES_ADAFRUIT_ST77XX_H
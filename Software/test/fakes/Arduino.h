@@ -0,0 +1,72 @@
+#ifndef TEST_FAKES_ARDUINO_H
+#define TEST_FAKES_ARDUINO_H
+
+// Just enough of the Arduino core for the pure headers and services the
+// native tests build. Time is a counter the test moves by hand.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#include <freertos/FreeRTOS.h>
+
+using std::max;
+using std::min;
+
+#define PROGMEM
+
+// newlib has it, glibc only from 2.38
+inline size_t fakeStrlcpy(char *dst, const char *src, size_t size) {
+    size_t length = strlen(src);
+    if (size > 0) {
+        size_t copied = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, copied);
+        dst[copied] = '\0';
+    }
+    return length;
+}
+#define strlcpy fakeStrlcpy
+
+// Arduino's String, backed by std::string; only what the sources use.
+class String {
+  public:
+    String(const char *text = "") : value(text) {}
+    const char *c_str() const { return value.c_str(); }
+    size_t length() const { return value.length(); }
+
+  private:
+    std::string value;
+};
+
+namespace fake_arduino {
+inline uint32_t &nowMs() {
+    static uint32_t now = 0;
+    return now;
+}
+}  // namespace fake_arduino
+
+inline unsigned long millis() { return fake_arduino::nowMs(); }
+
+// A spinlock, like the ESP32's, for tests that run tasks on threads.
+typedef struct {
+    std::atomic<int> locked;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+inline void fakeEnterCritical(portMUX_TYPE *mux) {
+    while (mux->locked.exchange(1, std::memory_order_acquire) != 0) {
+    }
+}
+
+inline void fakeExitCritical(portMUX_TYPE *mux) {
+    mux->locked.store(0, std::memory_order_release);
+}
+
+#define portENTER_CRITICAL(mux) fakeEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) fakeExitCritical(mux)
+
+#endif  // TEST_FAKES_ARDUINO_H
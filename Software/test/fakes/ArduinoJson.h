@@ -0,0 +1,19 @@
+#ifndef TEST_FAKES_ARDUINOJSON_H
+#define TEST_FAKES_ARDUINOJSON_H
+
+#include <stddef.h>
+
+// The allocator interface only; no test parses JSON.
+namespace ArduinoJson {
+class Allocator {
+  public:
+    virtual void *allocate(size_t size) = 0;
+    virtual void deallocate(void *ptr) = 0;
+    virtual void *reallocate(void *ptr, size_t newSize) = 0;
+
+  protected:
+    ~Allocator() = default;
+};
+}  // namespace ArduinoJson
+
+#endif  // TEST_FAKES_ARDUINOJSON_H
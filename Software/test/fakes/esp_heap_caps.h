@@ -0,0 +1,32 @@
+#ifndef TEST_FAKES_ESP_HEAP_CAPS_H
+#define TEST_FAKES_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+// The heap the fake reports, whatever the caps; tests set it by hand.
+namespace fake_heap_caps {
+inline size_t &freeBytes() {
+    static size_t bytes = 200 * 1024;
+    return bytes;
+}
+inline size_t &largestFreeBlock() {
+    static size_t bytes = 200 * 1024;
+    return bytes;
+}
+}  // namespace fake_heap_caps
+
+inline size_t heap_caps_get_free_size(uint32_t) {
+    return fake_heap_caps::freeBytes();
+}
+
+inline size_t heap_caps_get_largest_free_block(uint32_t) {
+    return fake_heap_caps::largestFreeBlock();
+}
+
+#endif  // TEST_FAKES_ESP_HEAP_CAPS_H
@@ -0,0 +1,19 @@
+#ifndef TEST_FAKES_ESP_LOG_H
+#define TEST_FAKES_ESP_LOG_H
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+#define ESP_LOGE(tag, format, ...) ((void)(tag))
+#define ESP_LOGW(tag, format, ...) ((void)(tag))
+#define ESP_LOGI(tag, format, ...) ((void)(tag))
+#define ESP_LOGD(tag, format, ...) ((void)(tag))
+#define ESP_LOGV(tag, format, ...) ((void)(tag))
+
+#endif  // TEST_FAKES_ESP_LOG_H
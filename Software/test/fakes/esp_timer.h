@@ -0,0 +1,16 @@
+#ifndef TEST_FAKES_ESP_TIMER_H
+#define TEST_FAKES_ESP_TIMER_H
+
+#include <stdint.h>
+
+#include <chrono>
+
+// Microseconds since the first call, from the host's steady clock.
+inline int64_t esp_timer_get_time() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+#endif  // TEST_FAKES_ESP_TIMER_H
@@ -0,0 +1,27 @@
+#ifndef TEST_FAKES_FREERTOS_H
+#define TEST_FAKES_FREERTOS_H
+
+// FreeRTOS on top of std::thread, for services whose tasks, queues and locks
+// the native tests run for real. One tick is one millisecond.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdTICKS_TO_MS(ticks) ((uint32_t)(ticks))
+#define configMINIMAL_STACK_SIZE 768
+#define tskIDLE_PRIORITY 0
+#define tskNO_AFFINITY 0x7fffffff
+
+#endif  // TEST_FAKES_FREERTOS_H
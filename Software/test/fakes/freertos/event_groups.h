@@ -0,0 +1,52 @@
+#ifndef TEST_FAKES_FREERTOS_EVENT_GROUPS_H
+#define TEST_FAKES_FREERTOS_EVENT_GROUPS_H
+
+#include "freertos/queue.h"
+
+typedef uint32_t EventBits_t;
+
+struct FakeEventGroup {
+    FakeQueue waiters;
+    EventBits_t bits = 0;
+};
+typedef FakeEventGroup *EventGroupHandle_t;
+typedef struct {
+    FakeEventGroup group;
+} StaticEventGroup_t;
+
+inline EventGroupHandle_t xEventGroupCreateStatic(
+    StaticEventGroup_t *buffer) {
+    buffer->group.bits = 0;
+    return &buffer->group;
+}
+
+inline EventBits_t xEventGroupSetBits(EventGroupHandle_t group,
+                                      EventBits_t bits) {
+    std::lock_guard<std::mutex> guard(group->waiters.lock);
+    group->bits |= bits;
+    group->waiters.changed.notify_all();
+    return group->bits;
+}
+
+inline EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    std::lock_guard<std::mutex> guard(group->waiters.lock);
+    return group->bits;
+}
+
+inline EventBits_t xEventGroupWaitBits(EventGroupHandle_t group,
+                                       EventBits_t bits, BaseType_t clear,
+                                       BaseType_t all, TickType_t ticks) {
+    std::unique_lock<std::mutex> guard(group->waiters.lock);
+    fake_freertos::waitUntil(&group->waiters, guard, ticks, [&] {
+        EventBits_t set = group->bits & bits;
+        return all ? set == bits : set != 0;
+    });
+    EventBits_t result = group->bits;
+    EventBits_t set = result & bits;
+    if (clear && (all ? set == bits : set != 0)) {
+        group->bits &= ~bits;
+    }
+    return result;
+}
+
+#endif  // TEST_FAKES_FREERTOS_EVENT_GROUPS_H
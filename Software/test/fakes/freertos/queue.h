@@ -0,0 +1,109 @@
+#ifndef TEST_FAKES_FREERTOS_QUEUE_H
+#define TEST_FAKES_FREERTOS_QUEUE_H
+
+#include <string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Queues, and the semaphores built on them as in FreeRTOS: a semaphore is
+// a queue of empty items, `count` of them available.
+struct FakeQueue {
+    std::mutex lock;
+    std::condition_variable changed;
+    UBaseType_t length = 0;
+    UBaseType_t itemSize = 0;
+    uint8_t *storage = nullptr;
+    UBaseType_t head = 0;
+    UBaseType_t count = 0;
+    // Mutexes only.
+    TaskHandle_t owner = nullptr;
+    UBaseType_t depth = 0;
+};
+typedef FakeQueue *QueueHandle_t;
+typedef struct {
+    FakeQueue queue;
+} StaticQueue_t;
+
+namespace fake_freertos {
+// Waits under `guard` until `ready()`; false if `ticks` pass first.
+template <class Ready>
+bool waitUntil(FakeQueue *queue, std::unique_lock<std::mutex> &guard,
+               TickType_t ticks, Ready ready) {
+    if (ticks == portMAX_DELAY) {
+        queue->changed.wait(guard, ready);
+        return true;
+    }
+    return queue->changed.wait_for(guard, std::chrono::milliseconds(ticks),
+                                   ready);
+}
+}  // namespace fake_freertos
+
+inline QueueHandle_t xQueueCreateStatic(UBaseType_t length,
+                                        UBaseType_t itemSize,
+                                        uint8_t *storage,
+                                        StaticQueue_t *buffer) {
+    FakeQueue *queue = &buffer->queue;
+    queue->length = length;
+    queue->itemSize = itemSize;
+    queue->storage = storage;
+    queue->head = 0;
+    queue->count = 0;
+    return queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void *item,
+                             TickType_t ticks) {
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!fake_freertos::waitUntil(queue, guard, ticks, [queue] {
+            return queue->count < queue->length;
+        })) {
+        return pdFALSE;
+    }
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->storage + tail * queue->itemSize, item, queue->itemSize);
+    queue->count++;
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueSendToBack(QueueHandle_t queue, const void *item,
+                                   TickType_t ticks) {
+    return xQueueSend(queue, item, ticks);
+}
+
+// For queues of one item, as in FreeRTOS.
+inline BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    memcpy(queue->storage, item, queue->itemSize);
+    queue->head = 0;
+    queue->count = 1;
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void *item,
+                                TickType_t ticks) {
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!fake_freertos::waitUntil(queue, guard, ticks,
+                                  [queue] { return queue->count > 0; })) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->storage + queue->head * queue->itemSize,
+           queue->itemSize);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->count;
+}
+
+#endif  // TEST_FAKES_FREERTOS_QUEUE_H
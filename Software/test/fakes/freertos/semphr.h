@@ -0,0 +1,92 @@
+#ifndef TEST_FAKES_FREERTOS_SEMPHR_H
+#define TEST_FAKES_FREERTOS_SEMPHR_H
+
+#include "freertos/queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+typedef StaticQueue_t StaticSemaphore_t;
+
+namespace fake_freertos {
+inline SemaphoreHandle_t createSemaphore(StaticSemaphore_t *buffer,
+                                         UBaseType_t available) {
+    FakeQueue *queue = &buffer->queue;
+    queue->length = 1;
+    queue->count = available;
+    queue->owner = nullptr;
+    queue->depth = 0;
+    return queue;
+}
+}  // namespace fake_freertos
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(
+    StaticSemaphore_t *buffer) {
+    return fake_freertos::createSemaphore(buffer, 1);
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(
+    StaticSemaphore_t *buffer) {
+    return fake_freertos::createSemaphore(buffer, 1);
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinaryStatic(
+    StaticSemaphore_t *buffer) {
+    return fake_freertos::createSemaphore(buffer, 0);
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore,
+                                 TickType_t ticks) {
+    std::unique_lock<std::mutex> guard(semaphore->lock);
+    if (!fake_freertos::waitUntil(semaphore, guard, ticks, [semaphore] {
+            return semaphore->count > 0;
+        })) {
+        return pdFALSE;
+    }
+    semaphore->count--;
+    semaphore->owner = xTaskGetCurrentTaskHandle();
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    std::lock_guard<std::mutex> guard(semaphore->lock);
+    if (semaphore->count >= semaphore->length) {
+        return pdFALSE;
+    }
+    semaphore->count++;
+    semaphore->owner = nullptr;
+    semaphore->changed.notify_all();
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t semaphore,
+                                          TickType_t ticks) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(semaphore->lock);
+    if (semaphore->owner == self) {
+        semaphore->depth++;
+        return pdTRUE;
+    }
+    if (!fake_freertos::waitUntil(semaphore, guard, ticks, [semaphore] {
+            return semaphore->count > 0;
+        })) {
+        return pdFALSE;
+    }
+    semaphore->count--;
+    semaphore->owner = self;
+    semaphore->depth = 1;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t semaphore) {
+    std::lock_guard<std::mutex> guard(semaphore->lock);
+    if (semaphore->owner != xTaskGetCurrentTaskHandle()) {
+        return pdFALSE;
+    }
+    if (--semaphore->depth == 0) {
+        semaphore->owner = nullptr;
+        semaphore->count++;
+        semaphore->changed.notify_all();
+    }
+    return pdTRUE;
+}
+
+#endif  // TEST_FAKES_FREERTOS_SEMPHR_H
@@ -0,0 +1,60 @@
+#ifndef TEST_FAKES_FREERTOS_TASK_H
+#define TEST_FAKES_FREERTOS_TASK_H
+
+#include <chrono>
+#include <thread>
+
+#include "freertos/FreeRTOS.h"
+
+struct FakeTask {
+    std::thread::id thread;
+};
+typedef FakeTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+typedef struct {
+    FakeTask task;
+} StaticTask_t;
+
+namespace fake_freertos {
+inline std::chrono::steady_clock::time_point start() {
+    static const auto start = std::chrono::steady_clock::now();
+    return start;
+}
+
+// The calling thread's task; threads not started as tasks get their own.
+inline TaskHandle_t &current() {
+    thread_local FakeTask self{std::this_thread::get_id()};
+    thread_local TaskHandle_t task = &self;
+    return task;
+}
+}  // namespace fake_freertos
+
+// Tasks never end, so their threads are detached and live until exit.
+inline TaskHandle_t xTaskCreateStaticPinnedToCore(
+    TaskFunction_t function, const char *, uint32_t, void *arg, UBaseType_t,
+    StackType_t *, StaticTask_t *buffer, BaseType_t) {
+    FakeTask *task = &buffer->task;
+    std::thread thread([function, arg, task] {
+        fake_freertos::current() = task;
+        function(arg);
+    });
+    task->thread = thread.get_id();
+    thread.detach();
+    return task;
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return fake_freertos::current();
+}
+
+inline TickType_t xTaskGetTickCount() {
+    return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - fake_freertos::start())
+        .count();
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+#endif  // TEST_FAKES_FREERTOS_TASK_H
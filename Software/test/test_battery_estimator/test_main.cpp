@@ -0,0 +1,175 @@
+// Replays fuel gauge traces, in the form battery.cpp logs each sample, through
+// BatteryEstimator, DrainAttribution and BatteryHistory.
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include <string>
+
+#include "utils/BatteryEstimator.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Feeds every "sample t=... soc=... v=... crate=..." line of `log` to the
+// estimator, skipping anything else. Returns the number of samples.
+static int replay(const char *log, BatteryEstimator &estimator) {
+    int samples = 0;
+    for (const char *line = log; line != nullptr && *line != '\0';) {
+        const char *sample = strstr(line, "sample t=");
+        const char *end = strchr(line, '\n');
+        if (sample != nullptr && (end == nullptr || sample < end)) {
+            unsigned long timeMs;
+            BatterySample parsed;
+            if (sscanf(sample, "sample t=%lu soc=%f v=%f crate=%f", &timeMs,
+                       &parsed.percent, &parsed.voltage,
+                       &parsed.chipRatePercentPerHour) == 4) {
+                parsed.timeMs = timeMs;
+                estimator.add(parsed);
+                samples++;
+            }
+        }
+        line = end != nullptr ? end + 1 : nullptr;
+    }
+    return samples;
+}
+
+// A trace in the device's log format: a steady `ratePerHour` from
+// `startPercent`, one sample every 10 s, with the gauge's CRATE reading
+// jittering around the true rate and SOC quantised like the gauge's.
+static std::string syntheticTrace(float startPercent, float ratePerHour,
+                                  uint32_t minutes, uint32_t startMs = 0) {
+    std::string log;
+    char line[160];
+    uint32_t seed = 12345;
+    for (uint32_t t = 0; t <= minutes * 60000; t += 10000) {
+        seed = seed * 1103515245u + 12345u;
+        float jitter = ((seed >> 16) % 2001) / 1000.0f - 1.0f;  // +-1
+        float percent = startPercent + ratePerHour * t / 3600000.0f;
+        percent = roundf(percent * 256.0f) / 256.0f;
+        float voltage = 3.4f + percent / 100.0f * 0.8f;
+        snprintf(line, sizeof(line),
+                 "D (%lu) Battery: sample t=%lu soc=%.3f v=%.3f "
+                 "crate=%.2f -> 0.00%%/h tte=-1m\n",
+                 (unsigned long)(startMs + t), (unsigned long)(startMs + t),
+                 percent, voltage, ratePerHour + jitter * 3.0f);
+        log += line;
+    }
+    return log;
+}
+
+static void test_recorded_lines_are_parsed() {
+    const char *log =
+        "I (1200) BOOT: ready\n"
+        "D (10000) Battery: sample t=10000 soc=80.000 v=4.040 crate=-9.10 "
+        "-> -9.10%/h tte=527m\n"
+        "D (20000) Battery: sample t=20000 soc=79.973 v=4.040 crate=-10.40 "
+        "-> -10.40%/h tte=461m\n";
+    BatteryEstimator estimator;
+    TEST_ASSERT_EQUAL_INT(2, replay(log, estimator));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 79.973f, estimator.currentPercent());
+    // Too early for the regression: the gauge's own rate is used.
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -10.40f, estimator.ratePercentPerHour());
+}
+
+static void test_steady_discharge_converges() {
+    BatteryEstimator estimator;
+    replay(syntheticTrace(90.0f, -12.0f, 60).c_str(), estimator);
+    // Half of the estimate is the gauge's last jittery reading.
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, -12.0f, estimator.ratePercentPerHour());
+    TEST_ASSERT_FALSE(estimator.isCharging());
+    // 78 % left at 12 %/h: 390 minutes.
+    TEST_ASSERT_FLOAT_WITHIN(70.0f, 390.0f, estimator.minutesToEmpty());
+}
+
+static void test_charging_has_no_time_to_empty() {
+    BatteryEstimator estimator;
+    replay(syntheticTrace(30.0f, 40.0f, 20).c_str(), estimator);
+    TEST_ASSERT_TRUE(estimator.isCharging());
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, estimator.minutesToEmpty());
+}
+
+static void test_flat_trace_is_capped() {
+    BatteryEstimator estimator;
+    BatterySample sample = {0, 50.0f, 3.8f, -0.3f};
+    for (uint32_t t = 0; t < 3600000; t += 10000) {
+        sample.timeMs = t;
+        estimator.add(sample);
+    }
+    // -0.15 %/h averaged: flat, so no estimate.
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, estimator.minutesToEmpty());
+
+    BatteryEstimator slow;
+    sample.chipRatePercentPerHour = -0.5f;
+    for (uint32_t t = 0; t < 3600000; t += 10000) {
+        sample.timeMs = t;
+        sample.percent = 50.0f - 0.5f * t / 3600000.0f;
+        slow.add(sample);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(BatteryEstimator::MAX_MINUTES_TO_EMPTY,
+                            slow.minutesToEmpty());
+}
+
+static void test_restart_mid_trace_starts_over() {
+    BatteryEstimator estimator;
+    // Charging, then a reboot resets millis() and the remote runs on battery.
+    replay(syntheticTrace(40.0f, 30.0f, 30, 600000).c_str(), estimator);
+    TEST_ASSERT_TRUE(estimator.isCharging());
+    replay(syntheticTrace(55.0f, -15.0f, 30).c_str(), estimator);
+    TEST_ASSERT_FLOAT_WITHIN(2.5f, -15.0f, estimator.ratePercentPerHour());
+}
+
+static void test_drain_is_shared_by_estimated_charge() {
+    DrainAttribution drain;
+    drain.start(80.0f, 0);
+    float milliamps[static_cast<size_t>(PowerConsumer::COUNT)] = {45.0f, 35.0f,
+                                                                  20.0f, 0.0f};
+    for (uint32_t t = 10000; t <= 3600000; t += 10000) {
+        drain.accumulate(milliamps, t);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3600000, drain.sessionMs());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, drain.drainedPercent(70.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 4.5f,
+                             drain.drainedPercent(PowerConsumer::Base, 70.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 3.5f, drain.drainedPercent(
+                                              PowerConsumer::Screen, 70.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f,
+                             drain.drainedPercent(PowerConsumer::Leds, 70.0f));
+    // Charging during the session counts as no drain.
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, drain.drainedPercent(85.0f));
+}
+
+static void test_history_decimates_into_coarser_levels() {
+    static BatteryHistory history;  // zeroed, like RTC memory at power-on
+    for (int i = 0; i < 120; i++) {
+        history.add(100.0f - i * 0.1f, 4.0f);
+    }
+    BatteryHistory::Entry entries[BatteryHistory::CAPACITY];
+    TEST_ASSERT_EQUAL_size_t(48, history.read(0, entries, 48));
+    // The last 48 samples, 92.8 % down to 88.1 %.
+    TEST_ASSERT_INT_WITHIN(1, 9280, entries[0].percentCenti);
+    TEST_ASSERT_INT_WITHIN(1, 8810, entries[47].percentCenti);
+
+    // 120 samples in sixes: 20 averages, the first of samples 0-5.
+    TEST_ASSERT_EQUAL_size_t(20, history.read(1, entries, 48));
+    TEST_ASSERT_INT_WITHIN(1, 9975, entries[0].percentCenti);
+    TEST_ASSERT_EQUAL_UINT16(4000, entries[0].millivolts);
+
+    // And those in tens: 2 entries.
+    TEST_ASSERT_EQUAL_size_t(2, history.read(2, entries, 48));
+    TEST_ASSERT_EQUAL_size_t(0, history.read(3, entries, 48));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_recorded_lines_are_parsed);
+    RUN_TEST(test_steady_discharge_converges);
+    RUN_TEST(test_charging_has_no_time_to_empty);
+    RUN_TEST(test_flat_trace_is_capped);
+    RUN_TEST(test_restart_mid_trace_starts_over);
+    RUN_TEST(test_drain_is_shared_by_estimated_charge);
+    RUN_TEST(test_history_decimates_into_coarser_levels);
+    return UNITY_END();
+}
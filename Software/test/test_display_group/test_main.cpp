@@ -0,0 +1,395 @@
+// Renders DisplayGroup frames into a character framebuffer and compares them
+// with golden images. Each widget paints its whole box with its letter
+// through gfx(), the way real widgets clear their box before drawing, so a
+// missed repaint of an overlapped sibling shows up as the wrong letter and
+// a paint outside the damage as a stray one.
+
+#include <stdlib.h>
+#include <unity.h>
+
+#include <string>
+
+#include "components/DisplayGroup.h"
+#include "components/DynamicText.h"
+
+static const int WIDTH = 12;
+static const int HEIGHT = 5;
+static char framebuffer[HEIGHT][WIDTH];
+
+// Colour 0 (Colors::black) shows as '.', anything else as its low byte.
+class CharGFX : public Adafruit_GFX {
+  public:
+    CharGFX() : Adafruit_GFX(WIDTH, HEIGHT) {}
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT) {
+            framebuffer[y][x] = color == 0 ? '.' : static_cast<char>(color);
+        }
+    }
+};
+
+static CharGFX screen;
+static StaticSemaphore_t displayMutexBuffer;
+SemaphoreHandle_t displayMutex =
+    xSemaphoreCreateMutexStatic(&displayMutexBuffer);
+
+Adafruit_GFX &screenGFX() { return screen; }
+
+// The arena is not under test here.
+void *sessionAlloc(size_t size) { return malloc(size); }
+void sessionFree(void *ptr) { free(ptr); }
+
+void submitHotLog(const HotLogRecord &) {}
+
+// One pixel per character on the baseline row, drawn as the character.
+TextMetrics measureText(TextFont, const char *text) {
+    TextMetrics metrics;
+    metrics.width = strlen(text);
+    metrics.height = 1;
+    return metrics;
+}
+
+void drawText(TextFont, const char *text, int16_t x, int16_t y, uint16_t,
+              uint16_t, Adafruit_GFX &target) {
+    for (int16_t i = 0; text[i] != '\0'; i++) {
+        target.drawPixel(x + i, y, text[i]);
+    }
+}
+
+static void clearFramebuffer() { memset(framebuffer, '.', sizeof(framebuffer)); }
+
+static std::string frame() {
+    std::string out;
+    for (int row = 0; row < HEIGHT; row++) {
+        out.append(framebuffer[row], WIDTH);
+        out.push_back('\n');
+    }
+    return out;
+}
+
+class Box : public DisplayObject {
+  public:
+    char letter;
+    bool changed = false;
+    int draws = 0;
+
+    Box(char letter, int16_t x, int16_t y, int16_t width, int16_t height,
+        int16_t z = 0)
+        : DisplayObject(x, y, width, height), letter(letter) {
+        zIndex = z;
+    }
+
+    bool shouldDraw() override { return isFirstDraw || changed; }
+
+    void draw() override {
+        gfx().fillRect(x, y, width, height, letter);
+        changed = false;
+        draws++;
+    }
+
+    void moveTo(int16_t newX, int16_t newY) {
+        x = newX;
+        y = newY;
+        changed = true;
+    }
+};
+
+void setUp() { clearFramebuffer(); }
+void tearDown() {}
+
+static void assertFrame(const char *golden) {
+    TEST_ASSERT_EQUAL_STRING(golden, frame().c_str());
+}
+
+void test_first_frame_paints_in_insertion_order() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    group.add<Box>('A', 0, 0, 6, 3);
+    group.add<Box>('B', 3, 1, 6, 3);
+    group.add<Box>('C', 10, 3, 2, 2);
+    group.tick();
+
+    assertFrame(
+        "AAAAAA......\n"
+        "AAABBBBBB...\n"
+        "AAABBBBBB...\n"
+        "...BBBBBB.CC\n"
+        "..........CC\n");
+}
+
+void test_higher_z_index_paints_on_top() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    group.add<Box>('A', 0, 0, 6, 3, 1);
+    group.add<Box>('B', 3, 1, 6, 3);
+    group.tick();
+
+    assertFrame(
+        "AAAAAA......\n"
+        "AAAAAABBB...\n"
+        "AAAAAABBB...\n"
+        "...BBBBBB...\n"
+        "............\n");
+}
+
+void test_restack_repaints_in_the_new_order() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    Box *a = group.add<Box>('A', 0, 0, 6, 3);
+    group.add<Box>('B', 3, 1, 6, 3);
+    group.tick();
+
+    a->zIndex = 1;
+    group.restack();
+    group.tick();
+
+    assertFrame(
+        "AAAAAA......\n"
+        "AAAAAABBB...\n"
+        "AAAAAABBB...\n"
+        "...BBBBBB...\n"
+        "............\n");
+}
+
+void test_redraw_repaints_overlapping_siblings_only() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    Box *a = group.add<Box>('A', 0, 0, 6, 3);
+    Box *b = group.add<Box>('B', 3, 1, 6, 3);
+    Box *c = group.add<Box>('C', 10, 3, 2, 2);
+    group.tick();
+
+    a->letter = 'a';
+    a->changed = true;
+    group.tick();
+
+    // B stays on top of the redrawn A; C, which A does not touch, is left.
+    assertFrame(
+        "aaaaaa......\n"
+        "aaaBBBBBB...\n"
+        "aaaBBBBBB...\n"
+        "...BBBBBB.CC\n"
+        "..........CC\n");
+    TEST_ASSERT_EQUAL(2, a->draws);
+    TEST_ASSERT_EQUAL(2, b->draws);
+    TEST_ASSERT_EQUAL(1, c->draws);
+}
+
+void test_repaint_is_clipped_to_the_damage() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    Box *a = group.add<Box>('A', 0, 0, 4, 2);
+    Box *b = group.add<Box>('B', 2, 1, 4, 2);
+    Box *c = group.add<Box>('C', 5, 2, 4, 2);
+    group.tick();
+
+    // B is repainted because A's redraw covers part of it, but only inside
+    // A's box, so its repaint does not reach C.
+    clearFramebuffer();
+    a->changed = true;
+    group.tick();
+
+    assertFrame(
+        "AAAA........\n"
+        "AABB........\n"
+        "............\n"
+        "............\n"
+        "............\n");
+    TEST_ASSERT_EQUAL(2, b->draws);
+    TEST_ASSERT_EQUAL(1, c->draws);
+}
+
+void test_unchanged_frame_draws_nothing() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    Box *a = group.add<Box>('A', 0, 0, 6, 3);
+    Box *b = group.add<Box>('B', 3, 1, 6, 3);
+    group.tick();
+    clearFramebuffer();
+    group.tick();
+
+    assertFrame(
+        "............\n"
+        "............\n"
+        "............\n"
+        "............\n"
+        "............\n");
+    TEST_ASSERT_EQUAL(1, a->draws);
+    TEST_ASSERT_EQUAL(1, b->draws);
+}
+
+void test_children_outside_the_clip_are_skipped() {
+    DisplayGroup group(0, 0, 6, HEIGHT);
+    Box *inside = group.add<Box>('A', 0, 0, 2, 2);
+    Box *outside = group.add<Box>('B', 8, 0, 2, 2);
+    group.tick();
+
+    assertFrame(
+        "AA..........\n"
+        "AA..........\n"
+        "............\n"
+        "............\n"
+        "............\n");
+    TEST_ASSERT_EQUAL(1, inside->draws);
+    TEST_ASSERT_EQUAL(0, outside->draws);
+}
+
+void test_nested_group_clips_its_children() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    group.add<Box>('A', 0, 0, WIDTH, 2);
+    DisplayGroup *inner = group.add<DisplayGroup>(2, 1, 4, 3);
+    inner->zIndex = 1;
+    group.restack();
+    Box *wide = inner->add<Box>('N', 0, 0, WIDTH, HEIGHT);
+    group.tick();
+
+    assertFrame(
+        "AAAAAAAAAAAA\n"
+        "AANNNNAAAAAA\n"
+        "..NNNN......\n"
+        "..NNNN......\n"
+        "............\n");
+
+    // A change inside the nested group repaints through both clips.
+    clearFramebuffer();
+    wide->letter = 'n';
+    wide->changed = true;
+    group.tick();
+
+    assertFrame(
+        "............\n"
+        "..nnnn......\n"
+        "..nnnn......\n"
+        "..nnnn......\n"
+        "............\n");
+}
+
+void test_hiding_a_child_uncovers_what_was_beneath() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    Box *a = group.add<Box>('A', 0, 0, 6, 3);
+    Box *b = group.add<Box>('B', 3, 1, 6, 3);
+    group.tick();
+
+    b->setVisible(false);
+    group.tick();
+
+    assertFrame(
+        "AAAAAA......\n"
+        "AAAAAA......\n"
+        "AAAAAA......\n"
+        "............\n"
+        "............\n");
+    TEST_ASSERT_EQUAL(2, a->draws);
+
+    b->setVisible(true);
+    group.tick();
+
+    assertFrame(
+        "AAAAAA......\n"
+        "AAABBBBBB...\n"
+        "AAABBBBBB...\n"
+        "...BBBBBB...\n"
+        "............\n");
+}
+
+void test_moving_a_child_uncovers_what_was_beneath() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    group.add<Box>('A', 0, 0, 6, 3);
+    Box *b = group.add<Box>('B', 3, 1, 3, 2);
+    group.tick();
+
+    b->moveTo(8, 2);
+    group.tick();
+
+    assertFrame(
+        "AAAAAA......\n"
+        "AAAAAA......\n"
+        "AAAAAA..BBB.\n"
+        "........BBB.\n"
+        "............\n");
+}
+
+void test_erase_clears_only_what_the_children_painted() {
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    Box *a = group.add<Box>('A', 0, 0, 2, 2);
+    group.add<Box>('B', 6, 2, 2, 2);
+    group.tick();
+    // Something else on the screen, outside the children
+    framebuffer[4][11] = 'X';
+
+    group.erase();
+
+    assertFrame(
+        "............\n"
+        "............\n"
+        "............\n"
+        "............\n"
+        "...........X\n");
+
+    group.tick();
+    TEST_ASSERT_EQUAL(2, a->draws);
+}
+
+void test_growing_text_repaints_the_neighbour_above_it() {
+    std::string label = "ab";
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    group.add<DynamicText>(label, 0, 1);
+    Box *cover = group.add<Box>('B', 3, 0, 3, 3, 1);
+    group.tick();
+
+    assertFrame(
+        "...BBB......\n"
+        "ab.BBB......\n"
+        "...BBB......\n"
+        "............\n"
+        "............\n");
+
+    label = "abcdefg";
+    group.tick();
+
+    // The new text reaches under B, so B is repainted on top of it.
+    assertFrame(
+        "...BBB......\n"
+        "abcBBBg.....\n"
+        "...BBB......\n"
+        "............\n"
+        "............\n");
+    TEST_ASSERT_EQUAL(2, cover->draws);
+}
+
+void test_shrinking_text_uncovers_the_neighbour_beneath_it() {
+    std::string label = "abcdefg";
+    DisplayGroup group(0, 0, WIDTH, HEIGHT);
+    group.add<Box>('B', 3, 0, 3, 3);
+    group.add<DynamicText>(label, 0, 1);
+    group.tick();
+
+    assertFrame(
+        "...BBB......\n"
+        "abcdefg.....\n"
+        "...BBB......\n"
+        "............\n"
+        "............\n");
+
+    label = "ab";
+    group.tick();
+
+    assertFrame(
+        "...BBB......\n"
+        "ab.BBB......\n"
+        "...BBB......\n"
+        "............\n"
+        "............\n");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_frame_paints_in_insertion_order);
+    RUN_TEST(test_higher_z_index_paints_on_top);
+    RUN_TEST(test_restack_repaints_in_the_new_order);
+    RUN_TEST(test_redraw_repaints_overlapping_siblings_only);
+    RUN_TEST(test_repaint_is_clipped_to_the_damage);
+    RUN_TEST(test_unchanged_frame_draws_nothing);
+    RUN_TEST(test_children_outside_the_clip_are_skipped);
+    RUN_TEST(test_nested_group_clips_its_children);
+    RUN_TEST(test_hiding_a_child_uncovers_what_was_beneath);
+    RUN_TEST(test_moving_a_child_uncovers_what_was_beneath);
+    RUN_TEST(test_erase_clears_only_what_the_children_painted);
+    RUN_TEST(test_growing_text_repaints_the_neighbour_above_it);
+    RUN_TEST(test_shrinking_text_uncovers_the_neighbour_beneath_it);
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+// Replays recorded pin sequences through the encoder maths the way
+// RotaryEncoder::onEdge() and readEncoder() use it, and checks the detents,
+// speed and accelerated steps that come out.
+
+#include <unity.h>
+
+#include "utils/EncoderMath.h"
+
+using namespace EncoderMath;
+
+// The ISR half of RotaryEncoder, minus the pins and the snapshot.
+struct ReplayEncoder {
+    uint8_t pinState = 0;
+    int8_t quarterSteps = 0;
+    int32_t detents = 0;
+    VelocityFilter velocity;
+
+    void edge(uint8_t state, uint32_t nowUs) {
+        int8_t step = quadratureStep(pinState, state);
+        pinState = state;
+        if (step == 0) {
+            return;
+        }
+        quarterSteps += step;
+        if (quarterSteps > -STEPS_PER_DETENT &&
+            quarterSteps < STEPS_PER_DETENT) {
+            return;
+        }
+        int8_t direction = quarterSteps > 0 ? 1 : -1;
+        quarterSteps = 0;
+        detents += direction;
+        velocity.addDetent(nowUs, direction);
+    }
+
+    // Pin states as (B << 1) | A digits, one edge every `stepUs`.
+    uint32_t replay(const char *states, uint32_t startUs, uint32_t stepUs) {
+        uint32_t now = startUs;
+        for (const char *c = states; *c != '\0'; c++) {
+            edge(static_cast<uint8_t>(*c - '0'), now);
+            now += stepUs;
+        }
+        return now;
+    }
+
+    // `count` detents up (positive) or down, one every `detentUs`.
+    uint32_t turn(int count, uint32_t startUs, uint32_t detentUs) {
+        const char *cycle = count > 0 ? "2310" : "1320";
+        uint32_t now = startUs;
+        for (int i = 0; i < (count > 0 ? count : -count); i++) {
+            replay(cycle, now, detentUs / 4);
+            now += detentUs;
+        }
+        return now;
+    }
+};
+
+void setUp() {}
+void tearDown() {}
+
+static void test_gray_code_cycle_is_one_detent() {
+    ReplayEncoder encoder;
+    encoder.replay("2310", 1000, 100);
+    TEST_ASSERT_EQUAL_INT32(1, encoder.detents);
+    encoder.replay("1320", 2000, 100);
+    TEST_ASSERT_EQUAL_INT32(0, encoder.detents);
+}
+
+static void test_contact_bounce_adds_nothing() {
+    ReplayEncoder encoder;
+    // B chatters on the first edge, then the cycle completes.
+    encoder.replay("20202310", 1000, 50);
+    TEST_ASSERT_EQUAL_INT32(1, encoder.detents);
+    // Half a detent forward and back again.
+    encoder.replay("2320", 3000, 50);
+    TEST_ASSERT_EQUAL_INT32(1, encoder.detents);
+    TEST_ASSERT_EQUAL_INT8(0, encoder.quarterSteps);
+}
+
+static void test_skipped_state_is_ignored() {
+    TEST_ASSERT_EQUAL_INT8(0, quadratureStep(0, 3));
+    TEST_ASSERT_EQUAL_INT8(0, quadratureStep(1, 2));
+    ReplayEncoder encoder;
+    // 0 -> 3 jumps both pins; only the valid edges count.
+    encoder.replay("3201", 1000, 100);
+    TEST_ASSERT_EQUAL_INT32(0, encoder.detents);
+    TEST_ASSERT_EQUAL_INT8(-3, encoder.quarterSteps);
+}
+
+static void test_steady_turn_converges_on_its_rate() {
+    ReplayEncoder encoder;
+    // 100 detents/s.
+    uint32_t end = encoder.turn(40, 1000, 10000);
+    uint32_t speed = speedAt(encoder.velocity.speedQ8,
+                             encoder.velocity.lastDetentUs, end) >> 8;
+    TEST_ASSERT_INT_WITHIN(2, 100, speed);
+}
+
+static void test_speed_decays_and_restarts() {
+    ReplayEncoder encoder;
+    uint32_t end = encoder.turn(10, 1000, 5000);
+    const VelocityFilter &velocity = encoder.velocity;
+    TEST_ASSERT_NOT_EQUAL(0, speedAt(velocity.speedQ8, velocity.lastDetentUs,
+                                     end));
+    TEST_ASSERT_EQUAL_UINT32(
+        0, speedAt(velocity.speedQ8, velocity.lastDetentUs,
+                   velocity.lastDetentUs + VELOCITY_TIMEOUT_US));
+
+    // Turning back starts from rest rather than from the old speed.
+    encoder.turn(-1, end, 5000);
+    TEST_ASSERT_EQUAL_UINT32(0, encoder.velocity.speedQ8);
+}
+
+static void test_bounce_caps_the_speed() {
+    ReplayEncoder encoder;
+    encoder.turn(20, 1000, 100);
+    TEST_ASSERT_EQUAL_UINT32(1000000 / MIN_DETENT_INTERVAL_US,
+                             encoder.velocity.speedQ8 >> 8);
+}
+
+static void test_slow_turn_is_one_to_one() {
+    AccelerationCurve curve{20, 64, 4};
+    ReplayEncoder encoder;
+    int32_t residue = 0;
+    int32_t value = 0;
+    uint32_t now = 1000;
+    for (int i = 0; i < 30; i++) {
+        int32_t before = encoder.detents;
+        now = encoder.turn(1, now, 100000);
+        value += curve.apply(encoder.detents - before,
+                             encoder.velocity.speedQ8, residue);
+    }
+    TEST_ASSERT_EQUAL_INT32(30, value);
+}
+
+static void test_fast_turn_accelerates_up_to_the_limit() {
+    AccelerationCurve curve{20, 64, 4};
+    // 24 detents/s: 1 + 4 * 0.25 = 2x.
+    TEST_ASSERT_EQUAL_UINT32(512, curve.multiplierQ8(24 << 8));
+    TEST_ASSERT_EQUAL_UINT32(4 << 8, curve.multiplierQ8(500 << 8));
+
+    ReplayEncoder encoder;
+    int32_t residue = 0;
+    int32_t value = 0;
+    uint32_t now = encoder.turn(10, 1000, 2000);
+    int32_t before = encoder.detents;
+    encoder.turn(10, now, 2000);
+    value = curve.apply(encoder.detents - before, encoder.velocity.speedQ8,
+                        residue);
+    TEST_ASSERT_EQUAL_INT32(40, value);
+}
+
+static void test_fractional_steps_carry_over() {
+    // 1.25x: four detents give five steps, none lost to rounding.
+    AccelerationCurve curve{20, 64, 4};
+    uint32_t speedQ8 = 21 << 8;
+    int32_t residue = 0;
+    int32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value += curve.apply(1, speedQ8, residue);
+    }
+    TEST_ASSERT_EQUAL_INT32(5, value);
+    TEST_ASSERT_EQUAL_INT32(0, residue);
+
+    // A turn back drops the carry instead of spending it.
+    curve.apply(1, speedQ8, residue);
+    TEST_ASSERT_EQUAL_INT32(-1, curve.apply(-1, speedQ8, residue));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_gray_code_cycle_is_one_detent);
+    RUN_TEST(test_contact_bounce_adds_nothing);
+    RUN_TEST(test_skipped_state_is_ignored);
+    RUN_TEST(test_steady_turn_converges_on_its_rate);
+    RUN_TEST(test_speed_decays_and_restarts);
+    RUN_TEST(test_bounce_caps_the_speed);
+    RUN_TEST(test_slow_turn_is_one_to_one);
+    RUN_TEST(test_fast_turn_accelerates_up_to_the_limit);
+    RUN_TEST(test_fractional_steps_carry_over);
+    return UNITY_END();
+}
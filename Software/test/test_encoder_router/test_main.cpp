@@ -0,0 +1,153 @@
+// Routes encoder values from one thread while another swaps the route, as
+// the input task and the state machine do, and checks that a handler never
+// runs once set() has moved its route away.
+
+#include <unity.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "utils/EncoderRouter.h"
+
+static EncoderRouter<std::mutex> *router;
+
+void setUp() { router = new EncoderRouter<std::mutex>(); }
+void tearDown() { delete router; }
+
+// Per route: whether the switching thread currently allows it to run, and
+// how often it ran when it should not have.
+struct Consumer {
+    std::atomic<bool> allowed{false};
+    std::atomic<uint32_t> calls{0};
+    std::atomic<uint32_t> stray{0};
+    std::atomic<bool> ready{true};
+    long lastValue = LONG_MIN;
+};
+
+static Consumer consumers[2];
+
+template <int Index>
+static bool handle(long value) {
+    Consumer &consumer = consumers[Index];
+    if (!consumer.allowed) {
+        consumer.stray++;
+    }
+    consumer.calls++;
+    if (!consumer.ready) {
+        return false;
+    }
+    consumer.lastValue = value;
+    return true;
+}
+
+static const EncoderRoute routes[2] = {
+    {"first", handle<0>, handle<0>},
+    {"second", nullptr, handle<1>},
+};
+
+static void resetConsumers() {
+    for (Consumer &consumer : consumers) {
+        consumer.allowed = false;
+        consumer.calls = 0;
+        consumer.stray = 0;
+        consumer.ready = true;
+        consumer.lastValue = LONG_MIN;
+    }
+}
+
+static void test_new_route_gets_current_values() {
+    resetConsumers();
+    consumers[0].allowed = true;
+    router->set(&routes[0]);
+    TEST_ASSERT_EQUAL_INT(2, router->offer(5, 7));
+    // Unchanged values are not offered again...
+    TEST_ASSERT_EQUAL_INT(0, router->offer(5, 7));
+    // ...until a route is set again.
+    router->set(&routes[0]);
+    TEST_ASSERT_EQUAL_INT(2, router->offer(5, 7));
+}
+
+static void test_declined_value_is_offered_again() {
+    resetConsumers();
+    consumers[1].allowed = true;
+    consumers[1].ready = false;
+    router->set(&routes[1]);
+    TEST_ASSERT_EQUAL_INT(0, router->offer(1, 3));
+    TEST_ASSERT_EQUAL_INT(0, router->offer(1, 3));
+    consumers[1].ready = true;
+    TEST_ASSERT_EQUAL_INT(1, router->offer(1, 3));
+    TEST_ASSERT_EQUAL_INT32(3, consumers[1].lastValue);
+    TEST_ASSERT_EQUAL_UINT32(3, consumers[1].calls.load());
+}
+
+static void test_cleared_route_gets_nothing() {
+    resetConsumers();
+    consumers[0].allowed = true;
+    router->set(&routes[0]);
+    router->offer(1, 1);
+    router->set(nullptr);
+    consumers[0].allowed = false;
+    TEST_ASSERT_EQUAL_INT(0, router->offer(2, 2));
+    TEST_ASSERT_EQUAL_UINT32(0, consumers[0].stray.load());
+}
+
+static void test_no_handler_runs_after_its_route_is_swapped() {
+    resetConsumers();
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> offers{0};
+
+    std::thread input([&]() {
+        long value = 0;
+        while (!done) {
+            // A new value every time so every offer reaches the handler.
+            router->offer(value, value);
+            value++;
+            offers++;
+        }
+    });
+
+    const int SWAPS = 20000;
+    for (int i = 0; i < SWAPS; i++) {
+        int next = i % 3;  // first, second, none
+        if (next < 2) {
+            consumers[next].allowed = true;
+            router->set(&routes[next]);
+        } else {
+            router->set(nullptr);
+        }
+        // Only once set() returned may the old route be done for good.
+        for (int index = 0; index < 2; index++) {
+            if (index != next) {
+                consumers[index].allowed = false;
+            }
+        }
+        if (i % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    router->set(nullptr);
+    consumers[0].allowed = false;
+    consumers[1].allowed = false;
+    done = true;
+    input.join();
+
+    char summary[96];
+    snprintf(summary, sizeof(summary), "%u offers, %u + %u handler calls",
+             (unsigned)offers.load(), (unsigned)consumers[0].calls.load(),
+             (unsigned)consumers[1].calls.load());
+    TEST_MESSAGE(summary);
+    TEST_ASSERT_GREATER_THAN(0, consumers[0].calls.load() +
+                                    consumers[1].calls.load());
+    TEST_ASSERT_EQUAL_UINT32(0, consumers[0].stray.load());
+    TEST_ASSERT_EQUAL_UINT32(0, consumers[1].stray.load());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_new_route_gets_current_values);
+    RUN_TEST(test_declined_value_is_offered_again);
+    RUN_TEST(test_cleared_route_gets_nothing);
+    RUN_TEST(test_no_handler_runs_after_its_route_is_swapped);
+    return UNITY_END();
+}
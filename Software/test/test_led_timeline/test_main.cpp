@@ -0,0 +1,118 @@
+// Dumps the LED timelines frame by frame, the way the LED task samples them,
+// and compares the dumps with golden tables.
+
+#include <stdio.h>
+#include <unity.h>
+
+#include <string>
+
+#include "constants/LedTimelines.h"
+
+using LedTimeline::evaluate;
+using LedTimeline::Timeline;
+
+void setUp() {}
+void tearDown() {}
+
+// One row per frame: elapsed ms, then the level of each LED.
+static std::string dump(const Timeline &timeline, uint16_t periodMs,
+                        uint32_t stepMs, uint32_t untilMs, uint8_t leds) {
+    std::string out;
+    char row[32];
+    for (uint32_t t = 0; t < untilMs; t += stepMs) {
+        snprintf(row, sizeof(row), "%4u", (unsigned)t);
+        out += row;
+        for (uint8_t led = 0; led < leds; led++) {
+            snprintf(row, sizeof(row), " %3u",
+                     (unsigned)evaluate(timeline, t, periodMs, led));
+            out += row;
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+static void test_pulse_frames() {
+    TEST_ASSERT_EQUAL_STRING(
+        "   0  40\n"
+        " 125 147\n"
+        " 250 255\n"
+        " 375 148\n"
+        " 500  40\n"
+        " 625  40\n"
+        " 750  40\n"
+        " 875  40\n",
+        dump(LedTimelines::pulse, LedTimelines::pulse.periodMs, 125, 1000, 1)
+            .c_str());
+}
+
+// Each LED peaks a third of a cycle (300 ms) after the one before it.
+static void test_chase_frames_lag_per_led() {
+    TEST_ASSERT_EQUAL_STRING(
+        "   0 255  30  30\n"
+        "  75 156  30  30\n"
+        " 150  56  54  30\n"
+        " 225  30 155  30\n"
+        " 300  30 255  30\n"
+        " 375  30 156  30\n"
+        " 450  30  55  55\n"
+        " 525  30  30 155\n"
+        " 600  30  30 255\n"
+        " 675  30  30 155\n"
+        " 750  54  30  55\n"
+        " 825 154  30  30\n",
+        dump(LedTimelines::chase, LedTimelines::chase.periodMs, 75, 900, 3)
+            .c_str());
+}
+
+static void test_chase_led_matches_previous_led_a_third_earlier() {
+    const Timeline &chase = LedTimelines::chase;
+    for (uint32_t t = 300; t < 3000; t += 7) {
+        TEST_ASSERT_INT_WITHIN(
+            1, evaluate(chase, t - 300, chase.periodMs, 0),
+            evaluate(chase, t, chase.periodMs, 1));
+        TEST_ASSERT_INT_WITHIN(
+            1, evaluate(chase, t - 300, chase.periodMs, 1),
+            evaluate(chase, t, chase.periodMs, 2));
+    }
+}
+
+// Paced timelines take the period from the caller.
+static void test_strobe_follows_the_pace() {
+    TEST_ASSERT_EQUAL_STRING(
+        "   0 255\n"
+        "  25  99\n"
+        "  50  20\n"
+        "  75  20\n"
+        " 100  20\n"
+        " 125  20\n"
+        " 150  20\n"
+        " 175  20\n"
+        " 200  20\n"
+        " 225  20\n"
+        " 250  20\n"
+        " 275  20\n",
+        dump(LedTimelines::strobe, 300, 25, 300, 1).c_str());
+    TEST_ASSERT_EQUAL_UINT8(0, evaluate(LedTimelines::strobe, 10, 0, 0));
+}
+
+static void test_breathe_is_periodic_and_bounded() {
+    const Timeline &breathe = LedTimelines::breathe;
+    for (uint32_t t = 0; t < breathe.periodMs; t += 13) {
+        uint8_t level = evaluate(breathe, t, breathe.periodMs, 0);
+        TEST_ASSERT_EQUAL_UINT8(
+            level, evaluate(breathe, t + breathe.periodMs, breathe.periodMs, 0));
+        TEST_ASSERT_GREATER_OR_EQUAL(20, level);
+    }
+    TEST_ASSERT_EQUAL_UINT8(255, evaluate(breathe, 2000, breathe.periodMs, 0));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_pulse_frames);
+    RUN_TEST(test_chase_frames_lag_per_led);
+    RUN_TEST(test_chase_led_matches_previous_led_a_third_earlier);
+    RUN_TEST(test_strobe_follows_the_pace);
+    RUN_TEST(test_breathe_is_periodic_and_bounded);
+    return UNITY_END();
+}
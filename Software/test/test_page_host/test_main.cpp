@@ -0,0 +1,214 @@
+// Flips pages through the real page host, with its mailbox, frame lock and
+// task running on the FreeRTOS fakes, and reports how long each switch took
+// to reach the new page's enter.
+//
+// Heap fragmentation can't be measured here: the host heap is glibc's, not
+// the ESP32's, and the fake reports whatever figures a test sets. The last
+// test sets some to check the page host records them; the real figures come
+// from its log line on the device.
+
+#include <stdio.h>
+#include <unity.h>
+
+#include <atomic>
+#include <thread>
+
+#include "pages/pageHost.cpp"
+
+static const uint32_t FLIPS = 1000;
+
+// Long enough that a flip is picked up by the mailbox, not a frame timeout.
+TickType_t powerPeriod(PowerLoop) { return pdMS_TO_TICKS(20); }
+void auditStack(TaskHandle_t, const char *, uint32_t) {}
+
+struct PageCounts {
+    std::atomic<uint32_t> enters{0};
+    std::atomic<uint32_t> exits{0};
+};
+
+static PageCounts counts[2];
+static std::atomic<int> lastEntered{-1};
+// Set while a hook runs, to catch two running at once.
+static std::atomic<bool> inHook{false};
+static std::atomic<uint32_t> overlaps{0};
+
+static void beginHook() {
+    if (inHook.exchange(true)) {
+        overlaps++;
+    }
+}
+
+// How long each hook takes. Zero for the timings; the overlap test makes
+// them take a while and let other threads run meanwhile, as drawing does
+// while it waits on the SPI bus, so an overlap has room to show.
+static std::atomic<int64_t> hookUs{0};
+
+static void endHook() {
+    int64_t until = esp_timer_get_time() + hookUs;
+    while (esp_timer_get_time() < until) {
+        std::this_thread::yield();
+    }
+    inHook = false;
+}
+
+template <int Index>
+static void enterPage(void *) {
+    beginHook();
+    counts[Index].enters++;
+    lastEntered = Index;
+    endHook();
+}
+
+static bool tickPage(void *) {
+    beginHook();
+    endHook();
+    return true;
+}
+
+template <int Index>
+static void exitPage(void *) {
+    beginHook();
+    counts[Index].exits++;
+    endHook();
+}
+
+static const PageController pages[2] = {
+    {"a", enterPage<0>, tickPage, exitPage<0>},
+    {"b", enterPage<1>, tickPage, exitPage<1>},
+};
+
+static uint32_t totalEnters() { return counts[0].enters + counts[1].enters; }
+static uint32_t totalExits() { return counts[0].exits + counts[1].exits; }
+
+// Waits for the page host to have entered `enters` pages in all.
+static bool waitForEnters(uint32_t enters) {
+    for (int spins = 0; totalEnters() < enters; spins++) {
+        if (spins > 1000000) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Each flip waits for the previous one, so none are merged.
+void test_flips_each_reach_enter() {
+    PageHostStats before = getPageHostStats();
+    uint32_t startEnters = totalEnters();
+
+    for (uint32_t flip = 0; flip < FLIPS; flip++) {
+        showPage(pages[flip % 2]);
+        TEST_ASSERT_TRUE(waitForEnters(startEnters + flip + 1));
+    }
+
+    PageHostStats after = getPageHostStats();
+    uint32_t transitions = after.transitions - before.transitions;
+    TEST_ASSERT_EQUAL_UINT32(FLIPS, transitions);
+    TEST_ASSERT_EQUAL_UINT32(FLIPS, totalEnters() - startEnters);
+    // Every page but the one showing was left.
+    TEST_ASSERT_EQUAL_UINT32(totalEnters() - 1, totalExits());
+    TEST_ASSERT_EQUAL_UINT32(0, overlaps.load());
+
+    char line[160];
+    snprintf(line, sizeof(line),
+             "%lu flips: %lu us avg, %lu us max from showPage to enter; "
+             "fragmentation not measured on the host",
+             (unsigned long)transitions,
+             (unsigned long)((after.totalTransitionUs -
+                              before.totalTransitionUs) /
+                             transitions),
+             (unsigned long)after.maxTransitionUs);
+    TEST_MESSAGE(line);
+}
+
+// Requests faster than the host can show them are merged, and the last one
+// is the page left showing.
+void test_burst_shows_the_last_page() {
+    uint32_t startEnters[2] = {counts[0].enters, counts[1].enters};
+    for (uint32_t flip = 0; flip < FLIPS; flip++) {
+        showPage(pages[flip % 2]);
+    }
+    // FLIPS is even, so the last request was page b.
+    for (int spins = 0; counts[1].enters == startEnters[1]; spins++) {
+        TEST_ASSERT_LESS_THAN(1000000, spins);
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    uint32_t entered = (counts[0].enters - startEnters[0]) +
+                       (counts[1].enters - startEnters[1]);
+    TEST_ASSERT_LESS_OR_EQUAL(FLIPS, entered);
+    TEST_ASSERT_EQUAL_INT(1, lastEntered.load());
+    TEST_ASSERT_EQUAL_UINT32(totalEnters() - 1, totalExits());
+    TEST_ASSERT_EQUAL_UINT32(0, overlaps.load());
+
+    char line[96];
+    snprintf(line, sizeof(line), "%lu requests in a burst, %lu pages shown",
+             (unsigned long)FLIPS, (unsigned long)entered);
+    TEST_MESSAGE(line);
+}
+
+static std::atomic<uint32_t> jobsRun{0};
+
+static void betweenFramesJob(void *) {
+    if (inHook) {
+        overlaps++;
+    }
+    jobsRun++;
+}
+
+// Jobs from another task never overlap a hook, even while pages switch.
+void test_jobs_run_between_frames() {
+    jobsRun = 0;
+    hookUs = 20;
+    std::atomic<bool> stop{false};
+    std::thread jobs([&stop] {
+        while (!stop) {
+            runBetweenFrames(betweenFramesJob, nullptr);
+        }
+    });
+
+    uint32_t startEnters = totalEnters();
+    for (uint32_t flip = 0; flip < FLIPS; flip++) {
+        showPage(pages[flip % 2]);
+        TEST_ASSERT_TRUE(waitForEnters(startEnters + flip + 1));
+    }
+    stop = true;
+    jobs.join();
+    hookUs = 0;
+
+    TEST_ASSERT_GREATER_THAN(0, jobsRun.load());
+    TEST_ASSERT_EQUAL_UINT32(0, overlaps.load());
+}
+
+// Each transition samples the heap, keeping the latest and the worst.
+void test_transitions_record_fragmentation() {
+    fake_heap_caps::freeBytes() = 200 * 1024;
+    fake_heap_caps::largestFreeBlock() = 50 * 1024;
+    uint32_t startEnters = totalEnters();
+    showPage(pages[0]);
+    TEST_ASSERT_TRUE(waitForEnters(startEnters + 1));
+
+    fake_heap_caps::largestFreeBlock() = 150 * 1024;
+    showPage(pages[1]);
+    TEST_ASSERT_TRUE(waitForEnters(startEnters + 2));
+
+    PageHostStats stats = getPageHostStats();
+    TEST_ASSERT_EQUAL_UINT8(25, stats.fragmentation);
+    TEST_ASSERT_EQUAL_UINT8(75, stats.maxFragmentation);
+
+    fake_heap_caps::largestFreeBlock() = fake_heap_caps::freeBytes();
+}
+
+int main() {
+    initPageHost();
+    UNITY_BEGIN();
+    RUN_TEST(test_flips_each_reach_enter);
+    RUN_TEST(test_burst_shows_the_last_page);
+    RUN_TEST(test_jobs_run_between_frames);
+    RUN_TEST(test_transitions_record_fragmentation);
+    return UNITY_END();
+}
@@ -0,0 +1,300 @@
+// Runs the session arena through a long session of pages rebuilding their
+// widgets and JSON documents coming and going, and reports how much of it
+// is left in one piece. The heap behind it is the host's.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include <vector>
+
+#include "services/sessionArena.cpp"
+
+static const uint32_t SOAK_CYCLES = 10000;
+
+void *placedMalloc(HeapUser, size_t size) { return malloc(size); }
+void *placedRealloc(HeapUser, void *ptr, size_t size) {
+    return realloc(ptr, size);
+}
+void placedFree(HeapUser, void *ptr) { free(ptr); }
+
+static uint32_t seed = 1;
+
+static uint32_t randomBelow(uint32_t bound) {
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 8) % bound;
+}
+
+static uint32_t randomBetween(uint32_t low, uint32_t high) {
+    return low + randomBelow(high - low + 1);
+}
+
+// A live block, filled with its own tag so an overlap shows.
+struct Live {
+    uint8_t *data = nullptr;
+    size_t size = 0;
+    uint8_t tag = 0;
+};
+
+static uint8_t nextTag = 1;
+
+static void fill(Live &block) {
+    block.tag = nextTag++;
+    memset(block.data, block.tag, block.size);
+}
+
+static bool intact(const Live &block) {
+    for (size_t i = 0; i < block.size; i++) {
+        if (block.data[i] != block.tag) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Live allocate(size_t size) {
+    Live block;
+    block.data = static_cast<uint8_t *>(sessionAlloc(size));
+    block.size = size;
+    fill(block);
+    return block;
+}
+
+static bool release(Live &block) {
+    bool ok = block.data == nullptr || intact(block);
+    sessionFree(block.data);
+    block = Live();
+    return ok;
+}
+
+static Live allocateJson(size_t size) {
+    Live block;
+    block.data = static_cast<uint8_t *>(sessionJsonAllocator()->allocate(size));
+    block.size = size;
+    fill(block);
+    return block;
+}
+
+static bool growJson(Live &block, size_t size) {
+    bool ok = intact(block);
+    block.data = static_cast<uint8_t *>(
+        sessionJsonAllocator()->reallocate(block.data, size));
+    block.size = size;
+    fill(block);
+    return ok;
+}
+
+static bool releaseJson(Live &block) {
+    bool ok = intact(block);
+    sessionJsonAllocator()->deallocate(block.data);
+    block = Live();
+    return ok;
+}
+
+// Walks the region: every block's previousBytes matches the block before,
+// no two free blocks touch, none borders the tail, and every free block is
+// on a list.
+static bool blocksConsistent() {
+    size_t freeBlocks = 0;
+    size_t previousBytes = 0;
+    bool previousFree = false;
+    for (uint8_t *cursor = region; cursor < region + offset;) {
+        auto *header = reinterpret_cast<BlockHeader *>(cursor);
+        if (header->blockBytes == 0 || header->blockBytes % GRANULE != 0 ||
+            header->previousBytes != previousBytes ||
+            (header->isFree && previousFree)) {
+            return false;
+        }
+        freeBlocks += header->isFree ? 1 : 0;
+        previousBytes = header->blockBytes;
+        previousFree = header->isFree;
+        cursor += header->blockBytes;
+    }
+    if (previousFree || previousBytes != lastBlockBytes) {
+        return false;
+    }
+    size_t listed = 0;
+    for (FreeBlock *list : freeLists) {
+        for (FreeBlock *block = list; block != nullptr; block = block->next) {
+            listed++;
+        }
+    }
+    for (FreeBlock *block = largeBlocks; block != nullptr;
+         block = block->next) {
+        listed++;
+    }
+    return listed == freeBlocks;
+}
+
+void setUp() { TEST_ASSERT_EQUAL_UINT32(0, getSessionArenaStats().liveBlocks); }
+void tearDown() {}
+
+// Freed small blocks keep their size, so they go back to their own list.
+void test_recycled_block_keeps_its_size() {
+    Live first = allocate(100);
+    Live guard = allocate(16);
+    uint8_t *address = first.data;
+    TEST_ASSERT_TRUE(release(first));
+    for (int round = 0; round < 3; round++) {
+        Live again = allocate(100);
+        TEST_ASSERT_EQUAL_PTR(address, again.data);
+        TEST_ASSERT_TRUE(release(again));
+    }
+    TEST_ASSERT_TRUE(release(guard));
+}
+
+// A freed large block serves the next large request, and what is left of it
+// goes on the list for its size.
+void test_large_block_is_split_for_reuse() {
+    Live pool = allocate(3000);  // a 3008 byte block
+    Live guard = allocate(16);
+    uint8_t *address = pool.data;
+    TEST_ASSERT_TRUE(release(pool));
+
+    Live smaller = allocate(2100);  // 2112
+    TEST_ASSERT_EQUAL_PTR(address, smaller.data);
+    Live rest = allocate(880);  // the 896 left over
+    TEST_ASSERT_EQUAL_PTR(address + 2112, rest.data);
+    TEST_ASSERT_EQUAL_UINT32(0, getSessionArenaStats().overflowBlocks);
+
+    TEST_ASSERT_TRUE(release(smaller));
+    TEST_ASSERT_TRUE(release(rest));
+    TEST_ASSERT_TRUE(release(guard));
+}
+
+// A JSON string growing at the end of the region stays where it is.
+void test_json_grows_in_place_at_the_end() {
+    Live text = allocateJson(32);
+    uint8_t *address = text.data;
+    for (size_t size = 64; size <= 4096; size *= 2) {
+        TEST_ASSERT_TRUE(growJson(text, size));
+        TEST_ASSERT_EQUAL_PTR(address, text.data);
+    }
+    TEST_ASSERT_TRUE(releaseJson(text));
+}
+
+void test_session_end_rewinds() {
+    uint32_t rewinds = getSessionArenaStats().rewinds;
+    Live device = allocate(400);
+    Live pool = allocateJson(2100);
+    TEST_ASSERT_TRUE(release(device));
+    TEST_ASSERT_TRUE(releaseJson(pool));
+
+    SessionArenaStats stats = getSessionArenaStats();
+    TEST_ASSERT_EQUAL_UINT32(rewinds + 1, stats.rewinds);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.usedBytes);
+    TEST_ASSERT_EQUAL_UINT32(SESSION_ARENA_BYTES - sizeof(BlockHeader),
+                             stats.largestFreeBytes);
+}
+
+// Widget sizes for the pages a session goes through: controls, device
+// menu, settings. A page rebuilds the same widgets each time it is shown.
+static const std::vector<std::vector<size_t>> PAGE_LAYOUTS = {
+    {96, 96, 96, 96, 96, 160, 160, 48, 48, 320, 200},
+    {120, 64, 64, 64, 64, 64, 64, 64, 64},
+    {120, 88, 88, 88, 88, 48},
+};
+
+// One long session: every cycle a page rebuilds its widgets, a protocol
+// document is read with its pool and growing strings, and one of the
+// blocks that live across pages (settings documents, characteristic
+// entries) is replaced with one of another size.
+void test_soak_one_session() {
+    seed = 1;
+    Live device = allocate(400);
+    std::vector<Live> lasting(6);
+    for (Live &block : lasting) {
+        block = allocate(randomBetween(16, 2600));
+    }
+
+    uint32_t smallestLargest = UINT32_MAX;
+    bool ok = true;
+    for (uint32_t cycle = 0; cycle < SOAK_CYCLES && ok; cycle++) {
+        const std::vector<size_t> &layout =
+            PAGE_LAYOUTS[randomBelow(PAGE_LAYOUTS.size())];
+        std::vector<Live> widgets(layout.size());
+        for (size_t i = 0; i < layout.size(); i++) {
+            widgets[i] = allocate(layout[i]);
+        }
+
+        Live pool = allocateJson(2048 + 16 * randomBelow(33));
+        Live text = allocateJson(32);
+        size_t textBytes = randomBetween(64, 600);
+        for (size_t size = 64; size < textBytes; size *= 2) {
+            ok &= growJson(text, size);
+        }
+        ok &= growJson(text, textBytes);
+
+        Live &replaced = lasting[randomBelow(lasting.size())];
+        ok &= release(replaced);
+        replaced = allocate(randomBetween(16, 2600));
+
+        ok &= releaseJson(text);
+        ok &= releaseJson(pool);
+        for (Live &widget : widgets) {
+            ok &= release(widget);
+        }
+
+        ok &= blocksConsistent();
+        SessionArenaStats stats = getSessionArenaStats();
+        if (stats.overflowBlocks != 0) {
+            char line[96];
+            snprintf(line, sizeof(line), "Overflowed in cycle %lu",
+                     (unsigned long)cycle);
+            TEST_FAIL_MESSAGE(line);
+        }
+        smallestLargest = min(smallestLargest, stats.largestFreeBytes);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(ok, "A block was overwritten or mislinked");
+
+    SessionArenaStats stats = getSessionArenaStats();
+    char line[160];
+    snprintf(line, sizeof(line),
+             "%lu cycles: largest free block %lu bytes (smallest %lu), "
+             "%lu of %lu bytes used, peak %lu, %lu reused",
+             (unsigned long)SOAK_CYCLES,
+             (unsigned long)stats.largestFreeBytes,
+             (unsigned long)smallestLargest, (unsigned long)stats.usedBytes,
+             (unsigned long)stats.capacity, (unsigned long)stats.peakBytes,
+             (unsigned long)stats.recycled);
+    TEST_MESSAGE(line);
+    // A new 2 KiB document pool fits at the end of every cycle.
+    TEST_ASSERT_GREATER_OR_EQUAL(2048, smallestLargest);
+
+    for (Live &block : lasting) {
+        TEST_ASSERT_TRUE(release(block));
+    }
+    TEST_ASSERT_TRUE(release(device));
+    TEST_ASSERT_EQUAL_UINT32(0, getSessionArenaStats().usedBytes);
+}
+
+// Freeing the blocks around a hole joins all three into one.
+void test_neighbours_are_joined() {
+    Live left = allocate(200);
+    Live middle = allocate(200);
+    Live right = allocate(200);
+    Live guard = allocate(16);
+    uint8_t *address = left.data;
+    TEST_ASSERT_TRUE(release(left));
+    TEST_ASSERT_TRUE(release(right));
+    TEST_ASSERT_TRUE(release(middle));
+    TEST_ASSERT_TRUE(blocksConsistent());
+
+    // 3 blocks of 208 bytes, less one header.
+    Live joined = allocate(3 * 208 - sizeof(BlockHeader));
+    TEST_ASSERT_EQUAL_PTR(address, joined.data);
+    TEST_ASSERT_TRUE(release(joined));
+    TEST_ASSERT_TRUE(release(guard));
+}
+
+int main() {
+    initSessionArena();
+    UNITY_BEGIN();
+    RUN_TEST(test_recycled_block_keeps_its_size);
+    RUN_TEST(test_large_block_is_split_for_reuse);
+    RUN_TEST(test_json_grows_in_place_at_the_end);
+    RUN_TEST(test_session_end_rewinds);
+    RUN_TEST(test_neighbours_are_joined);
+    RUN_TEST(test_soak_one_session);
+    return UNITY_END();
+}
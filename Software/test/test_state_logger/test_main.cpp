@@ -0,0 +1,186 @@
+// Checks the compile-time type names on the host compiler, then drives a
+// small SML machine through StateLogger: what it records, that it allocates
+// nothing, and how long process_event(right_button_pressed{}) takes.
+
+// Every hook logs, so the hot log path is part of what is checked.
+#define HOTLOG_LEVEL_STATE_MACHINE ESP_LOG_VERBOSE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <utility>
+
+#include "state/events.hpp"
+#include "utils/StateLogger.h"
+
+// Counts every allocation made through operator new.
+static std::atomic<uint32_t> allocations{0};
+
+void *operator new(size_t size) {
+    allocations++;
+    void *ptr = malloc(size ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+static uint32_t hotLogs = 0;
+void submitHotLog(const HotLogRecord &) { hotLogs++; }
+
+// The ring lives in RTC memory on the device (state/remote.cpp); here it is
+// a plain array.
+static const size_t RECORDS = 16;
+static TransitionRecord records[RECORDS];
+static size_t recordCount = 0;
+
+void StateLogger::record(TransitionKind kind, uint32_t id, const char *name,
+                         const char *source, bool passed) {
+    records[recordCount % RECORDS] = {static_cast<uint32_t>(millis()), id,
+                                      name, source, kind, passed};
+    recordCount++;
+}
+
+namespace sample {
+struct Widget {};
+}  // namespace sample
+
+static bool allowMenu = true;
+
+struct testMachine {
+    auto operator()() const {
+        auto canOpen = [](const right_button_pressed &) { return allowMenu; };
+        auto onOpen = [] {};
+        return make_transition_table(
+            *"idle"_s + event<right_button_pressed>[canOpen] / onOpen =
+                "menu"_s,
+            "menu"_s + event<right_button_pressed> = "idle"_s);
+    }
+};
+
+using Machine = sml::sm<testMachine, sml::logger<StateLogger>>;
+
+// How SML hands a state named with _s to the logger.
+using IdleState = sml::aux::string<char, 'i', 'd', 'l', 'e'>;
+
+// The names are constant expressions, so they can be checked at compile
+// time too.
+static_assert(TypeInfo<right_button_pressed>::name == "right_button_pressed");
+static_assert(TypeInfo<sample::Widget>::name == "sample::Widget");
+static_assert(SmlName<IdleState>::name == "idle");
+
+void setUp() {
+    recordCount = 0;
+    hotLogs = 0;
+    allowMenu = true;
+}
+void tearDown() {}
+
+void test_type_names() {
+    TEST_ASSERT_EQUAL_STRING("int", TypeInfo<int>::name.data());
+    TEST_ASSERT_EQUAL_STRING("right_button_pressed",
+                             TypeInfo<right_button_pressed>::name.data());
+    TEST_ASSERT_EQUAL_STRING("sample::Widget",
+                             TypeInfo<sample::Widget>::name.data());
+    TEST_ASSERT_EQUAL_STRING("std::pair<int, char>",
+                             (TypeInfo<std::pair<int, char>>::name.data()));
+}
+
+void test_type_ids_hash_the_name() {
+    TEST_ASSERT_EQUAL_UINT32(type_name::fnv1a("right_button_pressed"),
+                             TypeInfo<right_button_pressed>::id);
+    TEST_ASSERT_TRUE(TypeInfo<int>::id != TypeInfo<unsigned>::id);
+}
+
+void test_sml_state_names() {
+    TEST_ASSERT_EQUAL_STRING("idle", SmlName<IdleState>::name.data());
+    TEST_ASSERT_EQUAL_UINT32(type_name::fnv1a("idle"), SmlName<IdleState>::id);
+    TEST_ASSERT_EQUAL_STRING(
+        "right_button_pressed",
+        SmlName<right_button_pressed>::name.data());
+}
+
+void test_records_event_guard_and_state_change() {
+    StateLogger logger;
+    Machine machine{logger};
+    recordCount = 0;
+
+    machine.process_event(right_button_pressed{});
+
+    TEST_ASSERT_TRUE(machine.is("menu"_s));
+    TEST_ASSERT_EQUAL_UINT32(3, recordCount);
+    TEST_ASSERT_EQUAL(TransitionKind::Event, records[0].kind);
+    TEST_ASSERT_EQUAL_STRING("right_button_pressed", records[0].name);
+    TEST_ASSERT_EQUAL(TransitionKind::Guard, records[1].kind);
+    TEST_ASSERT_TRUE(records[1].passed);
+    TEST_ASSERT_EQUAL(TransitionKind::StateChange, records[2].kind);
+    TEST_ASSERT_EQUAL_STRING("idle", records[2].source);
+    TEST_ASSERT_EQUAL_STRING("menu", records[2].name);
+    TEST_ASSERT_EQUAL_UINT32(type_name::fnv1a("menu"), records[2].id);
+}
+
+void test_failed_guard_is_recorded() {
+    StateLogger logger;
+    Machine machine{logger};
+    allowMenu = false;
+    recordCount = 0;
+
+    machine.process_event(right_button_pressed{});
+
+    TEST_ASSERT_TRUE(machine.is("idle"_s));
+    TEST_ASSERT_EQUAL_UINT32(2, recordCount);
+    TEST_ASSERT_EQUAL(TransitionKind::Guard, records[1].kind);
+    TEST_ASSERT_FALSE(records[1].passed);
+}
+
+void test_logging_allocates_nothing() {
+    StateLogger logger;
+    Machine machine{logger};
+    uint32_t before = allocations;
+
+    for (int i = 0; i < 100; i++) {
+        machine.process_event(right_button_pressed{});
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, allocations - before);
+    TEST_ASSERT_GREATER_THAN(0, hotLogs);
+}
+
+void test_process_event_time() {
+    static const int EVENTS = 200000;
+    StateLogger logger;
+    Machine machine{logger};
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < EVENTS; i++) {
+        machine.process_event(right_button_pressed{});
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    long long ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+    char line[128];
+    snprintf(line, sizeof(line),
+             "process_event(right_button_pressed{}): %lld ns avg over %d "
+             "events, with logging (host)",
+             ns / EVENTS, EVENTS);
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_type_names);
+    RUN_TEST(test_type_ids_hash_the_name);
+    RUN_TEST(test_sml_state_names);
+    RUN_TEST(test_records_event_guard_and_state_change);
+    RUN_TEST(test_failed_guard_is_recorded);
+    RUN_TEST(test_logging_allocates_nothing);
+    RUN_TEST(test_process_event_time);
+    return UNITY_END();
+}